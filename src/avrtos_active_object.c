@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+
+#include "avrtos_active_object.h"
+#include "avrtos_core.h"
+#include "critical_section_arch_ind.h"
+
+struct avrtos_ao *g_ao_head = NULL;
+
+struct avrtos_task _ao_worker_tasks[AVRTOS_AO_WORKERS_COUNT];
+AVRTOS_STACK_DEFINE(_ao_worker_stacks[AVRTOS_AO_WORKERS_COUNT],
+                    AVRTOS_AO_WORKER_STACK_SIZE);
+
+static struct avrtos_ao *ao_take_next_event(char *out_event) {
+    struct avrtos_ao *ret = NULL;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_AO_TAKE) {
+        /* the list is ordered by priority, the first idle object with a
+           pending event wins */
+        for (struct avrtos_ao *iterator = g_ao_head; iterator;
+             iterator = iterator->next) {
+            if (!iterator->busy
+                && circ_buff_get_one(&iterator->queue, out_event)
+                           == CIRC_BUFF_OK) {
+                iterator->busy = true;
+                ret = iterator;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+static void _ao_worker_thread(void *arg) {
+    (void) arg;
+    while (1) {
+        char event;
+        struct avrtos_ao *ao = ao_take_next_event(&event);
+        if (ao) {
+            ao->dispatch(ao, event);
+            ao->busy = false;
+        } else {
+            avrtos_task_yield();
+        }
+    }
+}
+
+int avrtos_ao_create(struct avrtos_ao *ao,
+                     char *queue_buffer,
+                     size_t queue_size,
+                     void (*dispatch)(struct avrtos_ao *, char),
+                     uint8_t priority) {
+    if (!(ao && dispatch)) {
+        return 1;
+    }
+
+    if (circ_buff_initialize(&ao->queue, queue_buffer, queue_size)
+        != CIRC_BUFF_OK) {
+        return 1;
+    }
+
+    ao->dispatch = dispatch;
+    ao->priority = priority;
+    ao->busy = false;
+
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_AO_CREATE) {
+        /* keep the list ordered by priority, objects with equal priority are
+           kept in creation order */
+        struct avrtos_ao **iterator = &g_ao_head;
+        while (*iterator && (*iterator)->priority >= priority) {
+            iterator = &(*iterator)->next;
+        }
+        ao->next = *iterator;
+        *iterator = ao;
+    }
+
+    return 0;
+}
+
+enum circular_buffer_status avrtos_ao_post(struct avrtos_ao *ao, char event) {
+    if (!ao) {
+        return CIRC_BUFF_INVALID;
+    }
+
+    enum circular_buffer_status ret;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_AO_POST) {
+        ret = circ_buff_insert_one(&ao->queue, event);
+    }
+
+    return ret;
+}
+
+void _avrtos_ao_workers_init(void) {
+    if (!g_ao_head) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < AVRTOS_AO_WORKERS_COUNT; i++) {
+        (void) avrtos_task_create(&_ao_worker_tasks[i], _ao_worker_thread,
+                                  _ao_worker_stacks[i],
+                                  sizeof(_ao_worker_stacks[i]), NULL);
+    }
+}
+
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
@@ -0,0 +1,106 @@
+#ifndef AVRTOS_ACTIVE_OBJECT_H_
+#define AVRTOS_ACTIVE_OBJECT_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+#include "circular_buffer_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+
+/**
+ * Active object. Events posted to the object are stored in its queue and are
+ * dispatched one by one, run to completion, by one of the worker tasks. A
+ * single active object is never dispatched by two workers at the same time.
+ */
+struct avrtos_ao {
+    struct circular_buffer queue;
+    void (*dispatch)(struct avrtos_ao *, char);
+    uint8_t priority;
+    volatile bool busy;
+    struct avrtos_ao *next;
+};
+
+/**
+ * Simple active object declaration together with its event queue buffer.
+ * Does not initialize the struct.
+ *
+ * @param AoName    Name of the active object that will be used as its
+ *                  identifier.
+ *
+ * @param QueueSize Maximum number of pending events.
+ */
+#define AVRTOS_AO_DEFINE(AoName, QueueSize)               \
+    char AVRTOS_CONCAT(AoName, _queue_buffer)[QueueSize]; \
+    struct avrtos_ao AoName
+
+/**
+ * Creates an active object created with @ref AVRTOS_AO_DEFINE.
+ */
+#define AVRTOS_AO_CREATE(AoName, Dispatch, Priority)                    \
+    avrtos_ao_create(&AoName, AVRTOS_CONCAT(AoName, _queue_buffer),     \
+                     sizeof(AVRTOS_CONCAT(AoName, _queue_buffer)),      \
+                     Dispatch, Priority)
+
+/**
+ * Creates an active object and adds it to the global active object list,
+ * which is ordered by priority. The worker tasks are created by
+ * avrtos_scheduler_start() if at least one active object exists. Should be
+ * called before avrtos_scheduler_start().
+ *
+ * @param ao           Pointer to the static @ref struct avrtos_ao structure.
+ *
+ * @param queue_buffer Pointer to the event queue buffer.
+ *
+ * @param queue_size   Size of @p queue_buffer.
+ *
+ * @param dispatch     Function handling a single event of the active object.
+ *
+ * @param priority     Priority of the active object. When more than one
+ *                     object has pending events, the one with the higher
+ *                     priority value is dispatched first.
+ *
+ * @returns non-zero value if any of the pointers is NULL or @p queue_size is
+ *          equal to zero,
+ *          0 otherwise.
+ */
+int avrtos_ao_create(struct avrtos_ao *ao,
+                     char *queue_buffer,
+                     size_t queue_size,
+                     void (*dispatch)(struct avrtos_ao *, char),
+                     uint8_t priority);
+
+/**
+ * Posts an event to the active object. Does not wait, can be called from an
+ * ISR.
+ *
+ * @param ao    Pointer to the active object.
+ *
+ * @param event Event to post.
+ *
+ * @returns CIRC_BUFF_INVALID if @p ao is NULL,
+ *          CIRC_BUFF_FULL if the event queue is full,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status avrtos_ao_post(struct avrtos_ao *ao, char event);
+
+/**
+ * Creates the worker tasks if any active object has been created. Should be a
+ * "private" function.
+ */
+void _avrtos_ao_workers_init(void);
+
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_ACTIVE_OBJECT_H_ */
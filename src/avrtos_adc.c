@@ -0,0 +1,139 @@
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_ADC
+
+#include "avrtos_adc.h"
+#include "avrtos_completion.h"
+#include "avrtos_core.h"
+#include "avrtos_utils.h"
+#include "critical_section_arch_ind.h"
+
+AVRTOS_STATIC_ASSERT(AVRTOS_ADC_BLOCK_SIZE > 0 && AVRTOS_ADC_BLOCK_SIZE <= 255,
+                     AdcBlockSizeIsNotValid);
+
+/**
+ * States of the half of the buffer that is not being filled.
+ */
+enum adc_half_state { ADC_HALF_FREE, ADC_HALF_FULL, ADC_HALF_TAKEN };
+
+static uint16_t g_adc_buffers[2][AVRTOS_ADC_BLOCK_SIZE];
+static uint8_t g_adc_channels[AVRTOS_ADC_MAX_CHANNELS];
+static uint8_t g_adc_channels_count;
+
+/* only touched by ADC_vect while the conversions run. Channels are indexes
+   into g_adc_channels: the one of the next stored sample, the one selected in
+   the multiplexer and the one of the conversion in progress */
+static uint8_t g_adc_index;
+static uint8_t g_adc_expected;
+static uint8_t g_adc_selected;
+static uint8_t g_adc_converting;
+
+/* the half filled by ADC_vect, which swaps the halves only when the other one
+   is free. The task frees the other half, ADC_vect fills it */
+static volatile uint8_t g_adc_filling;
+static volatile uint8_t g_adc_other_state;
+static volatile uint16_t g_adc_overruns;
+static struct avrtos_completion g_adc_block_ready;
+
+static uint8_t adc_next_channel(uint8_t channel) {
+    return ++channel == g_adc_channels_count ? 0 : channel;
+}
+
+static void adc_store(uint16_t value) {
+    g_adc_buffers[g_adc_filling][g_adc_index++] = value;
+    g_adc_expected = adc_next_channel(g_adc_expected);
+    if (g_adc_index < AVRTOS_ADC_BLOCK_SIZE) {
+        return;
+    }
+
+    g_adc_index = 0;
+    if (g_adc_other_state == ADC_HALF_FREE) {
+        g_adc_other_state = ADC_HALF_FULL;
+        g_adc_filling ^= 1;
+        avrtos_completion_complete(&g_adc_block_ready);
+    } else if (g_adc_overruns < UINT16_MAX) {
+        /* the block is overwritten */
+        g_adc_overruns++;
+    }
+}
+
+bool avrtos_adc_start(const uint8_t *channels,
+                      uint8_t channels_count,
+                      uint32_t rate_hz) {
+    if (!channels || channels_count == 0
+        || channels_count > AVRTOS_ADC_MAX_CHANNELS
+        || AVRTOS_ADC_BLOCK_SIZE % channels_count != 0
+        || (rate_hz == 0 && channels_count > 1)) {
+        return false;
+    }
+
+    avrtos_adc_stop();
+    for (uint8_t i = 0; i < channels_count; i++) {
+        g_adc_channels[i] = channels[i];
+    }
+    g_adc_channels_count = channels_count;
+    g_adc_index = 0;
+    g_adc_expected = 0;
+    g_adc_selected = 0;
+    g_adc_converting = 0;
+    g_adc_filling = 0;
+    g_adc_other_state = ADC_HALF_FREE;
+    g_adc_overruns = 0;
+    avrtos_completion_reset(&g_adc_block_ready);
+
+    return avrtos_adc_start_impl(channels[0], rate_hz * channels_count);
+}
+
+void avrtos_adc_stop(void) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_ADC) {
+        avrtos_adc_stop_impl();
+    }
+}
+
+const uint16_t *avrtos_adc_next_block(uint64_t timeout_us) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_ADC) {
+        if (g_adc_other_state == ADC_HALF_TAKEN) {
+            g_adc_other_state = ADC_HALF_FREE;
+        }
+    }
+
+    if (!avrtos_completion_wait(&g_adc_block_ready, timeout_us)) {
+        return NULL;
+    }
+    /* ADC_vect neither completes again nor swaps the halves until the block
+       is released */
+    avrtos_completion_reset(&g_adc_block_ready);
+    g_adc_other_state = ADC_HALF_TAKEN;
+    return g_adc_buffers[g_adc_filling ^ 1];
+}
+
+uint16_t avrtos_adc_get_overruns(void) {
+    return avrtos_read_volatile_u16(&g_adc_overruns);
+}
+
+void _avrtos_adc_isr(uint16_t value) {
+    if (g_adc_converting == g_adc_expected) {
+        adc_store(value);
+    }
+
+    /* a conversion that has already started uses the previous selection, the
+       new one applies to the conversion after it */
+    uint8_t target = g_adc_expected;
+    if (avrtos_adc_busy_impl()) {
+        g_adc_converting = g_adc_selected;
+        if (g_adc_selected == target) {
+            target = adc_next_channel(target);
+        }
+    } else {
+        g_adc_converting = target;
+    }
+
+    if (target != g_adc_selected) {
+        avrtos_adc_select_impl(g_adc_channels[target]);
+        g_adc_selected = target;
+    }
+}
+
+#endif // AVRTOS_WITH_ADC
@@ -0,0 +1,89 @@
+#ifndef AVRTOS_ADC_H_
+#define AVRTOS_ADC_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_ADC
+
+#ifndef AVRTOS_WITH_COMPLETION
+#error "AVRTOS_WITH_ADC requires AVRTOS_WITH_COMPLETION"
+#endif // AVRTOS_WITH_COMPLETION
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+#error "AVRTOS_WITH_ADC and AVRTOS_WITH_CRITICAL_SECTION_STATS both use TIMER1"
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+/**
+ * Timeout of avrtos_adc_next_block() that never expires.
+ */
+#define AVRTOS_ADC_FOREVER UINT64_MAX
+
+/**
+ * Starts the conversions, stops the previous ones first. Samples of the
+ * channels are interleaved in blocks of AVRTOS_ADC_BLOCK_SIZE samples, in the
+ * order of @p channels. A conversion that starts before the interrupt has
+ * switched the channel is dropped, the scan stays aligned.
+ *
+ * @param channels       Multiplexer channels to scan (0 to 7 are the pins
+ *                       ADC0 to ADC7), copied by the function.
+ *
+ * @param channels_count Number of channels, at most AVRTOS_ADC_MAX_CHANNELS.
+ *                       AVRTOS_ADC_BLOCK_SIZE has to be a multiple of it.
+ *
+ * @param rate_hz        Scans per second, the conversions are triggered at
+ *                       @p rate_hz * @p channels_count Hz. 0 converts a single
+ *                       channel continuously at the fastest rate of the ADC.
+ *
+ * @returns false if the arguments are not valid or the rate cannot be reached.
+ */
+bool avrtos_adc_start(const uint8_t *channels,
+                      uint8_t channels_count,
+                      uint32_t rate_hz);
+
+/**
+ * Stops the conversions. A block that has not been taken yet is dropped.
+ */
+void avrtos_adc_stop(void);
+
+/**
+ * Releases the block returned by the previous call and waits for the next full
+ * one. The current task sleeps, other tasks run in the meantime. The block
+ * stays valid until the next call, only a single task can take the blocks.
+ *
+ * @param timeout_us Maximal time to wait for a block or
+ *                   @ref AVRTOS_ADC_FOREVER.
+ *
+ * @returns AVRTOS_ADC_BLOCK_SIZE samples (10-bit, right adjusted) or NULL on
+ *          timeout.
+ */
+const uint16_t *avrtos_adc_next_block(uint64_t timeout_us);
+
+/**
+ * Returns the number of blocks dropped since the start, because both halves of
+ * the buffer were full (saturates at UINT16_MAX).
+ */
+uint16_t avrtos_adc_get_overruns(void);
+
+/**
+ * Stores the result of a conversion and selects the next channel. Should be a
+ * "private" function.
+ *
+ * @param value Result of the conversion.
+ */
+void _avrtos_adc_isr(uint16_t value);
+
+#endif // AVRTOS_WITH_ADC
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_ADC_H_ */
@@ -0,0 +1,61 @@
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_COMPLETION
+
+#include "avrtos_completion.h"
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "critical_section_arch_ind.h"
+
+void avrtos_completion_reset(struct avrtos_completion *completion) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_COMPLETION) {
+        completion->done = false;
+    }
+}
+
+bool avrtos_completion_wait(struct avrtos_completion *completion,
+                            uint64_t timeout_us) {
+    bool forever = timeout_us == AVRTOS_COMPLETION_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+
+    while (true) {
+        avrtos_tick_t ticks = _avrtos_delay_ticks_left(deadline, forever);
+
+        bool done = false;
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_COMPLETION) {
+            done = completion->done;
+            if (!done && ticks) {
+                completion->waiter = _avrtos_current_task_get();
+                _avrtos_task_sleep_prepare(ticks);
+            }
+        }
+        if (done) {
+            return true;
+        }
+        if (!ticks) {
+            return false;
+        }
+
+        /* woken up by avrtos_completion_complete() or the timeout, the loop
+           tells them apart */
+        avrtos_task_yield();
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_COMPLETION) {
+            completion->waiter = NULL;
+        }
+    }
+}
+
+void avrtos_completion_complete(struct avrtos_completion *completion) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_COMPLETION) {
+        completion->done = true;
+        struct avrtos_task *waiter = completion->waiter;
+        if (waiter) {
+            completion->waiter = NULL;
+            _avrtos_task_wake(waiter);
+        }
+    }
+}
+
+#endif // AVRTOS_WITH_COMPLETION
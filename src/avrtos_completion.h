@@ -0,0 +1,69 @@
+#ifndef AVRTOS_COMPLETION_H_
+#define AVRTOS_COMPLETION_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * One-shot event a single task waits for, e.g. the end of a transfer signaled
+ * by an interrupt. Field "waiter" is the sleeping task, if any.
+ */
+struct avrtos_completion {
+    struct avrtos_task *volatile waiter;
+    volatile bool done;
+};
+
+#ifdef AVRTOS_WITH_COMPLETION
+
+/**
+ * Timeout of avrtos_completion_wait() that never expires.
+ */
+#define AVRTOS_COMPLETION_FOREVER UINT64_MAX
+
+/**
+ * Marks the completion as not done. Has to be called before the event that
+ * completes it is started.
+ *
+ * @param completion Pointer to the completion.
+ */
+void avrtos_completion_reset(struct avrtos_completion *completion);
+
+/**
+ * Waits until the completion is done. The current task sleeps, other tasks run
+ * in the meantime. Only a single task can wait for a completion at a time.
+ *
+ * @param completion Pointer to the completion.
+ *
+ * @param timeout_us Maximal time to wait in microseconds, 0 to only check the
+ *                   completion or @ref AVRTOS_COMPLETION_FOREVER.
+ *
+ * @returns true if the completion is done, false on timeout. The completing
+ *          side can still run between the timeout and the moment the caller
+ *          stops it, so the caller has to stop it with interrupts disabled and
+ *          then check whether the event has finished in the meantime.
+ */
+bool avrtos_completion_wait(struct avrtos_completion *completion,
+                            uint64_t timeout_us);
+
+/**
+ * Marks the completion as done and wakes the waiting task. Can be called from
+ * ISRs.
+ *
+ * @param completion Pointer to the completion.
+ */
+void avrtos_completion_complete(struct avrtos_completion *completion);
+
+#endif // AVRTOS_WITH_COMPLETION
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_COMPLETION_H_ */
@@ -7,22 +7,353 @@
  */
 #define AVRTOS_WITH_GPIO_TRACE
 
+#ifdef AVRTOS_WITH_GPIO_TRACE
+
+/**
+ * Optional kernel trace pins (port letter, e.g. D, and bit number), toggled
+ * through the PINx register with compile-time addresses. The ISR pin is high
+ * while a handler defined with AVRTOS_ISR() runs, the idle pin is high while
+ * the idle task runs.
+ */
+// #define AVRTOS_GPIO_TRACE_ISR_PORT D
+// #define AVRTOS_GPIO_TRACE_ISR_BIT 2
+// #define AVRTOS_GPIO_TRACE_IDLE_PORT D
+// #define AVRTOS_GPIO_TRACE_IDLE_BIT 3
+
+#endif // AVRTOS_WITH_GPIO_TRACE
+
+/**
+ * Enables encoded GPIO tracing. On every task switch, the code of the running
+ * task is written as a binary value to AVRTOS_GPIO_TRACE_ENCODED_BITS
+ * consecutive bits of a port with a single masked write. Code 0 is the idle
+ * task, all ones marks interrupts defined with AVRTOS_ISR() and the other codes
+ * are task IDs, so 4 bits trace the idle task and 14 other tasks.
+ */
+// #define AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+/**
+ * Port (single letter, e.g. C) and its bits used by the encoded GPIO trace.
+ * Other bits of the port can still be used by the application.
+ */
+#define AVRTOS_GPIO_TRACE_ENCODED_PORT C
+#define AVRTOS_GPIO_TRACE_ENCODED_FIRST_BIT 0
+#define AVRTOS_GPIO_TRACE_ENCODED_BITS 4
+
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+/**
+ * Enables the kernel event trace. Task switches, entries and exits of
+ * interrupts defined with AVRTOS_ISR(), mutex and delay events and markers
+ * added with avrtos_trace_marker() are recorded with a timestamp in a RAM ring.
+ * avrtos_trace_dump() sends them over the logger USART, use
+ * tools/avrtos_trace_export.py to convert them to Perfetto JSON or VCD.
+ */
+// #define AVRTOS_WITH_TRACE
+
+#ifdef AVRTOS_WITH_TRACE
+
+/**
+ * Number of events kept in the trace buffer (5 bytes each). Should be a power
+ * of two, at most 128. When the buffer is full, the oldest events are
+ * overwritten.
+ */
+#define AVRTOS_TRACE_BUFFER_SIZE 32
+
+/**
+ * Groups of events recorded from startup, can be changed at runtime using
+ * avrtos_trace_set_mask(). The delay timer interrupt fires every tick, so ISR
+ * events are left out by default.
+ */
+#define AVRTOS_TRACE_DEFAULT_MASK (AVRTOS_TRACE_ALL & ~AVRTOS_TRACE_ISRS)
+
+#endif // AVRTOS_WITH_TRACE
+
+/**
+ * Enables the sampling profiler. Every time the scheduler timer preempts a
+ * task, the interrupted program counter is counted in a RAM histogram keyed by
+ * task and program counter. Yields are not sampled, so code that always yields
+ * before its time slice ends does not show up. avrtos_profiler_dump() sends the
+ * histogram over the logger USART, use tools/avrtos_profile.py to print a flat
+ * profile.
+ */
+// #define AVRTOS_WITH_PROFILER
+
+#ifdef AVRTOS_WITH_PROFILER
+
+/**
+ * Number of histogram entries (5 bytes each). Should be a power of two, at
+ * most 128.
+ */
+#define AVRTOS_PROFILER_TABLE_SIZE 32
+
+/**
+ * Number of entries searched for a sample before it is dropped. Bounds the
+ * time the scheduler interrupt spends in the profiler.
+ */
+#define AVRTOS_PROFILER_PROBES 4
+
+#endif // AVRTOS_WITH_PROFILER
+
+/**
+ * Enables critical section statistics. The kernel's interrupt-disabled
+ * sections, the scheduler interrupt and AVRTOS_NON_PREEMPTIVE_SECTION() record
+ * their durations per call site (maximum and a log2 histogram), timed with
+ * TIMER1 running freely at CPU clock / 8. The application can instrument its own
+ * sections with AVRTOS_CRITICAL_SECTION() and
+ * AVRTOS_NON_PREEMPTIVE_SECTION_AT(). Query them with avrtos_cs_stats_get().
+ * TIMER1 cannot be used by the application.
+ */
+// #define AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+/**
+ * Number of call sites available to the application, 18 bytes each.
+ */
+#define AVRTOS_CS_USER_SITES 2
+
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+/**
+ * Enables task introspection. avrtos_task_info_next() iterates over the tasks
+ * and returns their state, remaining delay, stack usage and CPU time. Tasks
+ * keep their stack bounds (4 bytes each) and CPU time (4 bytes each), stacks
+ * are filled with a known pattern by avrtos_task_create() to find the deepest
+ * stack use.
+ */
+// #define AVRTOS_WITH_INTROSPECTION
+
+#ifdef AVRTOS_WITH_INTROSPECTION
+
+/**
+ * Value unused stack bytes are filled with. Should not be 0, uninitialized
+ * registers and variables are often pushed as zeros.
+ */
+#define AVRTOS_STACK_PAINT_PATTERN 0xA5
+
+#endif // AVRTOS_WITH_INTROSPECTION
+
 /**
  * Enables usage of atomic mutexes.
  */
 #define AVRTOS_WITH_MUTEX
 
+/**
+ * Enables completions (struct avrtos_completion): a task sleeps in
+ * avrtos_completion_wait() until an interrupt calls
+ * avrtos_completion_complete() or the timeout expires.
+ */
+#define AVRTOS_WITH_COMPLETION
+
 /**
  * Enables usage of compile-time asserts. May increase code size by a few bytes.
  */
 #define AVRTOS_WITH_STATIC_ASSERTS
 
+/**
+ * Enables dedicated interrupt stack. Interrupts defined with AVRTOS_ISR() switch
+ * to it on the outermost entry, so their frames no longer need to fit in every
+ * task's stack.
+ */
+// #define AVRTOS_WITH_INTERRUPT_STACK
+
+#ifdef AVRTOS_WITH_INTERRUPT_STACK
+
+/**
+ * Size of the dedicated interrupt stack. Should cover the deepest interrupt
+ * handler defined with AVRTOS_ISR().
+ */
+#define AVRTOS_INTERRUPT_STACK_SIZE 96
+
+#endif // AVRTOS_WITH_INTERRUPT_STACK
+
+/**
+ * Enables stackless coroutines created with avrtos_coro_create(). All
+ * coroutines share the stack of a single coroutine runner task.
+ */
+// #define AVRTOS_WITH_COROUTINES
+
+#ifdef AVRTOS_WITH_COROUTINES
+
+/**
+ * Size of the stack shared by all coroutines. Should cover the deepest call
+ * chain of a single coroutine step.
+ */
+#define AVRTOS_COROUTINE_STACK_SIZE AVRTOS_MINIMAL_STACK_SIZE
+
+#endif // AVRTOS_WITH_COROUTINES
+
+/**
+ * Enables active objects created with avrtos_ao_create(). Events posted to
+ * active objects are dispatched, run to completion, by a small pool of worker
+ * tasks.
+ */
+// #define AVRTOS_WITH_ACTIVE_OBJECTS
+
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+
+/**
+ * Number of worker tasks dispatching active object events.
+ */
+#define AVRTOS_AO_WORKERS_COUNT 1
+
+/**
+ * Stack size of a single worker task. Should cover the deepest dispatch
+ * function.
+ */
+#define AVRTOS_AO_WORKER_STACK_SIZE AVRTOS_MINIMAL_STACK_SIZE
+
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
+
+/**
+ * Enables the kernel work queue. Work items submitted with avrtos_work_submit()
+ * (e.g. from ISRs) are run in task context by the work queue worker tasks.
+ */
+// #define AVRTOS_WITH_WORK_QUEUE
+
+#ifdef AVRTOS_WITH_WORK_QUEUE
+
+/**
+ * Number of work queue worker tasks.
+ */
+#define AVRTOS_WORK_QUEUE_WORKERS_COUNT 1
+
+/**
+ * Stack size of a single worker task. Should cover the deepest work item
+ * handler.
+ */
+#define AVRTOS_WORK_QUEUE_STACK_SIZE AVRTOS_MINIMAL_STACK_SIZE
+
+#endif // AVRTOS_WITH_WORK_QUEUE
+
 /**
  * CPU frequency in Hz. It's required to set proper register values for
  * specified baud rate and Timer periods.
  */
 #define AVRTOS_CPU_CLOCK_FREQUENCY 8000000UL
 
+/**
+ * Enables the interrupt-driven USART driver: avrtos_usart_read() and
+ * avrtos_usart_write() put the calling task to sleep until the RX complete or
+ * the data register empty interrupt has moved enough bytes, other tasks run in
+ * the meantime. If the asynchronous logger is enabled as well, its messages are
+ * multiplexed into the driver's TX buffer (whole messages, never in the middle
+ * of an avrtos_usart_write() call), AVRTOS_LOG_BUFFER_SIZE and
+ * AVRTOS_ASYNCHRONOUS_LOGGER_BAURATE are not used then. Requires
+ * AVRTOS_WITH_MUTEX.
+ */
+// #define AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_USART
+
+/**
+ * Baud rate of the USART, double speed mode is used above 38400. The nearest
+ * possible rate is set: at 8 MHz, 115200 baud is 3.5 % slow and 1000000 baud is
+ * exact.
+ */
+#define AVRTOS_USART_BAUDRATE 115200
+
+/**
+ * Sizes of the RX and TX buffers, at most 255 bytes (one of which is kept
+ * free). The TX buffer holds the log messages too.
+ */
+#define AVRTOS_USART_RX_BUFFER_SIZE 32
+#define AVRTOS_USART_TX_BUFFER_SIZE 120
+
+#endif // AVRTOS_WITH_USART
+
+/**
+ * Enables the interrupt-driven SPI master driver. avrtos_spi_acquire() locks
+ * the bus and sets the mode and clock of a device, avrtos_spi_transfer() puts
+ * the calling task to sleep while the SPI interrupt moves the bytes, other
+ * tasks run in the meantime. The interrupt fires once per byte, so the clock
+ * should be at most CPU clock / 32: at faster clocks the interrupt takes longer
+ * than the byte itself. The SS pin (PB2) is an output. Requires
+ * AVRTOS_WITH_MUTEX and AVRTOS_WITH_COMPLETION.
+ */
+// #define AVRTOS_WITH_SPI
+
+/**
+ * Enables the interrupt-driven TWI (I2C) master driver. avrtos_twi_transfer()
+ * locks the bus and puts the calling task to sleep while the TWI interrupt runs
+ * the whole transaction, other tasks run in the meantime. Requires
+ * AVRTOS_WITH_MUTEX and AVRTOS_WITH_COMPLETION.
+ */
+// #define AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_TWI
+
+/**
+ * SCL clock frequency in Hz, between AVRTOS_CPU_CLOCK_FREQUENCY / 526 and
+ * AVRTOS_CPU_CLOCK_FREQUENCY / 16 (15 kHz to 500 kHz at 8 MHz).
+ */
+#define AVRTOS_TWI_FREQUENCY 100000UL
+
+#endif // AVRTOS_WITH_TWI
+
+/**
+ * Enables the ADC streaming driver. avrtos_adc_start() scans a list of
+ * channels, triggered by TIMER1 at a fixed rate or free running (single
+ * channel), the ADC interrupt fills one half of a double buffer while a task
+ * processes the other one. avrtos_adc_next_block() sleeps until a block is
+ * full. TIMER1 cannot be used by the application, so it cannot be combined with
+ * AVRTOS_WITH_CRITICAL_SECTION_STATS. Requires AVRTOS_WITH_COMPLETION.
+ */
+// #define AVRTOS_WITH_ADC
+
+#ifdef AVRTOS_WITH_ADC
+
+/**
+ * Number of samples in a block (half of the double buffer), 2 bytes each, at
+ * most 255. Has to be a multiple of the number of scanned channels. Blocks
+ * completed while the task still holds the other half are dropped.
+ */
+#define AVRTOS_ADC_BLOCK_SIZE 32
+
+/**
+ * Maximum number of channels scanned by avrtos_adc_start().
+ */
+#define AVRTOS_ADC_MAX_CHANNELS 4
+
+#endif // AVRTOS_WITH_ADC
+
+/**
+ * Enables the EEPROM service. avrtos_eeprom_write() queues the bytes and
+ * returns, the EEPROM ready interrupt writes them one by one (~3.4 ms each),
+ * skipping bytes that already hold their value. avrtos_eeprom_sync() sleeps
+ * until the queue is written. A wear-leveled key-value store
+ * (avrtos_eeprom_kv_put() and avrtos_eeprom_kv_get()) keeps values in a
+ * region of the EEPROM and survives resets in the middle of an update.
+ * Requires AVRTOS_WITH_MUTEX and AVRTOS_WITH_COMPLETION.
+ */
+// #define AVRTOS_WITH_EEPROM
+
+#ifdef AVRTOS_WITH_EEPROM
+
+/**
+ * Number of bytes waiting to be written, 3 bytes of RAM each. Has to hold a
+ * whole key-value record (AVRTOS_EEPROM_KV_VALUE_SIZE + 7 bytes).
+ */
+#define AVRTOS_EEPROM_QUEUE_SIZE 16
+
+/**
+ * Region of the key-value store: first address and number of slots, each slot
+ * takes AVRTOS_EEPROM_KV_VALUE_SIZE + 7 bytes of EEPROM and 1 byte of RAM. At
+ * most AVRTOS_EEPROM_KV_SLOTS - 1 keys can be stored, the other slots spread
+ * the updates.
+ */
+#define AVRTOS_EEPROM_KV_START 0
+#define AVRTOS_EEPROM_KV_SLOTS 32
+
+/**
+ * Size of a value in the key-value store.
+ */
+#define AVRTOS_EEPROM_KV_VALUE_SIZE 4
+
+#endif // AVRTOS_WITH_EEPROM
+
 /**
  * Enables usage of asynchronous logger using avrtos_log() macro. If
  * AVRTOS_WITH_MUTEX is disabled, may produce strange and mixed log messages.
@@ -32,7 +363,8 @@
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
 /**
- * Size of the global log buffer.
+ * Size of the global log buffer. The buffer is a lock-free ring shared with the
+ * USART ISR, so it can hold at most 255 bytes (one of which is kept free).
  */
 #define AVRTOS_LOG_BUFFER_SIZE 120
 
@@ -45,7 +377,8 @@
 /**
  * Default level of log messages. If the log message is below default log level,
  * it won't be compiled into code. Possible values are:
- * DEBUG, INFO, WARNING, ERROR.
+ * DEBUG, INFO, WARNING, ERROR. Compiled messages can be filtered further at
+ * runtime using avrtos_log_set_level().
  */
 #define AVRTOS_LOG_DEFAULT_LEVEL INFO
 
@@ -54,6 +387,70 @@
  */
 #define AVRTOS_ASYNCHRONOUS_LOGGER_BAURATE 9600
 
+/**
+ * Default behaviour of avrtos_log() when the log buffer is full, it can be
+ * changed at runtime using avrtos_log_set_policy(). Possible values are:
+ * BLOCK (wait until the USART sends enough data), DROP (drop the whole message)
+ * and TRUNCATE (send as much of the message as fits, binary records are
+ * dropped). Dropped messages are counted per level and reported with a
+ * "N messages dropped" line once there is room in the log buffer.
+ */
+#define AVRTOS_LOG_FULL_BUFFER_POLICY BLOCK
+
+/**
+ * Enables deferred binary logging. Instead of formatting messages on the MCU,
+ * avrtos_log() sends a compact record (format string ID, timestamp and raw
+ * arguments). Format strings are kept in an ELF section that is not loaded to
+ * the MCU, use tools/avrtos_log_decoder.py to turn the output into text.
+ */
+// #define AVRTOS_WITH_BINARY_LOGGER
+
+#ifdef AVRTOS_WITH_BINARY_LOGGER
+
+/**
+ * Maximum size of single binary log record, 8-byte header included. Arguments
+ * that do not fit are not sent.
+ */
+#define AVRTOS_BINARY_LOG_MAX_SIZE 24
+
+#endif // AVRTOS_WITH_BINARY_LOGGER
+
+/**
+ * Enables the interactive shell task on the logger USART. Received characters
+ * are buffered by the USART RX interrupt, the shell task polls them and answers
+ * through the log buffer. Commands: help, ps, top, stack, log level and trace
+ * dump (with AVRTOS_WITH_TRACE). Requires AVRTOS_WITH_INTROSPECTION, cannot be
+ * combined with AVRTOS_WITH_BINARY_LOGGER.
+ */
+// #define AVRTOS_WITH_SHELL
+
+#ifdef AVRTOS_WITH_SHELL
+
+/**
+ * Size of the USART RX buffer. Characters received while it is full are lost.
+ * At 9600 baud, one character arrives every ~1 ms. With AVRTOS_WITH_USART, the
+ * RX buffer of the driver is used instead.
+ */
+#define AVRTOS_SHELL_RX_BUFFER_SIZE 16
+
+/**
+ * Period in milliseconds the shell task sleeps for when there is no received
+ * character. Should be shorter than the time needed to fill the RX buffer.
+ */
+#define AVRTOS_SHELL_POLL_PERIOD_MS 10
+
+/**
+ * Maximum length of a command line, longer lines are rejected.
+ */
+#define AVRTOS_SHELL_LINE_MAX_SIZE 24
+
+/**
+ * Stack size of the shell task. Formatting the answers takes most of it.
+ */
+#define AVRTOS_SHELL_STACK_SIZE 192
+
+#endif // AVRTOS_WITH_SHELL
+
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
 #endif /* AVRTOS_CONFIG_H_ */
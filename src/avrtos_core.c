@@ -1,22 +1,64 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <stdlib.h>
+#include <string.h>
 #include <util/atomic.h>
 
 #include "avrtos_config.h"
 #include "avrtos_core.h"
 #include "avrtos_delay.h"
 #include "boards/avrtos_board_impl.h"
+#include "critical_section_arch_ind.h"
 #include "linked_list_arch_ind.h"
 
-#ifdef AVRTOS_WITH_GPIO_TRACE
+#if defined(AVRTOS_WITH_GPIO_TRACE) || defined(AVRTOS_WITH_GPIO_TRACE_ENCODED)
 #include "avrtos_gpio_trace.h"
-#endif // AVRTOS_WITH_GPIO_TRACE
+#endif // AVRTOS_WITH_GPIO_TRACE || AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#ifdef AVRTOS_WITH_TRACE
+#include "trace_arch_ind.h"
+#endif // AVRTOS_WITH_TRACE
+
+#ifdef AVRTOS_WITH_PROFILER
+#include "profiler_arch_ind.h"
+#endif // AVRTOS_WITH_PROFILER
 
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 #include "avrtos_logger.h"
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
+#ifdef AVRTOS_WITH_COROUTINES
+#include "avrtos_coroutine.h"
+#endif // AVRTOS_WITH_COROUTINES
+
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+#include "avrtos_active_object.h"
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
+
+#ifdef AVRTOS_WITH_WORK_QUEUE
+#include "avrtos_work.h"
+#endif // AVRTOS_WITH_WORK_QUEUE
+
+#ifdef AVRTOS_WITH_SHELL
+#include "avrtos_shell.h"
+#endif // AVRTOS_WITH_SHELL
+
+#ifdef AVRTOS_WITH_USART
+#include "avrtos_usart.h"
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_SPI
+#include "avrtos_spi.h"
+#endif // AVRTOS_WITH_SPI
+
+#ifdef AVRTOS_WITH_TWI
+#include "avrtos_twi.h"
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_EEPROM
+#include "avrtos_eeprom.h"
+#endif // AVRTOS_WITH_EEPROM
+
 #define PUSH_TO_STACK(Register) __asm__ volatile("push " #Register " \n\t");
 #define PUSH_MULTIPLE_TO_STACK(...) AVRTOS_MAP(PUSH_TO_STACK, __VA_ARGS__)
 
@@ -27,6 +69,25 @@
     __asm__ volatile("mov " #Register ", __zero_reg__ \n\t");
 #define SET_MULTIPLE_TO_ZERO(...) AVRTOS_MAP(SET_TO_ZERO, __VA_ARGS__)
 
+#ifdef AVRTOS_WITH_PROFILER
+#ifdef __AVR_3_BYTE_PC__
+#error "AVRTOS_WITH_PROFILER supports only 2-byte program counters"
+#endif // __AVR_3_BYTE_PC__
+
+/* the scheduler interrupt pushes 32 registers and SREG below the return
+   address, the saved SP points below the last pushed byte */
+#define TASK_FRAME_RETURN_ADDRESS_OFFSET 34
+
+/* set when the scheduler interrupt is entered by a yield instead of the timer,
+   such entries are not time samples */
+static volatile bool g_sched_yielding;
+#endif // AVRTOS_WITH_PROFILER
+
+#ifdef AVRTOS_WITH_INTROSPECTION
+/* delay timer tick of the last task switch, only touched by the scheduler */
+static avrtos_tick_t g_task_switched_at;
+#endif // AVRTOS_WITH_INTROSPECTION
+
 volatile uint16_t g_main_task_sp = 0x08ff;
 volatile struct avrtos_task *HEAD = NULL;
 volatile struct avrtos_task *g_current_task = NULL;
@@ -46,7 +107,7 @@ static bool task_is_on_delay(volatile struct avrtos_task *task) {
 }
 
 static bool task_should_exit_delay(volatile struct avrtos_task *task) {
-    return (task->delay_until < _avrtos_delay_get_microseconds());
+    return _avrtos_delay_tick_has_passed(task->delay_until);
 }
 
 static void task_mask_as_running_if_needed(void) {
@@ -71,6 +132,10 @@ static void task_find_next_suitable(void) {
         LINKED_LIST_FOREACH_FROM_SPECIFIED(HEAD, start_from, iterator) {
             if (task_is_on_delay(iterator)) {
                 if (task_should_exit_delay(iterator)) {
+#ifdef AVRTOS_WITH_TRACE
+                    _avrtos_trace_record(AVRTOS_TRACE_DELAY_EXPIRE,
+                                         iterator->id);
+#endif // AVRTOS_WITH_TRACE
                     g_current_task = iterator;
                     goto found;
                 }
@@ -84,18 +149,83 @@ found:
     return;
 }
 
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+static uint8_t task_gpio_trace_code(volatile struct avrtos_task *task) {
+    if (task == &_idle_task) {
+        return AVRTOS_GPIO_TRACE_CODE_IDLE;
+    }
+    return task->id < AVRTOS_GPIO_TRACE_CODE_MAX_TASK
+                   ? task->id
+                   : AVRTOS_GPIO_TRACE_CODE_MAX_TASK;
+}
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#ifdef AVRTOS_WITH_PROFILER
+static void task_profiler_sample(void) {
+    if (g_sched_yielding) {
+        g_sched_yielding = false;
+        return;
+    }
+
+    /* return address is stored big-endian, high byte at the lower address */
+    const uint8_t *frame = (const uint8_t *) (uintptr_t) g_current_task->sp;
+    uint16_t pc = (uint16_t) frame[TASK_FRAME_RETURN_ADDRESS_OFFSET] << 8
+                  | frame[TASK_FRAME_RETURN_ADDRESS_OFFSET + 1];
+    _avrtos_profiler_record(g_current_task->id, pc);
+}
+#endif // AVRTOS_WITH_PROFILER
+
+#ifdef AVRTOS_WITH_INTROSPECTION
+static void task_account_cpu_ticks(volatile struct avrtos_task *task) {
+    /* ticks that elapse while the task runs are counted, a task switched out
+       within the same tick is charged nothing */
+    avrtos_tick_t now = _avrtos_delay_get_ticks();
+    task->cpu_ticks += now - g_task_switched_at;
+    g_task_switched_at = now;
+}
+#endif // AVRTOS_WITH_INTROSPECTION
+
 static void task_select_next(void) {
+#ifdef AVRTOS_WITH_INTROSPECTION
+    task_account_cpu_ticks(g_current_task);
+#endif // AVRTOS_WITH_INTROSPECTION
+
 #ifdef AVRTOS_WITH_GPIO_TRACE
     _avrtos_gpio_trace_clear((struct avrtos_task *) g_current_task);
 #endif // AVRTOS_WITH_GPIO_TRACE
 
+#if defined(AVRTOS_WITH_TRACE) || defined(_AVRTOS_GPIO_TRACE_IDLE_TOGGLE)
+    volatile struct avrtos_task *previous = g_current_task;
+#endif // AVRTOS_WITH_TRACE || _AVRTOS_GPIO_TRACE_IDLE_TOGGLE
+
     task_mark_as_ready_if_needed();
     task_find_next_suitable();
     task_mask_as_running_if_needed();
 
+#ifdef AVRTOS_WITH_TRACE
+    /* idle task yielding to itself is not a switch */
+    if (g_current_task != previous) {
+        _avrtos_trace_record(AVRTOS_TRACE_TASK_SWITCH_OUT, previous->id);
+        _avrtos_trace_record(AVRTOS_TRACE_TASK_SWITCH_IN, g_current_task->id);
+    }
+#endif // AVRTOS_WITH_TRACE
+
 #ifdef AVRTOS_WITH_GPIO_TRACE
     _avrtos_gpio_trace_set((struct avrtos_task *) g_current_task);
 #endif // AVRTOS_WITH_GPIO_TRACE
+
+#ifdef _AVRTOS_GPIO_TRACE_IDLE_TOGGLE
+    if ((previous == &_idle_task) != (g_current_task == &_idle_task)) {
+        _AVRTOS_GPIO_TRACE_IDLE_TOGGLE();
+    }
+#endif // _AVRTOS_GPIO_TRACE_IDLE_TOGGLE
+
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+    /* interrupt handlers restore the task code, keep it consistent */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        _avrtos_gpio_trace_encoded_set(task_gpio_trace_code(g_current_task));
+    }
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
 }
 
 static int task_add_to_list(struct avrtos_task *task) {
@@ -110,15 +240,6 @@ static int task_add_to_list(struct avrtos_task *task) {
     return 0;
 }
 
-static void task_sp_and_state_init(void) {
-    /* decrement task SP by 2 == sizeof(task_fun_t)
-       NOTE: this couldn't be done in avrtos_task_create() function due to the
-       fact that "task" variable was just an argument and there is a problem in
-       setting argument values using assembler manually */
-    g_current_task->sp -= sizeof(g_current_task->function);
-    g_current_task->state = AVRTOS_RUNNING;
-}
-
 struct avrtos_task *_avrtos_current_task_get(void) {
     return (struct avrtos_task *) g_current_task;
 }
@@ -134,17 +255,26 @@ int avrtos_task_create(struct avrtos_task *task,
         return 1;
     }
 
+    if (id > AVRTOS_MAX_TASK_ID) {
+        return 1;
+    }
+
     if (task_add_to_list(task)) {
         return 1;
     }
 
     task->id = id++;
-    task->function = function;
     task->sp = (uint16_t) stack + stack_size - 1;
-    task->sreg = 0x00;
     task->state = AVRTOS_NOT_INITIALIZED;
     task->next = NULL;
-    task->arg = arg;
+
+#ifdef AVRTOS_WITH_INTROSPECTION
+    task->stack = stack;
+    task->stack_size = stack_size;
+    task->cpu_ticks = 0;
+    /* bytes that still hold the pattern have never been used */
+    memset(stack, AVRTOS_STACK_PAINT_PATTERN, stack_size);
+#endif // AVRTOS_WITH_INTROSPECTION
 
     PUSH_MULTIPLE_TO_STACK(r31, r30, r29, r28, r27, r26);
     __asm__ volatile(
@@ -158,41 +288,191 @@ int avrtos_task_create(struct avrtos_task *task,
                this will be used with the first reti instruction */
             "push %A0 \n\t"
             "push %B0 \n\t"
+            /* push task argument, it will be popped into r24 and r25
+               registers right before the first reti instruction */
+            "push %A2 \n\t"
+            "push %B2 \n\t"
             /* restore original SP */
             "out __SP_L__, r26 \n\t"
             "out __SP_H__, r27 \n\t"
             ""
             :
-            : "z"(task->function), "y"(task->sp));
+            : "z"(function), "y"(task->sp), "r"(arg)
+            : "r26", "r27");
     POP_MULTIPLE_FROM_STACK(r26, r27, r28, r29, r30, r31);
 
+    task->sp -= sizeof(function) + sizeof(arg);
+
     return 0;
 }
 
 void avrtos_task_yield(void) {
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_YIELD) {
         _avrtos_sched_timer_reset();
     }
+#ifdef AVRTOS_WITH_PROFILER
+    /* a timer sample taken between setting the flag and the call would be
+       skipped in place of this entry, so interrupts stay disabled until the
+       scheduler returns with reti */
+    cli();
+    g_sched_yielding = true;
+#endif // AVRTOS_WITH_PROFILER
     __asm__ volatile("call scheduler_interupt_start \n\t");
 }
 
+#ifdef AVRTOS_WITH_INTROSPECTION
+static uint16_t task_stack_used(const struct avrtos_task *task) {
+    /* the stack grows down, its unused part starts at the lowest address */
+    uint16_t unused = 0;
+    while (unused < task->stack_size
+           && task->stack[unused] == AVRTOS_STACK_PAINT_PATTERN) {
+        unused++;
+    }
+    return task->stack_size - unused;
+}
+
+bool avrtos_task_info_next(struct avrtos_task **iterator,
+                           struct avrtos_task_info *out_info) {
+    if (!(iterator && out_info)) {
+        return false;
+    }
+
+    struct avrtos_task *task;
+    avrtos_tick_t delay_until;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_TASK_INFO) {
+        task = *iterator ? (*iterator)->next : (struct avrtos_task *) HEAD;
+        if (task) {
+            out_info->id = task->id;
+            out_info->state = (enum avrtos_task_state) task->state;
+            out_info->cpu_ticks = task->cpu_ticks;
+            delay_until = task->delay_until;
+        }
+    }
+    if (!task) {
+        return false;
+    }
+
+    out_info->idle = task == &_idle_task;
+    out_info->delay_remaining = 0;
+    if (out_info->state == AVRTOS_WAITING) {
+        avrtos_tick_t remaining = delay_until - _avrtos_delay_get_ticks();
+        if ((int32_t) remaining > 0) {
+            out_info->delay_remaining = remaining;
+        }
+    }
+    out_info->stack_size = task->stack_size;
+    out_info->stack_used = task_stack_used(task);
+
+    *iterator = task;
+    return true;
+}
+
+void avrtos_task_cpu_ticks_reset(void) {
+    for (volatile struct avrtos_task *iterator = HEAD; iterator;
+         iterator = iterator->next) {
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_TASK_INFO) {
+            iterator->cpu_ticks = 0;
+        }
+    }
+}
+#endif // AVRTOS_WITH_INTROSPECTION
+
+void _avrtos_task_sleep_prepare(avrtos_tick_t ticks) {
+    struct avrtos_task *current = (struct avrtos_task *) g_current_task;
+    current->delay_until = _avrtos_delay_get_ticks() + ticks;
+    current->state = AVRTOS_WAITING;
+
+#ifdef AVRTOS_WITH_TRACE
+    _avrtos_trace_record(AVRTOS_TRACE_DELAY_START, current->id);
+#endif // AVRTOS_WITH_TRACE
+}
+
+void _avrtos_task_wake(struct avrtos_task *task) {
+    /* the scheduler resumes a waiting task once its delay has passed. The
+       scheduler reads delay_until with interrupts enabled, a read torn by this
+       write only postpones the wake-up to the next scheduling round */
+    task->delay_until = _avrtos_delay_get_ticks() - 1;
+}
+
 uint8_t _avrtos_current_task_id(void) {
     return g_current_task ? g_current_task->id : AVRTOS_INVALID_TASK_ID;
 }
 
 void avrtos_scheduler_start(void) {
+#ifdef AVRTOS_WITH_USART
+    /* before the logger, which may send through the USART driver */
+    _avrtos_usart_init();
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_SPI
+    _avrtos_spi_init();
+#endif // AVRTOS_WITH_SPI
+
+#ifdef AVRTOS_WITH_TWI
+    _avrtos_twi_init();
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_EEPROM
+    _avrtos_eeprom_init();
+#endif // AVRTOS_WITH_EEPROM
+
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
     _avrtos_logger_init();
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
-    (void) avrtos_task_create(&_idle_task, _idle_thread, _idle_task_stack,
-                              sizeof(_idle_task_stack), NULL);
+#ifdef AVRTOS_WITH_COROUTINES
+    _avrtos_coro_runner_init();
+#endif // AVRTOS_WITH_COROUTINES
+
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+    _avrtos_ao_workers_init();
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
+
+#ifdef AVRTOS_WITH_WORK_QUEUE
+    _avrtos_work_queue_init();
+#endif // AVRTOS_WITH_WORK_QUEUE
+
+#ifdef AVRTOS_WITH_SHELL
+    _avrtos_shell_init();
+#endif // AVRTOS_WITH_SHELL
+
+    if (avrtos_task_create(&_idle_task, _idle_thread, _idle_task_stack,
+                           sizeof(_idle_task_stack), NULL)) {
+        /* all task IDs are taken, without the idle task the scheduler would
+           spin when every task waits */
+        cli();
+        while (1) {
+        }
+    }
+
+#ifdef AVRTOS_WITH_GPIO_TRACE
+    /* pins are toggled from now on, start from the traced state */
+    _avrtos_gpio_trace_init();
+    _avrtos_gpio_trace_set((struct avrtos_task *) g_current_task);
+#ifdef _AVRTOS_GPIO_TRACE_IDLE_TOGGLE
+    if (g_current_task == &_idle_task) {
+        _AVRTOS_GPIO_TRACE_IDLE_TOGGLE();
+    }
+#endif // _AVRTOS_GPIO_TRACE_IDLE_TOGGLE
+#endif // AVRTOS_WITH_GPIO_TRACE
+
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+    _avrtos_gpio_trace_encoded_init();
+    _avrtos_gpio_trace_encoded_set(task_gpio_trace_code(g_current_task));
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
 
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+        avrtos_cs_timer_init_impl();
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
         _avrtos_sched_timer_init();
         _avrtos_delay_timer_init();
     }
 
+#ifdef AVRTOS_WITH_TRACE
+    _avrtos_trace_record(AVRTOS_TRACE_TASK_SWITCH_IN, g_current_task->id);
+#endif // AVRTOS_WITH_TRACE
+
     __asm__ volatile("JMP task_deploy_start \n\t");
 }
 
@@ -208,12 +488,16 @@ ISR(TIMER0_COMPA_vect, ISR_NAKED) {
                            r21, r20, r19, r18, r17, r16, r15, r14, r13, r12,
                            r11, r10, r9, r8, r7, r6, r5, r4, r3, r2, r1, r0);
 
-    /* save tasks SP and SREG to its struct */
+    /* push current task SREG onto its stack (r0 has already been saved) */
+    __asm__ volatile("in r0, __SREG__ \n\t"
+                     "push r0 \n\t"
+                     "");
+
+    /* save tasks SP to its struct */
     __asm__ volatile("in %A0, __SP_L__ \n\t"
                      "in %B0, __SP_H__ \n\t"
-                     "in %A1, __SREG__ \n\t"
                      ""
-                     : "=e"(g_current_task->sp), "=e"(g_current_task->sreg)
+                     : "=e"(g_current_task->sp)
                      :);
 
     /* set SP to main stack for scheduling operations */
@@ -222,10 +506,24 @@ ISR(TIMER0_COMPA_vect, ISR_NAKED) {
                      :
                      : "e"(g_main_task_sp));
 
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+    _avrtos_cs_scheduler_begin();
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+#ifdef AVRTOS_WITH_PROFILER
+    task_profiler_sample();
+#endif // AVRTOS_WITH_PROFILER
+
     avrtos_sched_timer_stop_impl();
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+    _avrtos_cs_scheduler_end(false);
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
     sei();
     task_select_next();
     cli();
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+    _avrtos_cs_scheduler_begin();
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
     avrtos_sched_timer_resume_impl();
 
     /* save main SP to its variable */
@@ -235,10 +533,14 @@ ISR(TIMER0_COMPA_vect, ISR_NAKED) {
                      : "=e"(g_main_task_sp)
                      :);
 
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+    _avrtos_cs_scheduler_end(true);
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
     if (g_current_task->state == AVRTOS_NOT_INITIALIZED) {
         __asm__ volatile("task_deploy_start: \n\t");
 
-        task_sp_and_state_init();
+        g_current_task->state = AVRTOS_RUNNING;
 
         /* save main SP to its variable */
         __asm__ volatile("in %A0, __SP_L__ \n\t"
@@ -254,12 +556,13 @@ ISR(TIMER0_COMPA_vect, ISR_NAKED) {
                          :
                          : "e"(g_current_task->sp));
 
-        /* move task argument pointer into the r24 and r25 registers */
-        __asm__ volatile("mov r24, %A0 \n\t"
-                         "mov r25, %B0 \n\t"
+        /* pop task argument pointer into the r24 and r25 registers */
+        __asm__ volatile("pop r25 \n\t"
+                         "pop r24 \n\t"
                          ""
                          :
-                         : "x"(g_current_task->arg));
+                         :
+                         : "r24", "r25");
 
         /* set all registers and SREG to zero
         (except r1 == __zero_reg__ and r25,r24 == argument registers) */
@@ -272,13 +575,17 @@ ISR(TIMER0_COMPA_vect, ISR_NAKED) {
         __asm__ volatile("reti");
     }
 
-    /* restore tasks SP and SREG */
+    /* restore tasks SP */
     __asm__ volatile("out __SP_L__, %A0 \n\t"
                      "out __SP_H__, %B0 \n\t"
-                     "out __SREG__, %A1 \n\t"
                      ""
                      :
-                     : "e"(g_current_task->sp), "e"(g_current_task->sreg));
+                     : "e"(g_current_task->sp));
+
+    /* pop current task SREG from its stack */
+    __asm__ volatile("pop r0 \n\t"
+                     "out __SREG__, r0 \n\t"
+                     "");
 
     /* pop current task registers from its stack */
     POP_MULTIPLE_FROM_STACK(r0, r1, r2, r3, r4, r5, r6, r7, r8, r9, r10, r11,
@@ -7,6 +7,10 @@
 #include "avrtos_init.h"
 #include "boards/avrtos_board_impl.h"
 
+#ifdef AVRTOS_WITH_INTERRUPT_STACK
+#include "avrtos_isr.h"
+#endif // AVRTOS_WITH_INTERRUPT_STACK
+
 #ifdef AVRTOS_WITH_GPIO_TRACE
 #include "avrtos_gpio_trace.h"
 #endif // AVRTOS_WITH_GPIO_TRACE
@@ -26,22 +30,56 @@ enum avrtos_task_state {
 };
 
 /**
- * Struct containing all required task information.
+ * Number of bits used by the task ID and the task state in @ref struct
+ * avrtos_task. Both fields share a single byte.
+ */
+#define AVRTOS_TASK_ID_BITS 6
+#define AVRTOS_TASK_STATE_BITS 2
+
+/**
+ * Maximum number of tasks (including the idle task) that can be created.
+ */
+#define AVRTOS_MAX_TASK_ID ((1 << AVRTOS_TASK_ID_BITS) - 1)
+
+/**
+ * Struct containing all required task information. Task function and task
+ * argument are pushed onto the task's stack by avrtos_task_create() and are
+ * consumed by the first deployment of the task. Task's SREG is saved on its
+ * stack together with the general purpose registers.
  */
 struct avrtos_task {
-    uint8_t id;
-    void (*function)(void *);
     uint16_t sp;
-    uint8_t sreg;
-    enum avrtos_task_state state;
-    void *arg;
+    uint8_t id : AVRTOS_TASK_ID_BITS;
+    uint8_t state : AVRTOS_TASK_STATE_BITS;
 #ifdef AVRTOS_WITH_GPIO_TRACE
     struct avrtos_gpio_trace *gpio_trace;
 #endif // AVRTOS_WITH_GPIO_TRACE
-    uint64_t delay_until;
+    avrtos_tick_t delay_until;
+#ifdef AVRTOS_WITH_INTROSPECTION
+    uint8_t *stack;
+    uint16_t stack_size;
+    avrtos_tick_t cpu_ticks;
+#endif // AVRTOS_WITH_INTROSPECTION
     struct avrtos_task *next;
 };
 
+#ifdef AVRTOS_WITH_INTROSPECTION
+/**
+ * Snapshot of a task returned by avrtos_task_info_next(). CPU time is counted
+ * in delay timer ticks: a task is charged with the ticks that elapse while it
+ * runs, including the time spent in interrupt handlers that preempt it.
+ */
+struct avrtos_task_info {
+    uint8_t id;
+    enum avrtos_task_state state;
+    bool idle;
+    avrtos_tick_t delay_remaining;
+    avrtos_tick_t cpu_ticks;
+    uint16_t stack_size;
+    uint16_t stack_used;
+};
+#endif // AVRTOS_WITH_INTROSPECTION
+
 /**
  * Creates avrtos task. Links task function, task stack and task arguments with
  * specified @ref struct avrtos_task. Appends linked list with the initialized
@@ -60,7 +98,8 @@ struct avrtos_task {
  *
  * @param arg        Pointer to a generic task argument.
  *
- * @returns non-zero value if @p task is NULL,
+ * @returns non-zero value if @p task is NULL or @ref AVRTOS_MAX_TASK_ID tasks
+ *          have already been created,
  *          0 otherwise.
  */
 int avrtos_task_create(struct avrtos_task *task,
@@ -71,7 +110,8 @@ int avrtos_task_create(struct avrtos_task *task,
 
 /**
  * Sets proper values to the required timer(s). Turns on interrupts. Deploys
- * first task.
+ * first task. Halts with interrupts disabled if the idle task cannot be
+ * created, i.e. @ref AVRTOS_MAX_TASK_ID tasks have already been created.
  */
 void avrtos_scheduler_start(void);
 
@@ -80,6 +120,55 @@ void avrtos_scheduler_start(void);
  */
 void avrtos_task_yield(void);
 
+#ifdef AVRTOS_WITH_INTROSPECTION
+/**
+ * Iterates over all created tasks (the idle task included) in scheduling order
+ * and takes a snapshot of each of them. Stack usage is the deepest use since
+ * the task creation, found by scanning the task's stack for bytes that still
+ * hold @ref AVRTOS_STACK_PAINT_PATTERN, so the call takes time proportional to
+ * the stack size. Interrupts are disabled only while the task fields are
+ * copied.
+ *
+ * @param iterator Pointer to the iterator, which should be NULL before the
+ *                 first call. It is advanced to the task returned in
+ *                 @p out_info.
+ *
+ * @param out_info Destination of the task snapshot.
+ *
+ * @returns true if @p out_info has been filled,
+ *          false if there are no more tasks or any argument is NULL.
+ */
+bool avrtos_task_info_next(struct avrtos_task **iterator,
+                           struct avrtos_task_info *out_info);
+
+/**
+ * Clears the CPU time of all tasks, e.g. to measure CPU usage over an interval.
+ */
+void avrtos_task_cpu_ticks_reset(void);
+#endif // AVRTOS_WITH_INTROSPECTION
+
+/**
+ * Marks the current task as waiting for at most @p ticks delay timer ticks or
+ * until @ref _avrtos_task_wake is called for it. The task stops running at the
+ * next yield. Has to be called with interrupts disabled, in the same critical
+ * section in which the caller has checked its wake-up condition, so a wake-up
+ * from an interrupt cannot be missed. Should be a "private" function.
+ *
+ * @param ticks Timeout in delay timer ticks, at most
+ *              @ref AVRTOS_DELAY_MAX_TICKS.
+ */
+void _avrtos_task_sleep_prepare(avrtos_tick_t ticks);
+
+/**
+ * Ends the wait of a task marked with @ref _avrtos_task_sleep_prepare, the
+ * task is resumed like after an expired delay. Does nothing harmful if the
+ * task is not waiting. Can be called from ISRs, has to be called with
+ * interrupts disabled. Should be a "private" function.
+ *
+ * @param task Pointer to the waiting task.
+ */
+void _avrtos_task_wake(struct avrtos_task *task);
+
 /**
  * Returns the ID of the current task. Should be a "private" function.
  */
@@ -121,12 +210,22 @@ static inline void _avrtos_sched_timer_resume(void) {
 struct avrtos_task *_avrtos_current_task_get(void);
 
 /**
- * Minimal stack size that does not crashes the basic application.
+ * Minimal stack size that does not crashes the basic application. Registers
+ * size consists of 32 general purpose registers and SREG. ISR bytes cover the
+ * frame of the logger's USART interrupt, which is only a few bytes when the
+ * dedicated interrupt stack is enabled. Log messages are streamed character by
+ * character into the log buffer, so only the formatting functions' frames are
+ * added (estimated, not measured).
  */
-#define AVRTOS_STACK_REGISTERS_SIZE 32
+#define AVRTOS_STACK_REGISTERS_SIZE 33
 #define AVRTOS_STACK_BASIC_BYTES 32
+#ifdef AVRTOS_WITH_INTERRUPT_STACK
+#define AVRTOS_STACK_ISR_BYTES AVRTOS_INTERRUPT_STACK_TASK_FRAME_SIZE
+#else // AVRTOS_WITH_INTERRUPT_STACK
+#define AVRTOS_STACK_ISR_BYTES 32
+#endif // AVRTOS_WITH_INTERRUPT_STACK
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
-#define STACK_ADDITIONAL_BYTES AVRTOS_SINGLE_LOG_MAX_SIZE + 100
+#define STACK_ADDITIONAL_BYTES (60 + AVRTOS_STACK_ISR_BYTES)
 #else // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 #define STACK_ADDITIONAL_BYTES 0
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
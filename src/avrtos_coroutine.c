@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_COROUTINES
+
+#include "avrtos_core.h"
+#include "avrtos_coroutine.h"
+#include "avrtos_delay.h"
+#include "critical_section_arch_ind.h"
+
+struct avrtos_coro *g_coro_head = NULL;
+
+AVRTOS_TASK_DEFINE(_coro_runner_task);
+AVRTOS_STACK_DEFINE(_coro_runner_stack, AVRTOS_COROUTINE_STACK_SIZE);
+
+static bool coro_is_ready(struct avrtos_coro *coro) {
+    if (coro->state == AVRTOS_CORO_WAITING
+        && _avrtos_delay_tick_has_passed(coro->delay_until)) {
+        coro->state = AVRTOS_CORO_READY;
+    }
+
+    return (coro->state == AVRTOS_CORO_READY);
+}
+
+static void _coro_runner_thread(void *arg) {
+    (void) arg;
+    while (1) {
+        /* run every ready coroutine once, in creation order, then let the
+           other tasks run */
+        for (struct avrtos_coro *iterator = g_coro_head; iterator;
+             iterator = iterator->next) {
+            if (coro_is_ready(iterator)) {
+                iterator->function(iterator);
+            }
+        }
+        avrtos_task_yield();
+    }
+}
+
+int avrtos_coro_create(struct avrtos_coro *coro,
+                       void (*function)(struct avrtos_coro *),
+                       void *arg) {
+    if (!(coro && function)) {
+        return 1;
+    }
+
+    coro->lc = 0;
+    coro->state = AVRTOS_CORO_READY;
+    coro->delay_until = 0;
+    coro->function = function;
+    coro->arg = arg;
+    coro->next = NULL;
+
+    if (!g_coro_head) {
+        g_coro_head = coro;
+    } else {
+        struct avrtos_coro *last = g_coro_head;
+        while (last->next) {
+            last = last->next;
+        }
+        last->next = coro;
+    }
+
+    return 0;
+}
+
+void avrtos_coro_sem_give(struct avrtos_coro_sem *sem) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_CORO_SEM_GIVE) {
+        if (sem->count < UINT8_MAX) {
+            sem->count++;
+        }
+    }
+}
+
+bool avrtos_coro_sem_try_take(struct avrtos_coro_sem *sem) {
+    bool ret = false;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_CORO_SEM_TAKE) {
+        if (sem->count > 0) {
+            sem->count--;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool _avrtos_coro_queue_try_put(struct circular_buffer *queue, char value) {
+    enum circular_buffer_status ret;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_CORO_QUEUE_PUT) {
+        ret = circ_buff_insert_one(queue, value);
+    }
+
+    return (ret == CIRC_BUFF_OK);
+}
+
+bool _avrtos_coro_queue_try_get(struct circular_buffer *queue,
+                                char *out_value) {
+    enum circular_buffer_status ret;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_CORO_QUEUE_GET) {
+        ret = circ_buff_get_one(queue, out_value);
+    }
+
+    return (ret == CIRC_BUFF_OK);
+}
+
+void _avrtos_coro_delay_us(struct avrtos_coro *coro, uint64_t delay_us) {
+    coro->delay_until = _avrtos_delay_deadline(delay_us);
+    coro->state = AVRTOS_CORO_WAITING;
+}
+
+void _avrtos_coro_runner_init(void) {
+    if (g_coro_head) {
+        (void) avrtos_task_create(&_coro_runner_task, _coro_runner_thread,
+                                  _coro_runner_stack,
+                                  sizeof(_coro_runner_stack), NULL);
+    }
+}
+
+#endif // AVRTOS_WITH_COROUTINES
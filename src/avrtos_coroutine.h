@@ -0,0 +1,203 @@
+#ifndef AVRTOS_COROUTINE_H_
+#define AVRTOS_COROUTINE_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "circular_buffer_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_COROUTINES
+
+/**
+ * Specifies coroutine current state.
+ */
+enum avrtos_coro_state {
+    AVRTOS_CORO_READY,
+    AVRTOS_CORO_WAITING,
+    AVRTOS_CORO_FINISHED
+};
+
+/**
+ * Stackless coroutine. All coroutines run on the single shared stack of the
+ * coroutine runner task, so local variables of a coroutine function do not
+ * survive AVRTOS_CORO_YIELD() and other blocking macros. Persistent data should
+ * be kept in static variables or in the structure pointed by the @ref arg
+ * field.
+ */
+struct avrtos_coro {
+    uint16_t lc;
+    uint8_t state;
+    avrtos_tick_t delay_until;
+    void (*function)(struct avrtos_coro *);
+    void *arg;
+    struct avrtos_coro *next;
+};
+
+/**
+ * Counting semaphore that can be awaited by coroutines and given from tasks,
+ * coroutines and ISRs.
+ */
+struct avrtos_coro_sem {
+    volatile uint8_t count;
+};
+
+/**
+ * Simple coroutine declaration. Does not initialize the struct.
+ *
+ * @param CoroName Name of the coroutine that will be used as its identifier.
+ */
+#define AVRTOS_CORO_DEFINE(CoroName) struct avrtos_coro CoroName
+
+/**
+ * Simple coroutine semaphore definition.
+ *
+ * @param SemName      Name of the semaphore.
+ *
+ * @param InitialCount Initial value of the semaphore's counter.
+ */
+#define AVRTOS_CORO_SEM_DEFINE(SemName, InitialCount) \
+    struct avrtos_coro_sem SemName = {.count = (InitialCount)}
+
+/**
+ * Creates a coroutine and appends it to the coroutine list. Coroutines are run
+ * by the coroutine runner task, which is created by avrtos_scheduler_start()
+ * if at least one coroutine exists. Should be called before
+ * avrtos_scheduler_start().
+ *
+ * @param coro     Pointer to the static @ref struct avrtos_coro structure.
+ *
+ * @param function Coroutine function. Its body should be enclosed in
+ *                 AVRTOS_CORO_BEGIN() and AVRTOS_CORO_END().
+ *
+ * @param arg      Pointer to a generic coroutine argument.
+ *
+ * @returns non-zero value if @p coro or @p function is NULL,
+ *          0 otherwise.
+ */
+int avrtos_coro_create(struct avrtos_coro *coro,
+                       void (*function)(struct avrtos_coro *),
+                       void *arg);
+
+/**
+ * Gives the semaphore. Can be called from an ISR.
+ *
+ * @param sem Pointer to the semaphore.
+ */
+void avrtos_coro_sem_give(struct avrtos_coro_sem *sem);
+
+/**
+ * Takes the semaphore if its counter is greater than zero. Does not wait.
+ *
+ * @param sem Pointer to the semaphore.
+ *
+ * @returns true if the semaphore has been taken,
+ *          false otherwise.
+ */
+bool avrtos_coro_sem_try_take(struct avrtos_coro_sem *sem);
+
+/**
+ * Inserts/gets one element into/from the queue with interrupts disabled, so
+ * the queue can be shared with ISRs. Should be "private" functions.
+ */
+bool _avrtos_coro_queue_try_put(struct circular_buffer *queue, char value);
+bool _avrtos_coro_queue_try_get(struct circular_buffer *queue, char *out_value);
+
+/**
+ * Puts the coroutine to sleep for @p delay_us microseconds, trimmed to
+ * @ref AVRTOS_DELAY_MAX_TICKS delay timer ticks. Should be a "private"
+ * function.
+ */
+void _avrtos_coro_delay_us(struct avrtos_coro *coro, uint64_t delay_us);
+
+/**
+ * Creates the coroutine runner task if any coroutine has been created. Should
+ * be a "private" function.
+ */
+void _avrtos_coro_runner_init(void);
+
+/**
+ * Begins the coroutine function body.
+ */
+#define AVRTOS_CORO_BEGIN(Coro) \
+    switch ((Coro)->lc) {       \
+    case 0:
+
+/**
+ * Ends the coroutine function body. The coroutine will not be run again.
+ */
+#define AVRTOS_CORO_END(Coro)                \
+    }                                        \
+    (Coro)->lc = 0;                          \
+    (Coro)->state = AVRTOS_CORO_FINISHED;    \
+    return
+
+/**
+ * Returns control to the coroutine runner. The coroutine will be resumed from
+ * this point during the next round.
+ */
+#define AVRTOS_CORO_YIELD(Coro)   \
+    do {                          \
+        (Coro)->lc = __LINE__;    \
+        return;                   \
+    case __LINE__:;               \
+    } while (0)
+
+/**
+ * Returns control to the coroutine runner until @p Condition is true. The
+ * condition is re-evaluated every time the coroutine is resumed.
+ */
+#define AVRTOS_CORO_WAIT_UNTIL(Coro, Condition) \
+    do {                                        \
+        (Coro)->lc = __LINE__;                  \
+    case __LINE__:                              \
+        if (!(Condition)) {                     \
+            return;                             \
+        }                                       \
+    } while (0)
+
+/**
+ * Non-blocking coroutine delays. Other coroutines are run in the meantime.
+ */
+#define AVRTOS_CORO_DELAY_US(Coro, DelayUs)                 \
+    do {                                                    \
+        _avrtos_coro_delay_us((Coro), (uint64_t)(DelayUs)); \
+        AVRTOS_CORO_YIELD(Coro);                            \
+    } while (0)
+#define AVRTOS_CORO_DELAY_MS(Coro, DelayMs)                          \
+    AVRTOS_CORO_DELAY_US(Coro, (uint64_t)(DelayMs)                   \
+                                       * AVRTOS_MILLISECONDS_TO_MICROSECONDS)
+
+/**
+ * Waits until the semaphore can be taken and takes it.
+ */
+#define AVRTOS_CORO_SEM_TAKE(Coro, Sem) \
+    AVRTOS_CORO_WAIT_UNTIL(Coro, avrtos_coro_sem_try_take(Sem))
+
+/**
+ * Waits until there is space in the queue and inserts @p Value into it.
+ */
+#define AVRTOS_CORO_QUEUE_PUT(Coro, Queue, Value) \
+    AVRTOS_CORO_WAIT_UNTIL(Coro, _avrtos_coro_queue_try_put((Queue), (Value)))
+
+/**
+ * Waits until there is an element in the queue and copies it into the
+ * variable pointed by @p OutValue.
+ */
+#define AVRTOS_CORO_QUEUE_GET(Coro, Queue, OutValue) \
+    AVRTOS_CORO_WAIT_UNTIL(Coro,                     \
+                           _avrtos_coro_queue_try_get((Queue), (OutValue)))
+
+#endif // AVRTOS_WITH_COROUTINES
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_COROUTINE_H_ */
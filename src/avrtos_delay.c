@@ -2,22 +2,39 @@
 
 #include "avrtos_core.h"
 #include "avrtos_delay.h"
+#include "critical_section_arch_ind.h"
+
+#ifdef AVRTOS_WITH_TRACE
+#include "trace_arch_ind.h"
+#endif // AVRTOS_WITH_TRACE
 
 void avrtos_delay_us(uint64_t delay_us) {
     if (delay_us == 0) {
         return;
     }
 
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_DELAY) {
         _avrtos_sched_timer_reset();
     }
     _avrtos_sched_timer_stop();
 
     struct avrtos_task *current = _avrtos_current_task_get();
-    current->delay_until = _avrtos_delay_get_microseconds() + delay_us;
+    current->delay_until = _avrtos_delay_deadline(delay_us);
     current->state = AVRTOS_WAITING;
 
+#ifdef AVRTOS_WITH_TRACE
+    _avrtos_trace_record(AVRTOS_TRACE_DELAY_START, current->id);
+#endif // AVRTOS_WITH_TRACE
+
     _avrtos_sched_timer_resume();
 
     avrtos_task_yield();
 }
+
+avrtos_tick_t _avrtos_delay_deadline(uint64_t timeout_us) {
+    uint64_t ticks = timeout_us / AVRTOS_DELAY_TICK_PERIOD_US;
+    if (ticks > AVRTOS_DELAY_MAX_TICKS) {
+        ticks = AVRTOS_DELAY_MAX_TICKS;
+    }
+    return _avrtos_delay_get_ticks() + (avrtos_tick_t) ticks;
+}
@@ -2,6 +2,7 @@
 #define AVRTOS_DELAY_H_
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 #include "avrtos_config.h"
 #include "boards/avrtos_board_impl.h"
@@ -9,6 +10,12 @@
 #define AVRTOS_SECONDS_TO_MICROSECONDS (1000000)
 #define AVRTOS_MILLISECONDS_TO_MICROSECONDS (1000)
 
+/**
+ * Maximum number of ticks a task can wait. Longer delays are trimmed, so the
+ * wraparound-safe comparison of the tick counter stays valid.
+ */
+#define AVRTOS_DELAY_MAX_TICKS ((avrtos_tick_t) INT32_MAX)
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
@@ -44,12 +51,64 @@ static inline void avrtos_delay_s(uint64_t delay_s) {
 
 /**
  * Returns the number of microseconds that have elapsed since the delay timer
- * was started. Should be a "private" function.
+ * was started. Wraps around together with the delay timer tick counter. Should
+ * be a "private" function.
  */
 static inline uint64_t _avrtos_delay_get_microseconds(void) {
     return avrtos_delay_get_microseconds_impl();
 }
 
+/**
+ * Returns the number of delay timer ticks that have elapsed since the delay
+ * timer was started. Should be a "private" function.
+ */
+static inline avrtos_tick_t _avrtos_delay_get_ticks(void) {
+    return avrtos_delay_get_ticks_impl();
+}
+
+/**
+ * Checks whether the tick counter has already passed the @p tick value. Handles
+ * the counter wraparound. Should be a "private" function.
+ *
+ * @param tick Tick value to compare the current tick counter with.
+ *
+ * @returns true if the current tick counter is greater than @p tick,
+ *          false otherwise.
+ */
+static inline bool _avrtos_delay_tick_has_passed(avrtos_tick_t tick) {
+    return (int32_t)(_avrtos_delay_get_ticks() - tick) > 0;
+}
+
+/**
+ * Converts a timeout into the tick value it expires at. Timeouts longer than
+ * @ref AVRTOS_DELAY_MAX_TICKS are trimmed. Should be a "private" function.
+ *
+ * @param timeout_us Timeout in microseconds, counted from now.
+ *
+ * @returns Tick value to pass to _avrtos_delay_ticks_left().
+ */
+avrtos_tick_t _avrtos_delay_deadline(uint64_t timeout_us);
+
+/**
+ * Returns the number of ticks left until @p deadline. Handles the counter
+ * wraparound. Should be a "private" function.
+ *
+ * @param deadline Tick value returned by _avrtos_delay_deadline().
+ *
+ * @param forever If set, the deadline is ignored and
+ *                @ref AVRTOS_DELAY_MAX_TICKS is returned.
+ *
+ * @returns Number of ticks left, 0 if the deadline has passed.
+ */
+static inline avrtos_tick_t _avrtos_delay_ticks_left(avrtos_tick_t deadline,
+                                                     bool forever) {
+    if (forever) {
+        return AVRTOS_DELAY_MAX_TICKS;
+    }
+    avrtos_tick_t left = deadline - _avrtos_delay_get_ticks();
+    return (int32_t) left > 0 ? left : 0;
+}
+
 /**
  * Initializes delay timer. This function should use
  * @ref AVRTOS_CPU_CLOCK_FREQUENCY. Should be a "private" function.
@@ -0,0 +1,241 @@
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_EEPROM
+
+#include "avrtos_completion.h"
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "avrtos_eeprom.h"
+#include "avrtos_mutex.h"
+#include "avrtos_utils.h"
+#include "critical_section_arch_ind.h"
+#include "typed_ring_buffer_arch_ind.h"
+
+/* first address after the key-value store */
+#define EEPROM_KV_END \
+    (AVRTOS_EEPROM_KV_START + AVRTOS_EEPROM_KV_SLOTS * EEPROM_KV_RECORD_SIZE)
+
+AVRTOS_STATIC_ASSERT(AVRTOS_EEPROM_QUEUE_SIZE >= EEPROM_KV_RECORD_SIZE,
+                     EepromQueueDoesNotHoldKeyValueRecord);
+AVRTOS_STATIC_ASSERT(AVRTOS_EEPROM_KV_SLOTS >= 2
+                             && AVRTOS_EEPROM_KV_SLOTS <= UINT8_MAX
+                             && EEPROM_KV_END <= AVRTOS_EEPROM_SIZE,
+                     EepromKeyValueRegionIsNotValid);
+
+struct eeprom_pending {
+    uint16_t address;
+    uint8_t value;
+};
+
+TYPED_RING_BUFFER_DECLARE(eeprom_queue, struct eeprom_pending);
+
+/* tasks (serialized by g_eeprom_mutex) insert with interrupts disabled,
+   EE_READY_vect takes */
+TYPED_RING_BUFFER_DEFINE(eeprom_queue,
+                         struct eeprom_pending,
+                         g_eeprom_queue,
+                         AVRTOS_EEPROM_QUEUE_SIZE);
+
+/* serializes the writers, the readers and the key-value store */
+AVRTOS_MUTEX_DEFINE(g_eeprom_mutex);
+
+/* set by the tasks when they enable the EEPROM ready interrupt, cleared by
+   EE_READY_vect once the queue has been written */
+static volatile bool g_eeprom_busy;
+
+/* completed by EE_READY_vect whenever a byte leaves the queue, waited for by
+   the task holding g_eeprom_mutex */
+static struct avrtos_completion g_eeprom_progress;
+
+static uint8_t g_eeprom_kv_slot_keys[AVRTOS_EEPROM_KV_SLOTS];
+static struct eeprom_kv g_eeprom_kv;
+
+/**
+ * Sleeps until the queue has @p space free bytes and, if @p idle is set, all
+ * the queued bytes have been written. Has to be called with g_eeprom_mutex
+ * locked, so only EE_READY_vect changes the queue in the meantime.
+ */
+static bool
+eeprom_wait(size_t space, bool idle, avrtos_tick_t deadline, bool forever) {
+    while (true) {
+        avrtos_completion_reset(&g_eeprom_progress);
+        bool ready = false;
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_EEPROM) {
+            ready = eeprom_queue_get_space_left(&g_eeprom_queue) >= space
+                    && !(idle && g_eeprom_busy);
+        }
+        if (ready) {
+            return true;
+        }
+
+        uint64_t timeout_us = AVRTOS_COMPLETION_FOREVER;
+        if (!forever) {
+            avrtos_tick_t left = _avrtos_delay_ticks_left(deadline, false);
+            if (left == 0) {
+                return false;
+            }
+            timeout_us = (uint64_t) left * AVRTOS_DELAY_TICK_PERIOD_US;
+        }
+        if (!avrtos_completion_wait(&g_eeprom_progress, timeout_us)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * Queues bytes that fit into the queue. Has to be called with g_eeprom_mutex
+ * locked.
+ */
+static void eeprom_enqueue(uint16_t address, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        struct eeprom_pending pending = {.address = address + i,
+                                         .value = data[i]};
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_EEPROM) {
+            (void) eeprom_queue_insert_one(&g_eeprom_queue, &pending);
+            if (!g_eeprom_busy) {
+                g_eeprom_busy = true;
+                avrtos_eeprom_ready_enable_impl();
+            }
+        }
+    }
+}
+
+static bool eeprom_fits(uint16_t address, const void *data, size_t len) {
+    return data && address <= AVRTOS_EEPROM_SIZE
+           && len <= (size_t) (AVRTOS_EEPROM_SIZE - address);
+}
+
+size_t avrtos_eeprom_write(uint16_t address,
+                           const void *data,
+                           size_t len,
+                           uint64_t timeout_us) {
+    if (!eeprom_fits(address, data, len)) {
+        return 0;
+    }
+
+    bool forever = timeout_us == AVRTOS_EEPROM_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    const uint8_t *bytes = data;
+    size_t count = 0;
+
+    avrtos_mutex_lock(&g_eeprom_mutex);
+    while (count < len && eeprom_wait(1, false, deadline, forever)) {
+        size_t space = 0;
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_EEPROM) {
+            space = eeprom_queue_get_space_left(&g_eeprom_queue);
+        }
+        size_t chunk = len - count < space ? len - count : space;
+        eeprom_enqueue(address + count, &bytes[count], chunk);
+        count += chunk;
+    }
+    avrtos_mutex_unlock(&g_eeprom_mutex);
+
+    return count;
+}
+
+bool avrtos_eeprom_sync(uint64_t timeout_us) {
+    bool forever = timeout_us == AVRTOS_EEPROM_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+
+    avrtos_mutex_lock(&g_eeprom_mutex);
+    bool done = eeprom_wait(0, true, deadline, forever);
+    avrtos_mutex_unlock(&g_eeprom_mutex);
+
+    return done;
+}
+
+bool avrtos_eeprom_read(uint16_t address,
+                        void *data,
+                        size_t len,
+                        uint64_t timeout_us) {
+    if (!eeprom_fits(address, data, len)) {
+        return false;
+    }
+
+    bool forever = timeout_us == AVRTOS_EEPROM_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    uint8_t *bytes = data;
+
+    avrtos_mutex_lock(&g_eeprom_mutex);
+    /* the EEPROM cannot be read while a byte is being written */
+    bool idle = eeprom_wait(0, true, deadline, forever);
+    if (idle) {
+        for (size_t i = 0; i < len; i++) {
+            bytes[i] = avrtos_eeprom_read_impl(address + i);
+        }
+    }
+    avrtos_mutex_unlock(&g_eeprom_mutex);
+
+    return idle;
+}
+
+enum eeprom_kv_status avrtos_eeprom_kv_put(uint8_t key,
+                                           const void *value,
+                                           uint64_t timeout_us) {
+    if (!value) {
+        return EEPROM_KV_INVALID;
+    }
+
+    bool forever = timeout_us == AVRTOS_EEPROM_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    uint8_t record[EEPROM_KV_RECORD_SIZE];
+    uint16_t address;
+    enum eeprom_kv_status status = EEPROM_KV_TIMEOUT;
+
+    avrtos_mutex_lock(&g_eeprom_mutex);
+    /* the queue only gets emptier while the mutex is locked */
+    if (eeprom_wait(sizeof(record), false, deadline, forever)) {
+        status = eeprom_kv_prepare(&g_eeprom_kv, key, value, &address, record);
+        if (status == EEPROM_KV_OK) {
+            eeprom_enqueue(address, record, sizeof(record));
+        }
+    }
+    avrtos_mutex_unlock(&g_eeprom_mutex);
+
+    return status;
+}
+
+enum eeprom_kv_status
+avrtos_eeprom_kv_get(uint8_t key, void *value, uint64_t timeout_us) {
+    if (!value) {
+        return EEPROM_KV_INVALID;
+    }
+
+    bool forever = timeout_us == AVRTOS_EEPROM_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    enum eeprom_kv_status status = EEPROM_KV_TIMEOUT;
+
+    avrtos_mutex_lock(&g_eeprom_mutex);
+    if (eeprom_wait(0, true, deadline, forever)) {
+        status = eeprom_kv_get(&g_eeprom_kv, key, value);
+    }
+    avrtos_mutex_unlock(&g_eeprom_mutex);
+
+    return status;
+}
+
+void _avrtos_eeprom_init(void) {
+    (void) eeprom_kv_mount(&g_eeprom_kv, AVRTOS_EEPROM_KV_START,
+                           g_eeprom_kv_slot_keys, AVRTOS_EEPROM_KV_SLOTS,
+                           avrtos_eeprom_read_impl);
+}
+
+void _avrtos_eeprom_isr(void) {
+    struct eeprom_pending pending;
+    while (eeprom_queue_get_one(&g_eeprom_queue, &pending) == CIRC_BUFF_OK) {
+        /* bytes that already hold the value are not written, saving wear */
+        if (avrtos_eeprom_read_impl(pending.address) != pending.value) {
+            avrtos_eeprom_write_impl(pending.address, pending.value);
+            avrtos_completion_complete(&g_eeprom_progress);
+            return;
+        }
+    }
+
+    avrtos_eeprom_ready_disable_impl();
+    g_eeprom_busy = false;
+    avrtos_completion_complete(&g_eeprom_progress);
+}
+
+#endif // AVRTOS_WITH_EEPROM
@@ -0,0 +1,137 @@
+#ifndef AVRTOS_EEPROM_H_
+#define AVRTOS_EEPROM_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+#include "eeprom_kv_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_EEPROM
+
+#ifndef AVRTOS_WITH_MUTEX
+#error "AVRTOS_WITH_EEPROM requires AVRTOS_WITH_MUTEX"
+#endif // AVRTOS_WITH_MUTEX
+
+#ifndef AVRTOS_WITH_COMPLETION
+#error "AVRTOS_WITH_EEPROM requires AVRTOS_WITH_COMPLETION"
+#endif // AVRTOS_WITH_COMPLETION
+
+/**
+ * Timeout of the EEPROM functions that never expires.
+ */
+#define AVRTOS_EEPROM_FOREVER UINT64_MAX
+
+/**
+ * Queues @p len bytes to be written from @p address on and returns, the EEPROM
+ * ready interrupt writes them in the background. Sleeps while the queue is
+ * full. Bytes are written in the order they were queued.
+ *
+ * @param address    EEPROM address of the first byte.
+ *
+ * @param data       Bytes to be written, copied to the queue.
+ *
+ * @param len        Number of bytes to write.
+ *
+ * @param timeout_us Maximal time to wait for free space in the queue, 0 to
+ *                   queue only as many bytes as fit at the moment or
+ *                   @ref AVRTOS_EEPROM_FOREVER.
+ *
+ * @returns number of queued bytes (less than @p len on timeout, 0 if the bytes
+ *          do not fit into the EEPROM).
+ */
+size_t avrtos_eeprom_write(uint16_t address,
+                           const void *data,
+                           size_t len,
+                           uint64_t timeout_us);
+
+/**
+ * Sleeps until all the queued bytes have been written.
+ *
+ * @param timeout_us Maximal time to wait or @ref AVRTOS_EEPROM_FOREVER.
+ *
+ * @returns false on timeout.
+ */
+bool avrtos_eeprom_sync(uint64_t timeout_us);
+
+/**
+ * Reads @p len bytes from @p address on. Waits until the queued bytes have
+ * been written first, so the data includes all the previous writes.
+ *
+ * @param address    EEPROM address of the first byte.
+ *
+ * @param data       Destination of the bytes.
+ *
+ * @param len        Number of bytes to read.
+ *
+ * @param timeout_us Maximal time to wait for the queued writes or
+ *                   @ref AVRTOS_EEPROM_FOREVER.
+ *
+ * @returns false on timeout or if the bytes do not fit into the EEPROM.
+ */
+bool avrtos_eeprom_read(uint16_t address,
+                        void *data,
+                        size_t len,
+                        uint64_t timeout_us);
+
+/**
+ * Queues a new value of @p key in the key-value store, like
+ * avrtos_eeprom_write(). The whole record is queued or nothing. After a reset,
+ * the key has either the new value or the previous one. Call
+ * avrtos_eeprom_sync() to wait until the value is stored.
+ *
+ * @param key        Key of the value, 0 to 254.
+ *
+ * @param value      AVRTOS_EEPROM_KV_VALUE_SIZE bytes.
+ *
+ * @param timeout_us Maximal time to wait for free space in the queue or
+ *                   @ref AVRTOS_EEPROM_FOREVER.
+ *
+ * @returns EEPROM_KV_OK on success, EEPROM_KV_FULL if there is no room for a
+ *          new key, EEPROM_KV_TIMEOUT or EEPROM_KV_INVALID.
+ */
+enum eeprom_kv_status avrtos_eeprom_kv_put(uint8_t key,
+                                           const void *value,
+                                           uint64_t timeout_us);
+
+/**
+ * Reads the value of @p key from the key-value store. Waits until the queued
+ * bytes have been written first.
+ *
+ * @param key        Key of the value.
+ *
+ * @param value      Destination of AVRTOS_EEPROM_KV_VALUE_SIZE bytes.
+ *
+ * @param timeout_us Maximal time to wait for the queued writes or
+ *                   @ref AVRTOS_EEPROM_FOREVER.
+ *
+ * @returns EEPROM_KV_OK on success, EEPROM_KV_NOT_FOUND, EEPROM_KV_TIMEOUT or
+ *          EEPROM_KV_INVALID.
+ */
+enum eeprom_kv_status
+avrtos_eeprom_kv_get(uint8_t key, void *value, uint64_t timeout_us);
+
+/**
+ * Loads the index of the key-value store. Should be a "private" function.
+ */
+void _avrtos_eeprom_init(void);
+
+/**
+ * Writes the next queued byte from the EEPROM ready interrupt. Should be a
+ * "private" function.
+ */
+void _avrtos_eeprom_isr(void);
+
+#endif // AVRTOS_WITH_EEPROM
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_EEPROM_H_ */
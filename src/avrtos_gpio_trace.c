@@ -8,15 +8,42 @@
 #include "avrtos_core.h"
 #include "avrtos_gpio_trace.h"
 
-void avrtos_gpio_trace_install(struct avrtos_task *task,
-                               struct avrtos_gpio_trace *gpio_trace) {
-    uint8_t *ddrx_register = gpio_trace->port - AVRTOS_MMIO_DDRX_PORTX_OFFSET;
-    AVRTOS_SET_BIT_IN_REGISTER(*ddrx_register, gpio_trace->pin);
-    task->gpio_trace = gpio_trace;
+/* toggles keep the pin in sync with the traced state only if it starts low */
+static inline void gpio_trace_pin_init(volatile uint8_t *pin_register,
+                                       uint8_t mask) {
+    pin_register[AVRTOS_MMIO_PINX_PORTX_OFFSET] &= (uint8_t) ~mask;
+    pin_register[AVRTOS_MMIO_PINX_DDRX_OFFSET] |= mask;
+}
+
+void _avrtos_gpio_trace_init(void) {
+#ifdef AVRTOS_GPIO_TRACE_ISR_PORT
+    gpio_trace_pin_init(
+            AVRTOS_GPIO_TRACE_PIN_REGISTER(AVRTOS_GPIO_TRACE_ISR_PORT),
+            (uint8_t) (1 << AVRTOS_GPIO_TRACE_ISR_BIT));
+#endif // AVRTOS_GPIO_TRACE_ISR_PORT
+
+#ifdef AVRTOS_GPIO_TRACE_IDLE_PORT
+    gpio_trace_pin_init(
+            AVRTOS_GPIO_TRACE_PIN_REGISTER(AVRTOS_GPIO_TRACE_IDLE_PORT),
+            (uint8_t) (1 << AVRTOS_GPIO_TRACE_IDLE_BIT));
+#endif // AVRTOS_GPIO_TRACE_IDLE_PORT
 }
 
 static void gpio_trace_set(struct avrtos_gpio_trace *gpio_trace) {
-    AVRTOS_SET_BIT_IN_REGISTER(*gpio_trace->port, gpio_trace->pin);
+    *gpio_trace->pin_register = gpio_trace->mask;
+}
+
+void avrtos_gpio_trace_install(struct avrtos_task *task,
+                               struct avrtos_gpio_trace *gpio_trace) {
+    /* the scheduler toggles the pin from here on, so its level has to match
+       the task state before the scheduler can switch tasks */
+    uint8_t key = avrtos_irq_lock_impl();
+    gpio_trace_pin_init(gpio_trace->pin_register, gpio_trace->mask);
+    if (task == _avrtos_current_task_get()) {
+        gpio_trace_set(gpio_trace);
+    }
+    task->gpio_trace = gpio_trace;
+    avrtos_irq_unlock_impl(key);
 }
 
 void _avrtos_gpio_trace_set(struct avrtos_task *task) {
@@ -27,7 +54,7 @@ void _avrtos_gpio_trace_set(struct avrtos_task *task) {
 }
 
 static void gpio_trace_clear(struct avrtos_gpio_trace *gpio_trace) {
-    AVRTOS_CLEAR_BIT_IN_REGISTER(*gpio_trace->port, gpio_trace->pin);
+    *gpio_trace->pin_register = gpio_trace->mask;
 }
 
 void _avrtos_gpio_trace_clear(struct avrtos_task *task) {
@@ -38,3 +65,43 @@ void _avrtos_gpio_trace_clear(struct avrtos_task *task) {
 }
 
 #endif // AVRTOS_WITH_GPIO_TRACE
+
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#include "avrtos_gpio_trace.h"
+
+#define ENCODED_PORT AVRTOS_CONCAT(PORT, AVRTOS_GPIO_TRACE_ENCODED_PORT)
+#define ENCODED_DDR AVRTOS_CONCAT(DDR, AVRTOS_GPIO_TRACE_ENCODED_PORT)
+#define ENCODED_MASK                             \
+    (((1 << AVRTOS_GPIO_TRACE_ENCODED_BITS) - 1) \
+     << AVRTOS_GPIO_TRACE_ENCODED_FIRST_BIT)
+
+/* code of the running task, restored when an interrupt handler exits */
+static uint8_t g_gpio_trace_task_code;
+
+static inline void gpio_trace_encoded_write(uint8_t code) {
+    /* port and mask are compile-time constants: in, andi, or, out */
+    ENCODED_PORT = (ENCODED_PORT & (uint8_t) ~ENCODED_MASK)
+                   | ((uint8_t)(code << AVRTOS_GPIO_TRACE_ENCODED_FIRST_BIT)
+                      & ENCODED_MASK);
+}
+
+void _avrtos_gpio_trace_encoded_init(void) {
+    ENCODED_DDR |= ENCODED_MASK;
+    gpio_trace_encoded_write(AVRTOS_GPIO_TRACE_CODE_IDLE);
+}
+
+void _avrtos_gpio_trace_encoded_set(uint8_t code) {
+    g_gpio_trace_task_code = code;
+    gpio_trace_encoded_write(code);
+}
+
+void _avrtos_gpio_trace_encoded_isr_enter(void) {
+    gpio_trace_encoded_write(AVRTOS_GPIO_TRACE_CODE_ISR);
+}
+
+void _avrtos_gpio_trace_encoded_isr_exit(void) {
+    gpio_trace_encoded_write(g_gpio_trace_task_code);
+}
+
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
@@ -5,14 +5,20 @@
 #include <stdlib.h>
 
 #include "avrtos_init.h"
+#include "avrtos_utils.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
 
+/**
+ * Task GPIO trace pin. The pin is toggled through its PINx register, so both
+ * fields are resolved when the struct is defined and a task switch edge is a
+ * single store.
+ */
 struct avrtos_gpio_trace {
-    uint8_t *port;
-    uint8_t pin;
+    volatile uint8_t *pin_register;
+    uint8_t mask;
 };
 
 /**
@@ -92,6 +98,30 @@ struct avrtos_gpio_trace {
 #define AVRTOS_GPIO_TRACE_ADDRESS_D AVRTOS_GPIO_TRACE_ADDRESS_PORTD
 #define AVRTOS_GPIO_TRACE_ADDRESS_E AVRTOS_GPIO_TRACE_ADDRESS_PORTE
 
+/**
+ * SRAM address of the PINx register of a port. Writing a one to a bit of PINx
+ * toggles the same bit of PORTx.
+ *
+ * @param PortName Name of the GPIO Port (e.g. B or PORTB).
+ */
+#define AVRTOS_GPIO_TRACE_PIN_REGISTER(PortName)         \
+    (AVRTOS_CONCAT(AVRTOS_GPIO_TRACE_ADDRESS_, PortName) \
+     - AVRTOS_MMIO_PINX_PORTX_OFFSET)
+
+/**
+ * Toggles a GPIO pin by writing its PINx register. Port and pin are
+ * compile-time constants, so the toggle compiles to one or two instructions
+ * and does not need a read-modify-write of PORTx. Can be used as a trace point
+ * anywhere, including ISRs.
+ *
+ * @param PortName  Name of the GPIO Port (e.g. B or PORTB).
+ *
+ * @param PinNumber Number of GPIO Pin.
+ */
+#define AVRTOS_GPIO_TRACE_TOGGLE(PortName, PinNumber)                 \
+    (*(volatile uint8_t *) AVRTOS_GPIO_TRACE_PIN_REGISTER(PortName) = \
+             (uint8_t) (1 << (PinNumber)))
+
 /**
  * Simple gpio_trace struct definition.
  *
@@ -106,8 +136,8 @@ struct avrtos_gpio_trace {
 #define AVRTOS_GPIO_TRACE_DEFINE(TraceName, PortName, PinNumber)              \
     AVRTOS_STATIC_ASSERT(PinNumber >= 0 && PinNumber <= 7, InvalidPinNumber); \
     struct avrtos_gpio_trace TraceName = {                                    \
-            .port = AVRTOS_CONCAT(AVRTOS_GPIO_TRACE_ADDRESS_, PortName),      \
-            .pin = PinNumber}
+            .pin_register = AVRTOS_GPIO_TRACE_PIN_REGISTER(PortName),         \
+            .mask = (uint8_t) (1 << (PinNumber))}
 #else // AVRTOS_WITH_GPIO_TRACE
 #define AVRTOS_GPIO_TRACE_DEFINE(...)
 #endif // AVRTOS_WITH_GPIO_TRACE
@@ -169,7 +199,9 @@ struct avrtos_gpio_trace {
 struct avrtos_task;
 
 /**
- * Links gpio_trace struct to specified task.
+ * Links gpio_trace struct to specified task. The pin is driven high if the task
+ * is the running one and low otherwise, so it can also be called after
+ * avrtos_scheduler_start().
  *
  * @param task       Name of the avrtos task that the gpio_trace struct should
  *                   be associated with.
@@ -187,16 +219,95 @@ void avrtos_gpio_trace_install(struct avrtos_task *task,
 #endif // AVRTOS_WITH_GPIO_TRACE
 
 /**
- * Sets/clears specified task's gpio_trace pin if specified. Should be a
- * "private" function.
+ * Sets/clears specified task's gpio_trace pin if specified. Both toggle the
+ * pin, so calls should alternate starting with a set. Should be a "private"
+ * function.
  *
  * @param Task which GPIO pin should be set/cleared.
  */
 #ifdef AVRTOS_WITH_GPIO_TRACE
 void _avrtos_gpio_trace_set(struct avrtos_task *task);
 void _avrtos_gpio_trace_clear(struct avrtos_task *task);
+
+#ifdef AVRTOS_GPIO_TRACE_ISR_PORT
+AVRTOS_STATIC_ASSERT(AVRTOS_GPIO_TRACE_ISR_BIT >= 0
+                             && AVRTOS_GPIO_TRACE_ISR_BIT <= 7,
+                     InvalidIsrGpioTracePinNumber);
+
+/**
+ * Toggles the ISR trace pin. Called on entry and exit of handlers defined with
+ * AVRTOS_ISR(). Should be a "private" macro.
+ */
+#define _AVRTOS_GPIO_TRACE_ISR_TOGGLE()                  \
+    AVRTOS_GPIO_TRACE_TOGGLE(AVRTOS_GPIO_TRACE_ISR_PORT, \
+                             AVRTOS_GPIO_TRACE_ISR_BIT)
+#endif // AVRTOS_GPIO_TRACE_ISR_PORT
+
+#ifdef AVRTOS_GPIO_TRACE_IDLE_PORT
+AVRTOS_STATIC_ASSERT(AVRTOS_GPIO_TRACE_IDLE_BIT >= 0
+                             && AVRTOS_GPIO_TRACE_IDLE_BIT <= 7,
+                     InvalidIdleGpioTracePinNumber);
+
+/**
+ * Toggles the idle trace pin. Called when the idle task is switched in or out.
+ * Should be a "private" macro.
+ */
+#define _AVRTOS_GPIO_TRACE_IDLE_TOGGLE()                  \
+    AVRTOS_GPIO_TRACE_TOGGLE(AVRTOS_GPIO_TRACE_IDLE_PORT, \
+                             AVRTOS_GPIO_TRACE_IDLE_BIT)
+#endif // AVRTOS_GPIO_TRACE_IDLE_PORT
+
+/**
+ * Configures the ISR and idle trace pins as low outputs. Should be a "private"
+ * function.
+ */
+void _avrtos_gpio_trace_init(void);
+
 #endif // AVRTOS_WITH_GPIO_TRACE
 
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+AVRTOS_STATIC_ASSERT(AVRTOS_GPIO_TRACE_ENCODED_BITS >= 2,
+                     EncodedGpioTraceNeedsTwoBits);
+AVRTOS_STATIC_ASSERT(AVRTOS_GPIO_TRACE_ENCODED_FIRST_BIT >= 0
+                             && AVRTOS_GPIO_TRACE_ENCODED_FIRST_BIT
+                                        + AVRTOS_GPIO_TRACE_ENCODED_BITS
+                                <= 8,
+                     EncodedGpioTraceBitsDoNotFitInPort);
+
+/**
+ * Codes written to the encoded GPIO trace bits. Tasks use their IDs, tasks with
+ * IDs above @ref AVRTOS_GPIO_TRACE_CODE_MAX_TASK share that code.
+ */
+#define AVRTOS_GPIO_TRACE_CODE_IDLE 0
+#define AVRTOS_GPIO_TRACE_CODE_ISR ((1 << AVRTOS_GPIO_TRACE_ENCODED_BITS) - 1)
+#define AVRTOS_GPIO_TRACE_CODE_MAX_TASK (AVRTOS_GPIO_TRACE_CODE_ISR - 1)
+
+/**
+ * Configures the encoded GPIO trace bits as outputs. Should be a "private"
+ * function.
+ */
+void _avrtos_gpio_trace_encoded_init(void);
+
+/**
+ * Writes the code of the task that is about to run to the encoded GPIO trace
+ * bits with a single masked write. Should be called with interrupts disabled.
+ * Should be a "private" function.
+ *
+ * @param code Code of the task (see AVRTOS_GPIO_TRACE_CODE_IDLE).
+ */
+void _avrtos_gpio_trace_encoded_set(uint8_t code);
+
+/**
+ * Writes the ISR code on interrupt entry and restores the task code on exit.
+ * Called by handlers defined with AVRTOS_ISR(). Should be a "private"
+ * function.
+ */
+void _avrtos_gpio_trace_encoded_isr_enter(void);
+void _avrtos_gpio_trace_encoded_isr_exit(void);
+
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
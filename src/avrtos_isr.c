@@ -0,0 +1,90 @@
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_INTERRUPT_STACK
+
+#include "avrtos_isr.h"
+
+uint8_t g_isr_stack[AVRTOS_INTERRUPT_STACK_SIZE];
+volatile uint8_t g_isr_nesting = 0;
+volatile uint16_t g_isr_task_sp;
+
+void _avrtos_isr_common(void) __attribute__((naked, used));
+void _avrtos_isr_common(void) {
+    /* r30, SREG and r31 have already been pushed onto the current stack by the
+       vector stub, Z register holds the address of the handler body */
+    __asm__ volatile(
+            "push r28 \n\t"
+            "push r29 \n\t"
+            /* increment nesting level, switch SP to the interrupt stack on the
+               outermost entry */
+            "lds r28, g_isr_nesting \n\t"
+            "inc r28 \n\t"
+            "sts g_isr_nesting, r28 \n\t"
+            "cpi r28, 1 \n\t"
+            "brne 1f \n\t"
+            "in r28, __SP_L__ \n\t"
+            "in r29, __SP_H__ \n\t"
+            "sts g_isr_task_sp, r28 \n\t"
+            "sts g_isr_task_sp + 1, r29 \n\t"
+            "ldi r28, lo8(g_isr_stack + %0) \n\t"
+            "ldi r29, hi8(g_isr_stack + %0) \n\t"
+            "out __SP_H__, r29 \n\t"
+            "out __SP_L__, r28 \n\t"
+            "1: \n\t"
+            /* save call-clobbered registers on the interrupt stack, r28 and r29
+               are preserved by the handler body itself */
+            "push r0 \n\t"
+            "push r1 \n\t"
+            "clr __zero_reg__ \n\t"
+            "push r18 \n\t"
+            "push r19 \n\t"
+            "push r20 \n\t"
+            "push r21 \n\t"
+            "push r22 \n\t"
+            "push r23 \n\t"
+            "push r24 \n\t"
+            "push r25 \n\t"
+            "push r26 \n\t"
+            "push r27 \n\t"
+            "icall \n\t"
+            "pop r27 \n\t"
+            "pop r26 \n\t"
+            "pop r25 \n\t"
+            "pop r24 \n\t"
+            "pop r23 \n\t"
+            "pop r22 \n\t"
+            "pop r21 \n\t"
+            "pop r20 \n\t"
+            "pop r19 \n\t"
+            "pop r18 \n\t"
+            "pop r1 \n\t"
+            "pop r0 \n\t"
+            /* handler body should not enable interrupts, make sure anyway */
+            "cli \n\t"
+            /* decrement nesting level, switch SP back to the interrupted
+               task's stack on the outermost exit */
+            "lds r28, g_isr_nesting \n\t"
+            "dec r28 \n\t"
+            "sts g_isr_nesting, r28 \n\t"
+            "brne 2f \n\t"
+            "lds r28, g_isr_task_sp \n\t"
+            "lds r29, g_isr_task_sp + 1 \n\t"
+            "out __SP_H__, r29 \n\t"
+            "out __SP_L__, r28 \n\t"
+            "2: \n\t"
+            "pop r29 \n\t"
+            "pop r28 \n\t"
+            "pop r31 \n\t"
+            "pop r30 \n\t"
+            "out __SREG__, r30 \n\t"
+            "pop r30 \n\t"
+            "reti \n\t"
+            ""
+            :
+            : "i"(AVRTOS_INTERRUPT_STACK_SIZE - 1));
+}
+
+#endif // AVRTOS_WITH_INTERRUPT_STACK
@@ -0,0 +1,148 @@
+#ifndef AVRTOS_ISR_H_
+#define AVRTOS_ISR_H_
+
+#include <avr/interrupt.h>
+#include <inttypes.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+
+#ifdef AVRTOS_WITH_TRACE
+#include "trace_arch_ind.h"
+#endif // AVRTOS_WITH_TRACE
+
+#if defined(AVRTOS_WITH_GPIO_TRACE) || defined(AVRTOS_WITH_GPIO_TRACE_ENCODED)
+#include "avrtos_gpio_trace.h"
+#endif // AVRTOS_WITH_GPIO_TRACE || AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_TRACE
+#define _AVRTOS_ISR_TRACE_ENTER(Number) \
+    _avrtos_trace_record(AVRTOS_TRACE_ISR_ENTER, Number);
+#define _AVRTOS_ISR_TRACE_EXIT(Number) \
+    _avrtos_trace_record(AVRTOS_TRACE_ISR_EXIT, Number);
+#else // AVRTOS_WITH_TRACE
+#define _AVRTOS_ISR_TRACE_ENTER(Number)
+#define _AVRTOS_ISR_TRACE_EXIT(Number)
+#endif // AVRTOS_WITH_TRACE
+
+#ifdef AVRTOS_WITH_GPIO_TRACE_ENCODED
+#define _AVRTOS_ISR_GPIO_TRACE_ENTER() _avrtos_gpio_trace_encoded_isr_enter();
+#define _AVRTOS_ISR_GPIO_TRACE_EXIT() _avrtos_gpio_trace_encoded_isr_exit();
+#else // AVRTOS_WITH_GPIO_TRACE_ENCODED
+#define _AVRTOS_ISR_GPIO_TRACE_ENTER()
+#define _AVRTOS_ISR_GPIO_TRACE_EXIT()
+#endif // AVRTOS_WITH_GPIO_TRACE_ENCODED
+
+#if defined(AVRTOS_WITH_GPIO_TRACE) && defined(AVRTOS_GPIO_TRACE_ISR_PORT)
+#define _AVRTOS_ISR_GPIO_TRACE_TOGGLE() _AVRTOS_GPIO_TRACE_ISR_TOGGLE();
+#define _AVRTOS_ISR_WITH_GPIO_TRACE_TOGGLE
+#else // AVRTOS_WITH_GPIO_TRACE && AVRTOS_GPIO_TRACE_ISR_PORT
+#define _AVRTOS_ISR_GPIO_TRACE_TOGGLE()
+#endif // AVRTOS_WITH_GPIO_TRACE && AVRTOS_GPIO_TRACE_ISR_PORT
+
+#if defined(AVRTOS_WITH_TRACE) || defined(AVRTOS_WITH_GPIO_TRACE_ENCODED) \
+        || defined(_AVRTOS_ISR_WITH_GPIO_TRACE_TOGGLE)
+#define _AVRTOS_ISR_WITH_HOOKS
+#endif // AVRTOS_WITH_TRACE || AVRTOS_WITH_GPIO_TRACE_*
+
+#ifdef _AVRTOS_ISR_WITH_HOOKS
+
+#define _AVRTOS_ISR_HOOKED_BODY(Vector) \
+    AVRTOS_CONCAT(_avrtos_isr_hooked_body, Vector)
+
+/**
+ * Defines @p Entry, which runs the ISR entry and exit hooks (ISR trace pin,
+ * event trace, encoded GPIO trace) around the handler body that follows. The
+ * trace pin toggles first and last to keep the pulse close to the handler
+ * duration. @p Number is the interrupt vector number.
+ */
+#define _AVRTOS_ISR_HOOKED(Vector, Number, Entry)                  \
+    static inline void _AVRTOS_ISR_HOOKED_BODY(Vector)(void)       \
+            __attribute__((always_inline));                        \
+    Entry {                                                        \
+        _AVRTOS_ISR_GPIO_TRACE_TOGGLE()                            \
+        _AVRTOS_ISR_GPIO_TRACE_ENTER()                             \
+        _AVRTOS_ISR_TRACE_ENTER(Number)                            \
+        _AVRTOS_ISR_HOOKED_BODY(Vector)();                         \
+        _AVRTOS_ISR_TRACE_EXIT(Number)                             \
+        _AVRTOS_ISR_GPIO_TRACE_EXIT()                              \
+        _AVRTOS_ISR_GPIO_TRACE_TOGGLE()                            \
+    }                                                              \
+    static inline void _AVRTOS_ISR_HOOKED_BODY(Vector)(void)
+
+#endif // _AVRTOS_ISR_WITH_HOOKS
+
+#ifdef AVRTOS_WITH_INTERRUPT_STACK
+
+/**
+ * Number of bytes an ISR defined with @ref AVRTOS_ISR pushes onto the
+ * interrupted task's stack: return address, r30, SREG, r31, r28 and r29.
+ */
+#define AVRTOS_INTERRUPT_STACK_TASK_FRAME_SIZE 7
+
+#define _AVRTOS_ISR_BODY(Vector) AVRTOS_CONCAT(_avrtos_isr_body, Vector)
+
+#ifdef _AVRTOS_ISR_WITH_HOOKS
+#define _AVRTOS_ISR_BODY_DEFINE(Vector, Number) \
+    _AVRTOS_ISR_HOOKED(Vector, Number,         \
+                       static void _AVRTOS_ISR_BODY(Vector)(void))
+#else // _AVRTOS_ISR_WITH_HOOKS
+#define _AVRTOS_ISR_BODY_DEFINE(Vector, Number) \
+    static void _AVRTOS_ISR_BODY(Vector)(void)
+#endif // _AVRTOS_ISR_WITH_HOOKS
+
+/**
+ * Defines an interrupt handler that runs on the dedicated interrupt stack. The
+ * naked vector stub saves Z register and SREG, loads the handler body address
+ * into Z register and jumps to the common prologue, which switches SP to the
+ * interrupt stack on the outermost entry and switches it back on exit.
+ *
+ * The handler body is a regular C function, so it should not enable
+ * interrupts. Should not be used for the scheduler's interrupt. With
+ * AVRTOS_WITH_TRACE, AVRTOS_WITH_GPIO_TRACE_ENCODED or
+ * AVRTOS_GPIO_TRACE_ISR_PORT, the handler records its entry and exit.
+ *
+ * @param Vector Interrupt vector name (e.g. USART_UDRE_vect).
+ */
+#define AVRTOS_ISR(Vector)                                                \
+    static void _AVRTOS_ISR_BODY(Vector)(void) __attribute__((used));     \
+    ISR(Vector, ISR_NAKED) {                                              \
+        __asm__ volatile("push r30 \n\t"                                  \
+                         "in r30, __SREG__ \n\t"                          \
+                         "push r30 \n\t"                                  \
+                         "push r31 \n\t"                                  \
+                         "ldi r30, lo8(gs(%x0)) \n\t"                     \
+                         "ldi r31, hi8(gs(%x0)) \n\t"                     \
+                         "jmp _avrtos_isr_common \n\t"                    \
+                         ""                                               \
+                         :                                                \
+                         : "i"(_AVRTOS_ISR_BODY(Vector)));                \
+    }                                                                     \
+    _AVRTOS_ISR_BODY_DEFINE(Vector, Vector##_num)
+
+/**
+ * Common prologue and epilogue of all @ref AVRTOS_ISR handlers. Should be a
+ * "private" function and should never be called directly.
+ */
+void _avrtos_isr_common(void);
+
+#else // AVRTOS_WITH_INTERRUPT_STACK
+
+#ifdef _AVRTOS_ISR_WITH_HOOKS
+/* Vector##_num is pasted before Vector expands to the vector function name */
+#define AVRTOS_ISR(Vector) _AVRTOS_ISR_HOOKED(Vector, Vector##_num, ISR(Vector))
+#else // _AVRTOS_ISR_WITH_HOOKS
+#define AVRTOS_ISR(Vector) ISR(Vector)
+#endif // _AVRTOS_ISR_WITH_HOOKS
+
+#endif // AVRTOS_WITH_INTERRUPT_STACK
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_ISR_H_ */
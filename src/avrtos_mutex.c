@@ -3,6 +3,11 @@
 #include "avrtos_config.h"
 #include "avrtos_core.h"
 #include "avrtos_mutex.h"
+#include "critical_section_arch_ind.h"
+
+#ifdef AVRTOS_WITH_TRACE
+#include "trace_arch_ind.h"
+#endif // AVRTOS_WITH_TRACE
 
 #ifdef AVRTOS_WITH_MUTEX
 static bool mutex_is_locked(struct avrtos_mutex *mutex) {
@@ -15,26 +20,44 @@ static bool current_task_locked_the_mutex(struct avrtos_mutex *mutex) {
 }
 
 bool avrtos_mutex_lock(struct avrtos_mutex *mutex) {
+#ifdef AVRTOS_WITH_TRACE
+    bool blocked = false;
+#endif // AVRTOS_WITH_TRACE
+
     while (true) {
-        ATOMIC_BLOCK(ATOMIC_FORCEON) {
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_MUTEX_LOCK) {
             if (!mutex_is_locked(mutex)) {
                 mutex->locked = true;
                 mutex->task_id = _avrtos_current_task_id();
                 goto locked;
             }
         }
+#ifdef AVRTOS_WITH_TRACE
+        if (!blocked) {
+            _avrtos_trace_record(AVRTOS_TRACE_MUTEX_BLOCK,
+                                 (uint8_t)(uintptr_t) mutex);
+            blocked = true;
+        }
+#endif // AVRTOS_WITH_TRACE
         avrtos_task_yield();
     }
 
 locked:
+#ifdef AVRTOS_WITH_TRACE
+    _avrtos_trace_record(AVRTOS_TRACE_MUTEX_LOCK, (uint8_t)(uintptr_t) mutex);
+#endif // AVRTOS_WITH_TRACE
     return true;
 }
 
 bool avrtos_mutex_unlock(struct avrtos_mutex *mutex) {
-    ATOMIC_BLOCK(ATOMIC_FORCEON) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_MUTEX_UNLOCK) {
         if (current_task_locked_the_mutex(mutex) && mutex_is_locked(mutex)) {
             mutex->locked = false;
             mutex->task_id = AVRTOS_INVALID_TASK_ID;
+#ifdef AVRTOS_WITH_TRACE
+            _avrtos_trace_record(AVRTOS_TRACE_MUTEX_UNLOCK,
+                                 (uint8_t)(uintptr_t) mutex);
+#endif // AVRTOS_WITH_TRACE
             return true;
         }
     }
@@ -0,0 +1,250 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_SHELL
+
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "avrtos_logger.h"
+#include "avrtos_shell.h"
+
+#ifdef AVRTOS_WITH_TRACE
+#include "trace_arch_ind.h"
+#endif // AVRTOS_WITH_TRACE
+
+#define SHELL_MAX_ARGS 3
+
+/* delay timer ticks per millisecond, the tick period divides a millisecond */
+#define SHELL_TICKS_PER_MS \
+    (AVRTOS_MILLISECONDS_TO_MICROSECONDS / AVRTOS_DELAY_TICK_PERIOD_US)
+
+struct avrtos_task _shell_task;
+AVRTOS_STACK_DEFINE(_shell_stack, AVRTOS_SHELL_STACK_SIZE);
+
+/* only touched by the shell task */
+static char g_shell_line[AVRTOS_SHELL_LINE_MAX_SIZE];
+static uint8_t g_shell_line_len;
+static bool g_shell_line_too_long;
+static bool g_shell_last_cr;
+static char g_shell_output[AVRTOS_SINGLE_LOG_MAX_SIZE];
+
+static const char g_shell_state_names[][6] AVRTOS_PROGMEM = {"new", "ready",
+                                                             "wait", "run"};
+static const char g_shell_level_names[][8] AVRTOS_PROGMEM = {
+        "error", "warning", "info", "debug"};
+
+/**
+ * Formats the answer and appends it to the log buffer, waits until the USART
+ * has sent enough data. Answers longer than AVRTOS_SINGLE_LOG_MAX_SIZE - 1 are
+ * trimmed.
+ */
+static void shell_print_P(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf_P(g_shell_output, sizeof(g_shell_output), fmt, args);
+    va_end(args);
+    if (len <= 0) {
+        return;
+    }
+    if ((size_t) len >= sizeof(g_shell_output)) {
+        len = sizeof(g_shell_output) - 1;
+    }
+
+    avrtos_log_lock_impl();
+    (void) avrtos_log_write_impl(g_shell_output, (size_t) len, true);
+    avrtos_log_unlock_impl();
+}
+
+static void shell_ps(void) {
+    struct avrtos_task *iterator = NULL;
+    struct avrtos_task_info info;
+    char state[sizeof(g_shell_state_names[0])];
+
+    shell_print_P(PSTR("ID STATE DELAY_MS\n"));
+    while (avrtos_task_info_next(&iterator, &info)) {
+        strcpy_P(state, g_shell_state_names[info.state]);
+        shell_print_P(PSTR("%2u %-5s %lu%s\n"), info.id, state,
+                      (unsigned long) (info.delay_remaining
+                                       / SHELL_TICKS_PER_MS),
+                      info.idle ? " idle" : "");
+    }
+}
+
+static void shell_top(void) {
+    struct avrtos_task *iterator = NULL;
+    struct avrtos_task_info info;
+    avrtos_tick_t total = 0;
+    uint8_t shift = 0;
+
+    while (avrtos_task_info_next(&iterator, &info)) {
+        total += info.cpu_ticks;
+    }
+
+    shell_print_P(PSTR("ID CPU%% (last %lu ms)\n"),
+                  (unsigned long) (total / SHELL_TICKS_PER_MS));
+    /* scale the ticks down so the percentage fits in 32 bits */
+    while (total > UINT32_MAX / 100) {
+        total >>= 1;
+        shift++;
+    }
+    iterator = NULL;
+    while (avrtos_task_info_next(&iterator, &info)) {
+        unsigned int percent =
+                total ? (unsigned int) ((info.cpu_ticks >> shift) * 100 / total)
+                      : 0;
+        shell_print_P(PSTR("%2u %3u%s\n"), info.id, percent,
+                      info.idle ? " idle" : "");
+    }
+
+    /* the next top shows the CPU usage since this one */
+    avrtos_task_cpu_ticks_reset();
+}
+
+static void shell_stack(void) {
+    struct avrtos_task *iterator = NULL;
+    struct avrtos_task_info info;
+
+    shell_print_P(PSTR("ID USED SIZE\n"));
+    while (avrtos_task_info_next(&iterator, &info)) {
+        /* a fully used stack has most likely overflowed */
+        shell_print_P(PSTR("%2u %4u %4u%s\n"), info.id, info.stack_used,
+                      info.stack_size,
+                      info.stack_used >= info.stack_size ? " overflow" : "");
+    }
+}
+
+static void shell_log_level(const char *name) {
+    if (name) {
+        uint8_t level = 0;
+        while (level < AVRTOS_LOG_LEVELS_COUNT
+               && strcmp_P(name, g_shell_level_names[level]) != 0) {
+            level++;
+        }
+        if (level == AVRTOS_LOG_LEVELS_COUNT) {
+            shell_print_P(PSTR("unknown level %s\n"), name);
+            return;
+        }
+        avrtos_log_set_level((enum avrtos_log_level) level);
+    }
+
+    char current[sizeof(g_shell_level_names[0])];
+    strcpy_P(current, g_shell_level_names[avrtos_log_get_level()]);
+    shell_print_P(PSTR("log level %s\n"), current);
+}
+
+static void shell_help(void) {
+    shell_print_P(PSTR("ps, top, stack, log level [name]"));
+#ifdef AVRTOS_WITH_TRACE
+    shell_print_P(PSTR(", trace dump"));
+#endif // AVRTOS_WITH_TRACE
+    shell_print_P(PSTR("\n"));
+}
+
+/**
+ * Splits the line into space-separated arguments in place. Returns
+ * SHELL_MAX_ARGS + 1 if there are more arguments than fit in @p argv.
+ */
+static uint8_t shell_split(char *line, char **argv) {
+    uint8_t argc = 0;
+    while (true) {
+        while (*line == ' ') {
+            *line++ = '\0';
+        }
+        if (!*line) {
+            return argc;
+        }
+        if (argc == SHELL_MAX_ARGS) {
+            return SHELL_MAX_ARGS + 1;
+        }
+        argv[argc++] = line;
+        while (*line && *line != ' ') {
+            line++;
+        }
+    }
+}
+
+static void shell_execute(char *line) {
+    char *argv[SHELL_MAX_ARGS] = {NULL};
+    uint8_t argc = shell_split(line, argv);
+
+    if (argc == 0) {
+        return;
+    }
+    if (argc > SHELL_MAX_ARGS) {
+        shell_print_P(PSTR("too many arguments\n"));
+    } else if (argc == 1 && strcmp_P(argv[0], PSTR("ps")) == 0) {
+        shell_ps();
+    } else if (argc == 1 && strcmp_P(argv[0], PSTR("top")) == 0) {
+        shell_top();
+    } else if (argc == 1 && strcmp_P(argv[0], PSTR("stack")) == 0) {
+        shell_stack();
+    } else if (argc >= 2 && strcmp_P(argv[0], PSTR("log")) == 0
+               && strcmp_P(argv[1], PSTR("level")) == 0) {
+        shell_log_level(argv[2]);
+#ifdef AVRTOS_WITH_TRACE
+    } else if (argc == 2 && strcmp_P(argv[0], PSTR("trace")) == 0
+               && strcmp_P(argv[1], PSTR("dump")) == 0) {
+        avrtos_trace_dump();
+#endif // AVRTOS_WITH_TRACE
+    } else if (argc == 1 && strcmp_P(argv[0], PSTR("help")) == 0) {
+        shell_help();
+    } else {
+        shell_print_P(PSTR("unknown command, try help\n"));
+    }
+}
+
+static void shell_handle_char(char c) {
+    /* "\r\n" ends a single line */
+    bool after_cr = g_shell_last_cr;
+    g_shell_last_cr = c == '\r';
+    if (c == '\n' && after_cr) {
+        return;
+    }
+
+    if (c == '\r' || c == '\n') {
+        shell_print_P(PSTR("\n"));
+        if (g_shell_line_too_long) {
+            shell_print_P(PSTR("line too long\n"));
+        } else {
+            g_shell_line[g_shell_line_len] = '\0';
+            shell_execute(g_shell_line);
+        }
+        g_shell_line_len = 0;
+        g_shell_line_too_long = false;
+        shell_print_P(PSTR("> "));
+    } else if (c == '\b' || c == 0x7F) {
+        if (g_shell_line_len > 0) {
+            g_shell_line_len--;
+            shell_print_P(PSTR("\b \b"));
+        }
+    } else if (g_shell_line_len < sizeof(g_shell_line) - 1) {
+        g_shell_line[g_shell_line_len++] = c;
+        shell_print_P(PSTR("%c"), c);
+    } else {
+        g_shell_line_too_long = true;
+    }
+}
+
+static void _shell_thread(void *arg) {
+    (void) arg;
+    shell_print_P(PSTR("> "));
+    while (1) {
+        char c;
+        while (avrtos_shell_getc_impl(&c)) {
+            shell_handle_char(c);
+        }
+        /* other tasks run until the next characters arrive */
+        avrtos_delay_ms(AVRTOS_SHELL_POLL_PERIOD_MS);
+    }
+}
+
+void _avrtos_shell_init(void) {
+    (void) avrtos_task_create(&_shell_task, _shell_thread, _shell_stack,
+                              sizeof(_shell_stack), NULL);
+    avrtos_shell_rx_init_impl();
+}
+
+#endif // AVRTOS_WITH_SHELL
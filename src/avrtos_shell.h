@@ -0,0 +1,34 @@
+#ifndef AVRTOS_SHELL_H_
+#define AVRTOS_SHELL_H_
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_SHELL
+
+#ifndef AVRTOS_WITH_INTROSPECTION
+#error "AVRTOS_WITH_SHELL requires AVRTOS_WITH_INTROSPECTION"
+#endif // AVRTOS_WITH_INTROSPECTION
+
+/* the shell answers in text, it would corrupt the binary log stream */
+#ifdef AVRTOS_WITH_BINARY_LOGGER
+#error "AVRTOS_WITH_SHELL cannot be combined with AVRTOS_WITH_BINARY_LOGGER"
+#endif // AVRTOS_WITH_BINARY_LOGGER
+
+/**
+ * Creates the shell task and enables the USART receiver. Has to be called after
+ * the logger has been initialized. Should be a "private" function.
+ */
+void _avrtos_shell_init(void);
+
+#endif // AVRTOS_WITH_SHELL
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_SHELL_H_ */
@@ -0,0 +1,80 @@
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_SPI
+
+#include "avrtos_completion.h"
+#include "avrtos_core.h"
+#include "avrtos_mutex.h"
+#include "avrtos_spi.h"
+#include "critical_section_arch_ind.h"
+
+/* serializes the devices on the bus, held from avrtos_spi_acquire() to
+   avrtos_spi_release() */
+AVRTOS_MUTEX_DEFINE(g_spi_mutex);
+
+/* the transfer in progress, set up by the task holding the bus while the SPI
+   interrupt is disabled, then moved forward by SPI_STC_vect */
+static const uint8_t *g_spi_tx;
+static uint8_t *g_spi_rx;
+static size_t g_spi_len;
+static volatile size_t g_spi_count;
+static struct avrtos_completion g_spi_done;
+
+void avrtos_spi_acquire(const struct avrtos_spi_config *config) {
+    avrtos_mutex_lock(&g_spi_mutex);
+    avrtos_spi_configure_impl(config->frequency, config->mode,
+                              config->lsb_first);
+}
+
+void avrtos_spi_release(void) {
+    avrtos_mutex_unlock(&g_spi_mutex);
+}
+
+size_t avrtos_spi_transfer(const uint8_t *tx,
+                           uint8_t *rx,
+                           size_t len,
+                           uint64_t timeout_us) {
+    if (len == 0) {
+        return 0;
+    }
+
+    g_spi_tx = tx;
+    g_spi_rx = rx;
+    g_spi_len = len;
+    g_spi_count = 0;
+    avrtos_completion_reset(&g_spi_done);
+    avrtos_spi_start_impl(tx ? tx[0] : AVRTOS_SPI_FILL_BYTE);
+
+    size_t count = len;
+    if (!avrtos_completion_wait(&g_spi_done, timeout_us)) {
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_SPI) {
+            avrtos_spi_stop_impl();
+            count = g_spi_count;
+        }
+    }
+    return count;
+}
+
+void _avrtos_spi_init(void) {
+    avrtos_spi_init_impl();
+}
+
+bool _avrtos_spi_isr(uint8_t received, uint8_t *out_next) {
+    size_t count = g_spi_count;
+    if (g_spi_rx) {
+        g_spi_rx[count] = received;
+    }
+    g_spi_count = ++count;
+
+    if (count < g_spi_len) {
+        *out_next = g_spi_tx ? g_spi_tx[count] : AVRTOS_SPI_FILL_BYTE;
+        return true;
+    }
+    avrtos_spi_stop_impl();
+    avrtos_completion_complete(&g_spi_done);
+    return false;
+}
+
+#endif // AVRTOS_WITH_SPI
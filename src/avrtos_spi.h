@@ -0,0 +1,99 @@
+#ifndef AVRTOS_SPI_H_
+#define AVRTOS_SPI_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_SPI
+
+#if !defined(AVRTOS_WITH_MUTEX) || !defined(AVRTOS_WITH_COMPLETION)
+#error "AVRTOS_WITH_SPI requires AVRTOS_WITH_MUTEX and AVRTOS_WITH_COMPLETION"
+#endif // !AVRTOS_WITH_MUTEX || !AVRTOS_WITH_COMPLETION
+
+/**
+ * Timeout of avrtos_spi_transfer() that never expires.
+ */
+#define AVRTOS_SPI_FOREVER UINT64_MAX
+
+/**
+ * Byte sent by avrtos_spi_transfer() when there is no data to send.
+ */
+#define AVRTOS_SPI_FILL_BYTE 0xFF
+
+/**
+ * Bus settings of a single device. Field "mode" is the SPI mode (0 to 3, clock
+ * polarity in bit 1 and clock phase in bit 0), field "frequency" is the
+ * highest SCK frequency in Hz the device supports.
+ */
+struct avrtos_spi_config {
+    uint32_t frequency;
+    uint8_t mode;
+    bool lsb_first;
+};
+
+/**
+ * Locks the bus and sets it up for a device. Waits while another task holds
+ * the bus. The caller drives the chip select of the device.
+ *
+ * @param config Bus settings of the device.
+ */
+void avrtos_spi_acquire(const struct avrtos_spi_config *config);
+
+/**
+ * Unlocks the bus locked with @ref avrtos_spi_acquire.
+ */
+void avrtos_spi_release(void);
+
+/**
+ * Sends and receives @p len bytes at the same time. Sleeps until the SPI
+ * interrupt has moved all the bytes or @p timeout_us microseconds pass, other
+ * tasks run in the meantime. The bus has to be locked by the current task.
+ *
+ * @param tx         Bytes to be sent, NULL to send AVRTOS_SPI_FILL_BYTE.
+ *
+ * @param rx         Destination of the received bytes, NULL to drop them.
+ *
+ * @param len        Number of bytes to transfer.
+ *
+ * @param timeout_us Maximal time to wait for the transfer or
+ *                   @ref AVRTOS_SPI_FOREVER.
+ *
+ * @returns number of transferred bytes (less than @p len on timeout).
+ */
+size_t avrtos_spi_transfer(const uint8_t *tx,
+                           uint8_t *rx,
+                           size_t len,
+                           uint64_t timeout_us);
+
+/**
+ * Initializes the SPI master. Should be a "private" function.
+ */
+void _avrtos_spi_init(void);
+
+/**
+ * Handles a byte transferred by the serial transfer complete interrupt. Should
+ * be a "private" function.
+ *
+ * @param received Byte received together with the last byte sent.
+ *
+ * @param out_next Destination of the next byte to be sent.
+ *
+ * @returns false if the transfer has finished.
+ */
+bool _avrtos_spi_isr(uint8_t received, uint8_t *out_next);
+
+#endif // AVRTOS_WITH_SPI
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_SPI_H_ */
@@ -0,0 +1,121 @@
+#include <util/atomic.h>
+#include <util/twi.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_TWI
+
+#include "avrtos_completion.h"
+#include "avrtos_core.h"
+#include "avrtos_mutex.h"
+#include "avrtos_twi.h"
+#include "critical_section_arch_ind.h"
+
+/* serializes the transactions */
+AVRTOS_MUTEX_DEFINE(g_twi_mutex);
+
+/* the transaction in progress, set up by the task holding the bus while the
+   TWI interrupt is disabled, then moved forward by TWI_vect */
+static uint8_t g_twi_address;
+static const uint8_t *g_twi_tx;
+static size_t g_twi_tx_len;
+static uint8_t *g_twi_rx;
+static size_t g_twi_rx_len;
+static size_t g_twi_index;
+static bool g_twi_reading;
+static volatile enum avrtos_twi_status g_twi_status;
+static struct avrtos_completion g_twi_done;
+
+static void twi_finish(enum avrtos_twi_status status, bool stop) {
+    avrtos_twi_finish_impl(stop);
+    g_twi_status = status;
+    avrtos_completion_complete(&g_twi_done);
+}
+
+enum avrtos_twi_status avrtos_twi_transfer(uint8_t address,
+                                           const uint8_t *tx,
+                                           size_t tx_len,
+                                           uint8_t *rx,
+                                           size_t rx_len,
+                                           uint64_t timeout_us) {
+    avrtos_mutex_lock(&g_twi_mutex);
+
+    g_twi_address = address;
+    g_twi_tx = tx;
+    g_twi_tx_len = tx ? tx_len : 0;
+    g_twi_rx = rx;
+    g_twi_rx_len = rx ? rx_len : 0;
+    g_twi_index = 0;
+    g_twi_reading = g_twi_tx_len == 0 && g_twi_rx_len > 0;
+    g_twi_status = AVRTOS_TWI_BUSY;
+    avrtos_completion_reset(&g_twi_done);
+    avrtos_twi_start_impl();
+
+    enum avrtos_twi_status status = AVRTOS_TWI_TIMEOUT;
+    (void) avrtos_completion_wait(&g_twi_done, timeout_us);
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_TWI) {
+        if (g_twi_status == AVRTOS_TWI_BUSY) {
+            avrtos_twi_finish_impl(true);
+            g_twi_status = AVRTOS_TWI_TIMEOUT;
+        }
+        status = g_twi_status;
+    }
+
+    avrtos_mutex_unlock(&g_twi_mutex);
+    return status;
+}
+
+void _avrtos_twi_init(void) {
+    avrtos_twi_init_impl();
+}
+
+void _avrtos_twi_isr(uint8_t status, uint8_t data) {
+    switch (status) {
+    case TW_START:
+    case TW_REP_START:
+        avrtos_twi_write_impl((uint8_t) (g_twi_address << 1)
+                              | (g_twi_reading ? TW_READ : TW_WRITE));
+        break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (g_twi_index < g_twi_tx_len) {
+            avrtos_twi_write_impl(g_twi_tx[g_twi_index++]);
+        } else if (g_twi_rx_len > 0) {
+            g_twi_index = 0;
+            g_twi_reading = true;
+            /* no stop condition has been sent, TWSTO is clear */
+            avrtos_twi_repeated_start_impl();
+        } else {
+            twi_finish(AVRTOS_TWI_OK, true);
+        }
+        break;
+    case TW_MR_SLA_ACK:
+        /* the last byte is not acknowledged */
+        avrtos_twi_read_impl(g_twi_rx_len > 1);
+        break;
+    case TW_MR_DATA_ACK:
+        g_twi_rx[g_twi_index++] = data;
+        avrtos_twi_read_impl(g_twi_index < g_twi_rx_len - 1);
+        break;
+    case TW_MR_DATA_NACK:
+        g_twi_rx[g_twi_index] = data;
+        twi_finish(AVRTOS_TWI_OK, true);
+        break;
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+        twi_finish(AVRTOS_TWI_ADDRESS_NACK, true);
+        break;
+    case TW_MT_DATA_NACK:
+        twi_finish(AVRTOS_TWI_DATA_NACK, true);
+        break;
+    case TW_MT_ARB_LOST:
+        /* another master owns the bus, it sends the stop condition */
+        twi_finish(AVRTOS_TWI_ARBITRATION_LOST, false);
+        break;
+    default:
+        twi_finish(AVRTOS_TWI_BUS_ERROR, true);
+        break;
+    }
+}
+
+#endif // AVRTOS_WITH_TWI
@@ -0,0 +1,91 @@
+#ifndef AVRTOS_TWI_H_
+#define AVRTOS_TWI_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_TWI
+
+#if !defined(AVRTOS_WITH_MUTEX) || !defined(AVRTOS_WITH_COMPLETION)
+#error "AVRTOS_WITH_TWI requires AVRTOS_WITH_MUTEX and AVRTOS_WITH_COMPLETION"
+#endif // !AVRTOS_WITH_MUTEX || !AVRTOS_WITH_COMPLETION
+
+/**
+ * Timeout of avrtos_twi_transfer() that never expires.
+ */
+#define AVRTOS_TWI_FOREVER UINT64_MAX
+
+/**
+ * Result of a TWI transaction.
+ */
+enum avrtos_twi_status {
+    AVRTOS_TWI_OK,
+    AVRTOS_TWI_ADDRESS_NACK,
+    AVRTOS_TWI_DATA_NACK,
+    AVRTOS_TWI_ARBITRATION_LOST,
+    AVRTOS_TWI_BUS_ERROR,
+    AVRTOS_TWI_TIMEOUT,
+    AVRTOS_TWI_BUSY
+};
+
+/**
+ * Runs a whole transaction with a device: writes @p tx_len bytes, then reads
+ * @p rx_len bytes after a repeated start (e.g. a register address followed by
+ * its value). Either part can be empty, an empty transaction only checks that
+ * the device acknowledges its address. Locks the bus and sleeps until the TWI
+ * interrupt has finished the transaction or @p timeout_us microseconds pass,
+ * other tasks run in the meantime.
+ *
+ * @param address    7-bit address of the device.
+ *
+ * @param tx         Bytes to be written.
+ *
+ * @param tx_len     Number of bytes to write.
+ *
+ * @param rx         Destination of the read bytes.
+ *
+ * @param rx_len     Number of bytes to read.
+ *
+ * @param timeout_us Maximal time to wait for the transaction or
+ *                   @ref AVRTOS_TWI_FOREVER. A stop condition ends the
+ *                   transaction on timeout.
+ *
+ * @returns AVRTOS_TWI_OK on success, the reason of the failure otherwise.
+ */
+enum avrtos_twi_status avrtos_twi_transfer(uint8_t address,
+                                           const uint8_t *tx,
+                                           size_t tx_len,
+                                           uint8_t *rx,
+                                           size_t rx_len,
+                                           uint64_t timeout_us);
+
+/**
+ * Initializes the TWI master. Should be a "private" function.
+ */
+void _avrtos_twi_init(void);
+
+/**
+ * Moves the transaction forward from the TWI interrupt. Should be a "private"
+ * function.
+ *
+ * @param status Status code of the TWI (prescaler bits masked out).
+ *
+ * @param data   Content of the data register.
+ */
+void _avrtos_twi_isr(uint8_t status, uint8_t data);
+
+#endif // AVRTOS_WITH_TWI
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_TWI_H_ */
@@ -0,0 +1,197 @@
+#include <string.h>
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_USART
+
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "avrtos_mutex.h"
+#include "avrtos_usart.h"
+#include "avrtos_utils.h"
+#include "critical_section_arch_ind.h"
+
+#define USART_RX_CAPACITY (AVRTOS_USART_RX_BUFFER_SIZE - 1)
+#define USART_TX_CAPACITY (AVRTOS_USART_TX_BUFFER_SIZE - 1)
+
+/* USART_RX_vect produces, readers (serialized by g_usart_rx_mutex) consume */
+SPSC_RING_DEFINE(g_usart_rx_ring, AVRTOS_USART_RX_BUFFER_SIZE);
+/* writers and the logger (serialized by g_usart_tx_mutex) produce,
+   USART_UDRE_vect consumes */
+SPSC_RING_DEFINE(g_usart_tx_ring, AVRTOS_USART_TX_BUFFER_SIZE);
+
+AVRTOS_MUTEX_DEFINE(g_usart_rx_mutex);
+AVRTOS_MUTEX_DEFINE(g_usart_tx_mutex);
+
+/* sleeping reader and writer and the ring level they wait for, set by the
+   tasks and cleared by the ISRs with interrupts disabled */
+static struct avrtos_task *volatile g_usart_rx_waiter;
+static uint8_t g_usart_rx_wake_level;
+static struct avrtos_task *volatile g_usart_tx_waiter;
+static uint8_t g_usart_tx_wake_level;
+
+/* written by USART_RX_vect, read by any task */
+static volatile uint16_t g_usart_rx_errors;
+
+static uint8_t usart_min(size_t len, uint8_t limit) {
+    return len < limit ? (uint8_t) len : limit;
+}
+
+size_t avrtos_usart_read(uint8_t *data, size_t len, uint64_t timeout_us) {
+    if (!data) {
+        return 0;
+    }
+
+    bool forever = timeout_us == AVRTOS_USART_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    size_t count = 0;
+
+    avrtos_mutex_lock(&g_usart_rx_mutex);
+    while (count < len) {
+        char *ptr;
+        uint8_t available;
+        if (spsc_ring_peek_contiguous(&g_usart_rx_ring, &ptr, &available)
+            == CIRC_BUFF_OK) {
+            uint8_t chunk = usart_min(len - count, available);
+            memcpy(&data[count], ptr, chunk);
+            (void) spsc_ring_consume(&g_usart_rx_ring, chunk);
+            count += chunk;
+            continue;
+        }
+
+        avrtos_tick_t ticks = _avrtos_delay_ticks_left(deadline, forever);
+        if (ticks == 0) {
+            break;
+        }
+        /* wake up once the rest of the bytes (or a full buffer) arrive */
+        uint8_t level = usart_min(len - count, USART_RX_CAPACITY);
+        bool sleeping = false;
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USART) {
+            if (spsc_ring_get_occupancy(&g_usart_rx_ring) < level) {
+                g_usart_rx_wake_level = level;
+                g_usart_rx_waiter = _avrtos_current_task_get();
+                _avrtos_task_sleep_prepare(ticks);
+                sleeping = true;
+            }
+        }
+        if (sleeping) {
+            avrtos_task_yield();
+            AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USART) {
+                g_usart_rx_waiter = NULL;
+            }
+        }
+    }
+    avrtos_mutex_unlock(&g_usart_rx_mutex);
+
+    return count;
+}
+
+size_t avrtos_usart_write(const uint8_t *data,
+                          size_t len,
+                          uint64_t timeout_us) {
+    if (!data) {
+        return 0;
+    }
+
+    bool forever = timeout_us == AVRTOS_USART_FOREVER;
+    avrtos_tick_t deadline = _avrtos_delay_deadline(timeout_us);
+    size_t count = 0;
+
+    _avrtos_usart_tx_lock();
+    while (count < len) {
+        char *ptr;
+        uint8_t contiguous;
+        if (spsc_ring_reserve(&g_usart_tx_ring, &ptr, &contiguous)
+            == CIRC_BUFF_OK) {
+            uint8_t chunk = usart_min(len - count, contiguous);
+            memcpy(ptr, &data[count], chunk);
+            (void) spsc_ring_commit(&g_usart_tx_ring, chunk);
+            count += chunk;
+            _avrtos_usart_tx_start();
+            continue;
+        }
+
+        avrtos_tick_t ticks = _avrtos_delay_ticks_left(deadline, forever);
+        if (ticks == 0) {
+            break;
+        }
+        /* wake up once the rest of the bytes (or a whole buffer) fit */
+        uint8_t level = usart_min(len - count, USART_TX_CAPACITY);
+        bool sleeping = false;
+        AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USART) {
+            if (spsc_ring_get_space_left(&g_usart_tx_ring) < level) {
+                g_usart_tx_wake_level = level;
+                g_usart_tx_waiter = _avrtos_current_task_get();
+                _avrtos_task_sleep_prepare(ticks);
+                sleeping = true;
+            }
+        }
+        if (sleeping) {
+            avrtos_task_yield();
+            AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USART) {
+                g_usart_tx_waiter = NULL;
+            }
+        }
+    }
+    _avrtos_usart_tx_unlock();
+
+    return count;
+}
+
+uint16_t avrtos_usart_get_rx_errors(void) {
+    return avrtos_read_volatile_u16(&g_usart_rx_errors);
+}
+
+void _avrtos_usart_init(void) {
+    avrtos_usart_init_impl();
+}
+
+void _avrtos_usart_tx_lock(void) {
+    avrtos_mutex_lock(&g_usart_tx_mutex);
+}
+
+void _avrtos_usart_tx_unlock(void) {
+    avrtos_mutex_unlock(&g_usart_tx_mutex);
+}
+
+struct spsc_ring *_avrtos_usart_tx_ring(void) {
+    return &g_usart_tx_ring;
+}
+
+void _avrtos_usart_rx_isr(uint8_t value, bool error) {
+    if (error
+        || spsc_ring_insert_one(&g_usart_rx_ring, (char) value)
+                   != CIRC_BUFF_OK) {
+        if (g_usart_rx_errors < UINT16_MAX) {
+            g_usart_rx_errors++;
+        }
+        return;
+    }
+
+    struct avrtos_task *waiter = g_usart_rx_waiter;
+    if (waiter
+        && spsc_ring_get_occupancy(&g_usart_rx_ring) >= g_usart_rx_wake_level) {
+        g_usart_rx_waiter = NULL;
+        _avrtos_task_wake(waiter);
+    }
+}
+
+bool _avrtos_usart_tx_isr(uint8_t *out_value) {
+    char value;
+    if (spsc_ring_get_one(&g_usart_tx_ring, &value) != CIRC_BUFF_OK) {
+        return false;
+    }
+    *out_value = (uint8_t) value;
+
+    struct avrtos_task *waiter = g_usart_tx_waiter;
+    if (waiter
+        && spsc_ring_get_space_left(&g_usart_tx_ring)
+                   >= g_usart_tx_wake_level) {
+        g_usart_tx_waiter = NULL;
+        _avrtos_task_wake(waiter);
+    }
+    return true;
+}
+
+#endif // AVRTOS_WITH_USART
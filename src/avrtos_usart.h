@@ -0,0 +1,123 @@
+#ifndef AVRTOS_USART_H_
+#define AVRTOS_USART_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+#include "spsc_ring_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_USART
+
+#ifndef AVRTOS_WITH_MUTEX
+#error "AVRTOS_WITH_USART requires AVRTOS_WITH_MUTEX"
+#endif // AVRTOS_WITH_MUTEX
+
+/**
+ * Timeout of avrtos_usart_read() and avrtos_usart_write() that never expires.
+ */
+#define AVRTOS_USART_FOREVER UINT64_MAX
+
+/**
+ * Receives up to @p len bytes. Sleeps until @p len bytes have been received or
+ * @p timeout_us microseconds pass, other tasks run in the meantime. Readers are
+ * serialized, a reader waits for the previous one to finish.
+ *
+ * @param data       Destination of the received bytes.
+ *
+ * @param len        Number of bytes to receive.
+ *
+ * @param timeout_us Maximal time to wait for the bytes, 0 to take only the
+ *                   bytes that have already been received or
+ *                   @ref AVRTOS_USART_FOREVER.
+ *
+ * @returns number of received bytes (less than @p len on timeout).
+ */
+size_t avrtos_usart_read(uint8_t *data, size_t len, uint64_t timeout_us);
+
+/**
+ * Queues @p len bytes for sending. Sleeps while the TX buffer is full, other
+ * tasks run in the meantime. Writers (and the asynchronous logger) are
+ * serialized, the bytes of a single call are not interleaved with other
+ * output.
+ *
+ * @param data       Bytes to be sent.
+ *
+ * @param len        Number of bytes to send.
+ *
+ * @param timeout_us Maximal time to wait for free space in the TX buffer, 0 to
+ *                   queue only as many bytes as fit at the moment or
+ *                   @ref AVRTOS_USART_FOREVER.
+ *
+ * @returns number of queued bytes (less than @p len on timeout).
+ */
+size_t avrtos_usart_write(const uint8_t *data, size_t len, uint64_t timeout_us);
+
+/**
+ * Returns the number of received bytes lost since the startup, because the RX
+ * buffer was full or the USART reported a data overrun or a frame error
+ * (saturates at UINT16_MAX).
+ */
+uint16_t avrtos_usart_get_rx_errors(void);
+
+/**
+ * Initializes the USART and the RX and TX buffers. Should be a "private"
+ * function.
+ */
+void _avrtos_usart_init(void);
+
+/**
+ * Locks and unlocks the TX buffer for a producer, e.g. the asynchronous logger
+ * writing into @ref _avrtos_usart_tx_ring. Should be "private" functions.
+ */
+void _avrtos_usart_tx_lock(void);
+void _avrtos_usart_tx_unlock(void);
+
+/**
+ * Returns the TX buffer. Has to be written with the TX buffer locked, the
+ * written bytes are sent after @ref _avrtos_usart_tx_start. Should be a
+ * "private" function.
+ */
+struct spsc_ring *_avrtos_usart_tx_ring(void);
+
+/**
+ * Starts sending the bytes queued in the TX buffer. Should be a "private"
+ * function.
+ */
+static inline void _avrtos_usart_tx_start(void) {
+    avrtos_usart_tx_start_impl();
+}
+
+/**
+ * Handles a byte received by the RX complete interrupt. Should be a "private"
+ * function.
+ *
+ * @param value Received byte.
+ *
+ * @param error true if the USART has reported a data overrun or a frame error.
+ */
+void _avrtos_usart_rx_isr(uint8_t value, bool error);
+
+/**
+ * Takes the next byte to be sent for the data register empty interrupt. Should
+ * be a "private" function.
+ *
+ * @param out_value Destination of the byte.
+ *
+ * @returns false if there is nothing to send.
+ */
+bool _avrtos_usart_tx_isr(uint8_t *out_value);
+
+#endif // AVRTOS_WITH_USART
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_USART_H_ */
@@ -1,6 +1,8 @@
 #ifndef AVRTOS_UTILS_H_
 #define AVRTOS_UTILS_H_
 
+#include <inttypes.h>
+
 #include "avrtos_config.h"
 
 /**
@@ -39,6 +41,39 @@
 #define AVRTOS_IS_DEFINED(MacroValue, TrueValue, FalseValue) \
     _IS_DEFINED(MacroValue, TrueValue, FalseValue)
 
+/**
+ * Prevents the compiler from reordering memory accesses across this point.
+ * Used by lock-free structures shared between tasks and ISRs (AVR is single
+ * core, so no hardware barrier is needed).
+ */
+#define AVRTOS_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/**
+ * Reads a 16-bit counter updated by an ISR. Such reads are not atomic on AVR,
+ * so the counter is read again until two reads agree.
+ */
+static inline uint16_t
+avrtos_read_volatile_u16(const volatile uint16_t *value) {
+    uint16_t ret;
+    do {
+        ret = *value;
+    } while (ret != *value);
+
+    return ret;
+}
+
+/**
+ * Places constant data in flash memory instead of copying it into SRAM at
+ * startup. Such data has to be read with the avr-libc "_P" functions. On other
+ * architectures it expands to nothing.
+ */
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define AVRTOS_PROGMEM PROGMEM
+#else // defined(__AVR__)
+#define AVRTOS_PROGMEM
+#endif // defined(__AVR__)
+
 /**
  * Helper macros for setting and clearing bits in registers.
  */
@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <util/atomic.h>
+
+#include "avrtos_config.h"
+
+#ifdef AVRTOS_WITH_WORK_QUEUE
+
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+#include "avrtos_work.h"
+#include "critical_section_arch_ind.h"
+
+struct avrtos_work *g_work_head = NULL;
+struct avrtos_work *g_work_tail = NULL;
+
+struct avrtos_task _work_queue_tasks[AVRTOS_WORK_QUEUE_WORKERS_COUNT];
+AVRTOS_STACK_DEFINE(_work_queue_stacks[AVRTOS_WORK_QUEUE_WORKERS_COUNT],
+                    AVRTOS_WORK_QUEUE_STACK_SIZE);
+
+static bool work_is_ready(struct avrtos_work *work) {
+    return !(work->flags & AVRTOS_WORK_FLAG_DELAYED)
+           || _avrtos_delay_tick_has_passed(work->run_at);
+}
+
+static struct avrtos_work *work_take_next(void) {
+    struct avrtos_work *ret = NULL;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_WORK_TAKE) {
+        struct avrtos_work *previous = NULL;
+        for (struct avrtos_work *iterator = g_work_head; iterator;
+             previous = iterator, iterator = iterator->next) {
+            if (!work_is_ready(iterator)) {
+                continue;
+            }
+            if (previous) {
+                previous->next = iterator->next;
+            } else {
+                g_work_head = iterator->next;
+            }
+            if (g_work_tail == iterator) {
+                g_work_tail = previous;
+            }
+            /* clear flags before running the handler, so it can submit the
+               work item again */
+            iterator->next = NULL;
+            iterator->flags = 0;
+            ret = iterator;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+static void _work_queue_thread(void *arg) {
+    (void) arg;
+    while (1) {
+        struct avrtos_work *work = work_take_next();
+        if (work) {
+            work->handler(work);
+        } else {
+            avrtos_task_yield();
+        }
+    }
+}
+
+static bool work_append(struct avrtos_work *work,
+                        uint8_t flags,
+                        avrtos_tick_t run_at) {
+    if (!work) {
+        return false;
+    }
+
+    bool ret = false;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_WORK_SUBMIT) {
+        if (!(work->flags & AVRTOS_WORK_FLAG_PENDING)) {
+            work->flags = AVRTOS_WORK_FLAG_PENDING | flags;
+            work->run_at = run_at;
+            work->next = NULL;
+            if (g_work_tail) {
+                g_work_tail->next = work;
+            } else {
+                g_work_head = work;
+            }
+            g_work_tail = work;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+bool avrtos_work_submit(struct avrtos_work *work) {
+    return work_append(work, 0, 0);
+}
+
+bool avrtos_work_submit_delayed_ticks(struct avrtos_work *work,
+                                      avrtos_tick_t delay_ticks) {
+    if (delay_ticks > AVRTOS_DELAY_MAX_TICKS) {
+        delay_ticks = AVRTOS_DELAY_MAX_TICKS;
+    }
+
+    return work_append(work, AVRTOS_WORK_FLAG_DELAYED,
+                       _avrtos_delay_get_ticks() + delay_ticks);
+}
+
+bool avrtos_work_submit_delayed(struct avrtos_work *work, uint64_t delay_us) {
+    return work_append(work, AVRTOS_WORK_FLAG_DELAYED,
+                       _avrtos_delay_deadline(delay_us));
+}
+
+void _avrtos_work_queue_init(void) {
+    for (uint8_t i = 0; i < AVRTOS_WORK_QUEUE_WORKERS_COUNT; i++) {
+        (void) avrtos_task_create(&_work_queue_tasks[i], _work_queue_thread,
+                                  _work_queue_stacks[i],
+                                  sizeof(_work_queue_stacks[i]), NULL);
+    }
+}
+
+#endif // AVRTOS_WITH_WORK_QUEUE
@@ -0,0 +1,123 @@
+#ifndef AVRTOS_WORK_H_
+#define AVRTOS_WORK_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "avrtos_config.h"
+#include "avrtos_core.h"
+#include "avrtos_delay.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_WORK_QUEUE
+
+/**
+ * Work item flags.
+ */
+#define AVRTOS_WORK_FLAG_PENDING (1 << 0)
+#define AVRTOS_WORK_FLAG_DELAYED (1 << 1)
+
+/**
+ * Work item. Submitted work items are run, in submission order, by the work
+ * queue worker tasks. A work item can be submitted again from its own
+ * handler.
+ */
+struct avrtos_work {
+    void (*handler)(struct avrtos_work *);
+    volatile uint8_t flags;
+    avrtos_tick_t run_at;
+    struct avrtos_work *next;
+};
+
+/**
+ * Simple work item definition.
+ *
+ * @param WorkName Name of the work item that will be used as its identifier.
+ *
+ * @param Handler  Function that will be called by a worker task.
+ */
+#define AVRTOS_WORK_DEFINE(WorkName, Handler)            \
+    struct avrtos_work WorkName = {.handler = (Handler), \
+                                   .flags = 0,           \
+                                   .run_at = 0,          \
+                                   .next = NULL}
+
+/**
+ * Submits the work item to the work queue. Does nothing if the work item is
+ * already pending. Can be called from an ISR.
+ *
+ * @param work Pointer to the work item.
+ *
+ * @returns true if the work item has been queued,
+ *          false if @p work is NULL or the work item is already pending.
+ */
+bool avrtos_work_submit(struct avrtos_work *work);
+
+/**
+ * Submits the work item to the work queue. The work item will not be run
+ * before @p delay_ticks delay timer ticks pass. Does nothing if the work item
+ * is already pending. Can be called from an ISR.
+ *
+ * @param work        Pointer to the work item.
+ *
+ * @param delay_ticks Minimal number of ticks before the work item is run,
+ *                    trimmed to @ref AVRTOS_DELAY_MAX_TICKS.
+ *
+ * @returns true if the work item has been queued,
+ *          false if @p work is NULL or the work item is already pending.
+ */
+bool avrtos_work_submit_delayed_ticks(struct avrtos_work *work,
+                                      avrtos_tick_t delay_ticks);
+
+/**
+ * Submits the work item to the work queue. The work item will not be run
+ * before @p delay_us microseconds pass. Does nothing if the work item is
+ * already pending. Converting the delay to ticks takes a 64-bit division,
+ * hundreds of CPU cycles on AVR, so ISRs should rather call
+ * avrtos_work_submit_delayed_ticks().
+ *
+ * @param work     Pointer to the work item.
+ *
+ * @param delay_us Minimal number of microseconds before the work item is run.
+ *
+ * @returns true if the work item has been queued,
+ *          false if @p work is NULL or the work item is already pending.
+ */
+bool avrtos_work_submit_delayed(struct avrtos_work *work, uint64_t delay_us);
+
+/**
+ * Same as avrtos_work_submit_delayed() but with the delay in milliseconds.
+ */
+static inline bool avrtos_work_submit_delayed_ms(struct avrtos_work *work,
+                                                 uint64_t delay_ms) {
+    return avrtos_work_submit_delayed(
+            work, delay_ms * (uint64_t) AVRTOS_MILLISECONDS_TO_MICROSECONDS);
+}
+
+/**
+ * Checks whether the work item is waiting in the work queue.
+ *
+ * @param work Pointer to the work item.
+ *
+ * @returns true if the work item is pending,
+ *          false otherwise.
+ */
+static inline bool avrtos_work_is_pending(struct avrtos_work *work) {
+    return (work->flags & AVRTOS_WORK_FLAG_PENDING);
+}
+
+/**
+ * Creates the work queue worker tasks. Should be a "private" function.
+ */
+void _avrtos_work_queue_init(void);
+
+#endif // AVRTOS_WITH_WORK_QUEUE
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* AVRTOS_WORK_H_ */
@@ -2,10 +2,36 @@
 #include <avr/io.h>
 #include <util/atomic.h>
 
+#include <string.h>
+
 #include "../avrtos_config.h"
+#include "../avrtos_isr.h"
 #include "../avrtos_mutex.h"
 #include "../avrtos_utils.h"
-#include "../circular_buffer_arch_ind.h"
+#include "../critical_section_arch_ind.h"
+#include "../spsc_ring_arch_ind.h"
+
+#ifdef AVRTOS_WITH_USART
+#include "../avrtos_usart.h"
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_SPI
+#include "../avrtos_spi.h"
+#endif // AVRTOS_WITH_SPI
+
+#ifdef AVRTOS_WITH_TWI
+#include <util/twi.h>
+
+#include "../avrtos_twi.h"
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_ADC
+#include "../avrtos_adc.h"
+#endif // AVRTOS_WITH_ADC
+
+#ifdef AVRTOS_WITH_EEPROM
+#include "../avrtos_eeprom.h"
+#endif // AVRTOS_WITH_EEPROM
 
 #if defined(__AVR_ATmega328P__)
 
@@ -25,18 +51,103 @@
 #endif // AVRTOS_ASYNCHRONOUS_LOGGER_BAURATE > 38400
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
+#ifdef AVRTOS_WITH_USART
+/* rounded to the nearest value */
+#if AVRTOS_USART_BAUDRATE > 38400
+#define USART_UBRR_REG_VAL                                      \
+    ((AVRTOS_CPU_CLOCK_FREQUENCY + 4UL * AVRTOS_USART_BAUDRATE) \
+             / (8UL * AVRTOS_USART_BAUDRATE)                    \
+     - 1)
+#else // AVRTOS_USART_BAUDRATE > 38400
+#define USART_UBRR_REG_VAL                                      \
+    ((AVRTOS_CPU_CLOCK_FREQUENCY + 8UL * AVRTOS_USART_BAUDRATE) \
+             / (16UL * AVRTOS_USART_BAUDRATE)                   \
+     - 1)
+#endif // AVRTOS_USART_BAUDRATE > 38400
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_TWI
+/* no prescaler, SCL frequency = CPU clock / (16 + 2 * TWBR) */
+#define TWBR_REG_VAL \
+    ((AVRTOS_CPU_CLOCK_FREQUENCY / AVRTOS_TWI_FREQUENCY - 16) / 2)
+
+AVRTOS_STATIC_ASSERT(AVRTOS_CPU_CLOCK_FREQUENCY / AVRTOS_TWI_FREQUENCY >= 16
+                             && TWBR_REG_VAL <= UINT8_MAX,
+                     TwiFrequencyIsNotValid);
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_ADC
+/* the fastest ADC clock not above 200 kHz, the highest clock with full 10-bit
+   resolution */
+#define ADC_MAX_CLOCK 200000UL
+#if AVRTOS_CPU_CLOCK_FREQUENCY <= 2 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 1
+#elif AVRTOS_CPU_CLOCK_FREQUENCY <= 4 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 2
+#elif AVRTOS_CPU_CLOCK_FREQUENCY <= 8 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 3
+#elif AVRTOS_CPU_CLOCK_FREQUENCY <= 16 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 4
+#elif AVRTOS_CPU_CLOCK_FREQUENCY <= 32 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 5
+#elif AVRTOS_CPU_CLOCK_FREQUENCY <= 64 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 6
+#else // AVRTOS_CPU_CLOCK_FREQUENCY > 64 * ADC_MAX_CLOCK
+#define ADC_PRESCALER_BITS 7
+#endif // AVRTOS_CPU_CLOCK_FREQUENCY <= 2 * ADC_MAX_CLOCK
+
+/* a triggered conversion takes 13.5 ADC clock cycles */
+#define ADC_MAX_CONVERSION_RATE \
+    (AVRTOS_CPU_CLOCK_FREQUENCY / (1UL << ADC_PRESCALER_BITS) * 2 / 27)
+
+/* TIMER1 counts CPU clock / 8 between the triggers */
+#define ADC_TIMER_PRESCALER 8UL
+#endif // AVRTOS_WITH_ADC
+
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
-struct circular_buffer g_logger_circ_buff;
+#ifdef AVRTOS_WITH_USART
+/* log messages are multiplexed into the TX buffer of the USART driver */
+#define LOGGER_RING (_avrtos_usart_tx_ring())
+#define LOGGER_RING_SIZE AVRTOS_USART_TX_BUFFER_SIZE
+#else // AVRTOS_WITH_USART
+AVRTOS_STATIC_ASSERT(AVRTOS_LOG_BUFFER_SIZE >= SPSC_RING_MIN_SIZE
+                             && AVRTOS_LOG_BUFFER_SIZE <= SPSC_RING_MAX_SIZE,
+                     LogBufferSizeIsNotValid);
+
+/* tasks (serialized by logger_mutex) produce, USART_UDRE_vect consumes */
+struct spsc_ring g_logger_circ_buff;
 char g_logger_buffer[AVRTOS_LOG_BUFFER_SIZE];
+#define LOGGER_RING (&g_logger_circ_buff)
+#define LOGGER_RING_SIZE AVRTOS_LOG_BUFFER_SIZE
+#endif // AVRTOS_WITH_USART
+
+AVRTOS_STATIC_ASSERT(AVRTOS_SINGLE_LOG_MAX_SIZE < LOGGER_RING_SIZE,
+                     SingleLogDoesNotFitIntoLogBuffer);
+
+/* characters of the current message that are not visible to the ISR yet */
+uint8_t g_logger_staged;
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
-volatile uint64_t g_microseconds_counter;
+volatile avrtos_tick_t g_ticks_counter;
 
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+#ifdef AVRTOS_WITH_USART
+void avrtos_logger_init_impl(void) {
+    /* the kernel has already initialized the USART driver */
+}
+
+void avrtos_log_lock_impl(void) {
+    _avrtos_usart_tx_lock();
+}
+
+void avrtos_log_unlock_impl(void) {
+    _avrtos_usart_tx_unlock();
+}
+#else // AVRTOS_WITH_USART
 AVRTOS_MUTEX_DEFINE(logger_mutex);
 
 void avrtos_logger_init_impl(void) {
-    (void) circ_buff_initialize(&g_logger_circ_buff, g_logger_buffer,
+    (void) spsc_ring_initialize(&g_logger_circ_buff, g_logger_buffer,
                                 AVRTOS_LOG_BUFFER_SIZE);
 
     /* Set the baud rate registers */
@@ -57,31 +168,284 @@ void avrtos_logger_init_impl(void) {
     AVRTOS_SET_BIT_IN_REGISTER(UCSR0C, UCSZ01);
 }
 
-void avrtos_handle_log_buffer_impl(char *buffer, size_t buf_len) {
-    if (!buffer) {
-        return;
-    }
-
+void avrtos_log_lock_impl(void) {
     avrtos_mutex_lock(&logger_mutex);
-    size_t index = 0;
-    while (buffer[index] && index < buf_len) {
-        enum circular_buffer_status ret;
+}
+
+void avrtos_log_unlock_impl(void) {
+    avrtos_mutex_unlock(&logger_mutex);
+}
+#endif // AVRTOS_WITH_USART
 
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-            ret = circ_buff_insert_one(&g_logger_circ_buff, buffer[index]);
+static void _avrtos_log_publish(void) {
+    (void) spsc_ring_publish(LOGGER_RING, g_logger_staged);
+    g_logger_staged = 0;
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, UDRIE0);
+}
+
+bool avrtos_log_put_impl(char c, bool wait) {
+    /* the last free slot is kept for avrtos_log_finish_impl() */
+    while (spsc_ring_get_space_left(LOGGER_RING)
+           < (uint16_t) g_logger_staged + 2) {
+        if (!wait) {
+            return false;
         }
+        /* the message cannot be dropped anymore, let the ISR send it */
+        if (g_logger_staged) {
+            _avrtos_log_publish();
+        }
+    }
+    (void) spsc_ring_stage(LOGGER_RING, g_logger_staged++, c);
+    return true;
+}
 
-        if (ret == CIRC_BUFF_OK) {
-            index++;
-            AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, UDRIE0);
-        } else if (ret == CIRC_BUFF_INVALID) {
-            break;
+bool avrtos_log_finish_impl(char c, bool wait) {
+    while (spsc_ring_get_space_left(LOGGER_RING)
+           < (uint16_t) g_logger_staged + 1) {
+        if (!wait) {
+            g_logger_staged = 0;
+            return false;
         }
     }
-    avrtos_mutex_unlock(&logger_mutex);
+    (void) spsc_ring_stage(LOGGER_RING, g_logger_staged++, c);
+    _avrtos_log_publish();
+    return true;
+}
+
+void avrtos_log_discard_impl(void) {
+    g_logger_staged = 0;
+}
+
+bool avrtos_log_write_impl(const char *data, size_t len, bool wait) {
+    if (!data || len >= LOGGER_RING_SIZE) {
+        return false;
+    }
+
+    while (spsc_ring_get_space_left(LOGGER_RING) < len) {
+        if (!wait) {
+            return false;
+        }
+    }
+    /* at most two segments, the ring end is never padded here */
+    while (len) {
+        char *ptr;
+        uint8_t contiguous;
+        (void) spsc_ring_reserve(LOGGER_RING, &ptr, &contiguous);
+        uint8_t chunk = len < contiguous ? (uint8_t) len : contiguous;
+        memcpy(ptr, data, chunk);
+        (void) spsc_ring_commit(LOGGER_RING, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, UDRIE0);
+    return true;
 }
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
+#ifdef AVRTOS_WITH_USART
+void avrtos_usart_init_impl(void) {
+    /* Set the baud rate registers */
+    UBRR0H = (uint8_t)(USART_UBRR_REG_VAL >> 8);
+    UBRR0L = (uint8_t) USART_UBRR_REG_VAL;
+
+#if AVRTOS_USART_BAUDRATE > 38400
+    /* double transmission speed */
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0A, U2X0);
+#endif // AVRTOS_USART_BAUDRATE > 38400
+
+    /* Set data frame format (8-bit data, no parity, 1 stop bit) */
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0C, UCSZ00);
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0C, UCSZ01);
+
+    /* Enable receiver, transmitter and USART Rx interrupt, the Tx interrupt is
+       enabled when there is something to send */
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, RXEN0);
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, TXEN0);
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, RXCIE0);
+}
+
+void avrtos_usart_tx_start_impl(void) {
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, UDRIE0);
+}
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_SPI
+void avrtos_spi_init_impl(void) {
+    /* SCK, MOSI and SS are outputs, SS has to stay an output (or high) for the
+       SPI to remain the master */
+    DDRB |= (1 << DDB5) | (1 << DDB3) | (1 << DDB2);
+    SPCR = (1 << SPE) | (1 << MSTR);
+}
+
+void avrtos_spi_configure_impl(uint32_t frequency,
+                               uint8_t mode,
+                               bool lsb_first) {
+    /* the fastest SCK not faster than the requested one: CPU clock / 2^shift,
+       shift 1 to 7 */
+    uint8_t shift = 1;
+    while (shift < 7 && (AVRTOS_CPU_CLOCK_FREQUENCY >> shift) > frequency) {
+        shift++;
+    }
+    /* odd shifts double the speed of the next even one, except for shift 7 */
+    uint8_t rate = shift == 7 ? 3 : (shift - 1) / 2;
+    bool double_speed = shift != 7 && (shift & 1);
+
+    SPCR = (1 << SPE) | (1 << MSTR) | (lsb_first ? (1 << DORD) : 0)
+           | ((mode & 3) << CPHA) | rate;
+    SPSR = double_speed ? (1 << SPI2X) : 0;
+}
+
+void avrtos_spi_start_impl(uint8_t first) {
+    /* clear the flag left by a transfer that has timed out */
+    (void) SPSR;
+    (void) SPDR;
+    AVRTOS_SET_BIT_IN_REGISTER(SPCR, SPIE);
+    SPDR = first;
+}
+
+void avrtos_spi_stop_impl(void) {
+    AVRTOS_CLEAR_BIT_IN_REGISTER(SPCR, SPIE);
+}
+#endif // AVRTOS_WITH_SPI
+
+#ifdef AVRTOS_WITH_TWI
+void avrtos_twi_init_impl(void) {
+    /* internal pull-ups on SDA and SCL, too weak for fast buses on their own */
+    PORTC |= (1 << PC4) | (1 << PC5);
+    TWSR = 0;
+    TWBR = (uint8_t) TWBR_REG_VAL;
+    TWCR = (1 << TWEN);
+}
+
+void avrtos_twi_start_impl(void) {
+    /* the stop condition of the previous transaction takes a few SCL
+       periods */
+    while (TWCR & (1 << TWSTO)) {
+    }
+    avrtos_twi_repeated_start_impl();
+}
+
+void avrtos_twi_repeated_start_impl(void) {
+    TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+}
+
+void avrtos_twi_write_impl(uint8_t value) {
+    TWDR = value;
+    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+}
+
+void avrtos_twi_read_impl(bool ack) {
+    TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (ack ? (1 << TWEA) : 0);
+}
+
+void avrtos_twi_finish_impl(bool stop) {
+    TWCR = (1 << TWINT) | (1 << TWEN) | (stop ? (1 << TWSTO) : 0);
+}
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_ADC
+bool avrtos_adc_start_impl(uint8_t channel, uint32_t conversion_rate) {
+    uint32_t top = 0;
+    if (conversion_rate) {
+        if (conversion_rate > ADC_MAX_CONVERSION_RATE) {
+            return false;
+        }
+        top = AVRTOS_CPU_CLOCK_FREQUENCY / ADC_TIMER_PRESCALER
+              / conversion_rate;
+        if (top == 0 || top > UINT16_MAX + 1UL) {
+            return false;
+        }
+    }
+
+    /* AVcc reference */
+    ADMUX = (1 << REFS0) | (channel & 0x0F);
+    if (conversion_rate) {
+        /* TIMER1 in CTC mode, compare match B triggers the conversions */
+        TCCR1A = 0;
+        TCCR1B = 0;
+        TCNT1 = 0;
+        OCR1A = (uint16_t) (top - 1);
+        OCR1B = (uint16_t) (top - 1);
+        TIFR1 = (1 << OCF1B);
+        ADCSRB = (1 << ADTS2) | (1 << ADTS0);
+    } else {
+        ADCSRB = 0;
+    }
+
+    ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIF) | (1 << ADIE)
+             | ADC_PRESCALER_BITS;
+    if (conversion_rate) {
+        TCCR1B = (1 << WGM12) | (1 << CS11);
+    } else {
+        AVRTOS_SET_BIT_IN_REGISTER(ADCSRA, ADSC);
+    }
+    return true;
+}
+
+void avrtos_adc_stop_impl(void) {
+    ADCSRA = 0;
+    TCCR1B = 0;
+}
+
+bool avrtos_adc_busy_impl(void) {
+    /* ADSC reads as one while a triggered conversion is in progress */
+    return ADCSRA & (1 << ADSC);
+}
+
+void avrtos_adc_select_impl(uint8_t channel) {
+    ADMUX = (1 << REFS0) | (channel & 0x0F);
+}
+#endif // AVRTOS_WITH_ADC
+
+#ifdef AVRTOS_WITH_EEPROM
+uint8_t avrtos_eeprom_read_impl(uint16_t address) {
+    EEAR = address;
+    AVRTOS_SET_BIT_IN_REGISTER(EECR, EERE);
+    return EEDR;
+}
+
+void avrtos_eeprom_write_impl(uint16_t address, uint8_t value) {
+    /* atomic erase and write, called from EE_READY_vect with interrupts
+       disabled, so EEPE is set within four cycles after EEMPE */
+    EEAR = address;
+    EEDR = value;
+    EECR = (1 << EEMPE) | (1 << EERIE);
+    AVRTOS_SET_BIT_IN_REGISTER(EECR, EEPE);
+}
+
+void avrtos_eeprom_ready_enable_impl(void) {
+    AVRTOS_SET_BIT_IN_REGISTER(EECR, EERIE);
+}
+
+void avrtos_eeprom_ready_disable_impl(void) {
+    AVRTOS_CLEAR_BIT_IN_REGISTER(EECR, EERIE);
+}
+#endif // AVRTOS_WITH_EEPROM
+
+#if defined(AVRTOS_WITH_SHELL) && defined(AVRTOS_WITH_USART)
+void avrtos_shell_rx_init_impl(void) {
+    /* the USART driver receives the characters */
+}
+
+bool avrtos_shell_getc_impl(char *c) {
+    return avrtos_usart_read((uint8_t *) c, 1, 0) == 1;
+}
+#elif defined(AVRTOS_WITH_SHELL)
+/* USART_RX_vect produces, the shell task consumes */
+SPSC_RING_DEFINE(g_shell_rx_ring, AVRTOS_SHELL_RX_BUFFER_SIZE);
+
+void avrtos_shell_rx_init_impl(void) {
+    /* baud rate and data frame format are shared with the logger, enable
+       receiver and USART Rx interrupt */
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, RXEN0);
+    AVRTOS_SET_BIT_IN_REGISTER(UCSR0B, RXCIE0);
+}
+
+bool avrtos_shell_getc_impl(char *c) {
+    return spsc_ring_get_one(&g_shell_rx_ring, c) == CIRC_BUFF_OK;
+}
+#endif // AVRTOS_WITH_SHELL && AVRTOS_WITH_USART
+
 void avrtos_sched_timer_reset_impl(void) {
     TCNT0 = 0;
 }
@@ -122,31 +486,134 @@ void avrtos_delay_timer_init_impl(void) {
     AVRTOS_SET_BIT_IN_REGISTER(TIMSK2, OCIE2A);
 }
 
-uint64_t avrtos_delay_get_microseconds_impl(void) {
-    uint64_t ret;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        ret = g_microseconds_counter;
+avrtos_tick_t avrtos_delay_get_ticks_impl(void) {
+    avrtos_tick_t ret;
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_TICKS) {
+        ret = g_ticks_counter;
     }
 
     return ret;
 }
 
-ISR(TIMER2_COMPA_vect) {
+uint64_t avrtos_delay_get_microseconds_impl(void) {
+    return (uint64_t) avrtos_delay_get_ticks_impl()
+           * AVRTOS_DELAY_TICK_PERIOD_US;
+}
+
+uint8_t avrtos_irq_lock_impl(void) {
+    uint8_t sreg = SREG;
+    cli();
+    return sreg;
+}
+
+void avrtos_irq_unlock_impl(uint8_t key) {
+    SREG = key;
+}
+
+#ifdef AVRTOS_WITH_TRACE
+void avrtos_trace_timestamp_impl(uint16_t *ticks, uint8_t *subticks) {
+    /* called with interrupts disabled */
+    uint8_t count = TCNT2;
+    uint16_t now = (uint16_t) g_ticks_counter;
+    if (TIFR2 & (1 << OCF2A)) {
+        /* the timer has wrapped, but the tick has not been counted yet */
+        count = TCNT2;
+        now++;
+    }
+    *ticks = now;
+    *subticks = count;
+}
+
+uint8_t avrtos_trace_get_subticks_per_tick_impl(void) {
+    return OCR2A + 1;
+}
+#endif // AVRTOS_WITH_TRACE
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+void avrtos_cs_timer_init_impl(void) {
+    /* free-running TIMER1 counting CPU clock / AVRTOS_CS_TIMER_PRESCALER, it
+       keeps counting with interrupts disabled */
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TIMSK1 = 0;
+    TCNT1 = 0;
+    AVRTOS_SET_BIT_IN_REGISTER(TCCR1B, CS11);
+}
+
+uint16_t avrtos_cs_timer_count_impl(void) {
+    return TCNT1;
+}
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+AVRTOS_ISR(TIMER2_COMPA_vect) {
     /* Not gonna lie, I'm lazy on that one. I've set it to fixed value based on
        (1 MHz CPU clock) * (multiplier). This should be configurable in a
        prettier way. */
-    g_microseconds_counter += 100;
+    g_ticks_counter++;
 }
 
-#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
-ISR(USART_UDRE_vect) {
+#ifdef AVRTOS_WITH_USART
+AVRTOS_ISR(USART_RX_vect) {
+    /* status flags are valid until UDR0 is read */
+    bool error = UCSR0A & ((1 << FE0) | (1 << DOR0));
+    _avrtos_usart_rx_isr(UDR0, error);
+}
+
+AVRTOS_ISR(USART_UDRE_vect) {
+    uint8_t value;
+    if (_avrtos_usart_tx_isr(&value)) {
+        UDR0 = value;
+    } else {
+        AVRTOS_CLEAR_BIT_IN_REGISTER(UCSR0B, UDRIE0);
+    }
+}
+#elif defined(AVRTOS_WITH_ASYNCHRONOUS_LOGGER)
+AVRTOS_ISR(USART_UDRE_vect) {
     char value;
-    if (circ_buff_get_one(&g_logger_circ_buff, &value) == CIRC_BUFF_OK) {
+    if (spsc_ring_get_one(&g_logger_circ_buff, &value) == CIRC_BUFF_OK) {
         UDR0 = value;
     } else {
         AVRTOS_CLEAR_BIT_IN_REGISTER(UCSR0B, UDRIE0);
     }
 }
-#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+#endif // AVRTOS_WITH_USART
+
+#ifdef AVRTOS_WITH_SPI
+AVRTOS_ISR(SPI_STC_vect) {
+    uint8_t next;
+    if (_avrtos_spi_isr(SPDR, &next)) {
+        SPDR = next;
+    }
+}
+#endif // AVRTOS_WITH_SPI
+
+#ifdef AVRTOS_WITH_TWI
+AVRTOS_ISR(TWI_vect) {
+    _avrtos_twi_isr(TW_STATUS, TWDR);
+}
+#endif // AVRTOS_WITH_TWI
+
+#ifdef AVRTOS_WITH_ADC
+AVRTOS_ISR(ADC_vect) {
+    /* compare match B triggers the next conversion only once its flag has
+       been cleared */
+    TIFR1 = (1 << OCF1B);
+    _avrtos_adc_isr(ADC);
+}
+#endif // AVRTOS_WITH_ADC
+
+#ifdef AVRTOS_WITH_EEPROM
+AVRTOS_ISR(EE_READY_vect) {
+    _avrtos_eeprom_isr();
+}
+#endif // AVRTOS_WITH_EEPROM
+
+#if defined(AVRTOS_WITH_SHELL) && !defined(AVRTOS_WITH_USART)
+AVRTOS_ISR(USART_RX_vect) {
+    /* reading UDR0 clears the interrupt, characters that do not fit are lost */
+    char value = UDR0;
+    (void) spsc_ring_insert_one(&g_shell_rx_ring, value);
+}
+#endif // AVRTOS_WITH_SHELL && !AVRTOS_WITH_USART
 
 #endif // defined(__AVR_ATmega328P__)
@@ -2,17 +2,45 @@
 #define AVRTOS_BOARD_IMPL_H_
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stddef.h>
 
+#include "../avrtos_config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
 
+/**
+ * Delay timer tick type. Its width limits the longest possible delay.
+ */
+typedef uint32_t avrtos_tick_t;
+
+/**
+ * Period of the delay timer tick in microseconds.
+ */
+#define AVRTOS_DELAY_TICK_PERIOD_US 100
+
+/**
+ * CPU cycles per count of the critical section timer.
+ */
+#define AVRTOS_CS_TIMER_PRESCALER 8
+
+/**
+ * Size of the EEPROM in bytes.
+ */
+#define AVRTOS_EEPROM_SIZE 1024
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+#define AVRTOS_NON_PREEMPTIVE_SECTION() \
+    AVRTOS_NON_PREEMPTIVE_SECTION_AT(AVRTOS_CS_SITE_NON_PREEMPTIVE)
+#else // AVRTOS_WITH_CRITICAL_SECTION_STATS
 #define AVRTOS_NON_PREEMPTIVE_SECTION()                                   \
     for (bool AVRTOS_CONCAT(_run, __LINE__) =                             \
                  (avrtos_sched_timer_stop_impl(), true);                  \
          AVRTOS_CONCAT(_run, __LINE__); avrtos_sched_timer_resume_impl(), \
                                   AVRTOS_CONCAT(_run, __LINE__) = false)
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
 
 void avrtos_sched_timer_init_impl(void);
 void avrtos_sched_timer_reset_impl(void);
@@ -20,13 +48,63 @@ void avrtos_sched_timer_stop_impl();
 void avrtos_sched_timer_resume_impl();
 
 void avrtos_logger_init_impl(void);
-void avrtos_handle_log_buffer_impl(char *buffer, size_t buf_len);
+void avrtos_log_lock_impl(void);
+void avrtos_log_unlock_impl(void);
+bool avrtos_log_put_impl(char c, bool wait);
+bool avrtos_log_finish_impl(char c, bool wait);
+void avrtos_log_discard_impl(void);
+bool avrtos_log_write_impl(const char *data, size_t len, bool wait);
+
+void avrtos_shell_rx_init_impl(void);
+bool avrtos_shell_getc_impl(char *c);
+
+void avrtos_usart_init_impl(void);
+void avrtos_usart_tx_start_impl(void);
+
+void avrtos_spi_init_impl(void);
+void avrtos_spi_configure_impl(uint32_t frequency,
+                               uint8_t mode,
+                               bool lsb_first);
+void avrtos_spi_start_impl(uint8_t first);
+void avrtos_spi_stop_impl(void);
+
+void avrtos_twi_init_impl(void);
+void avrtos_twi_start_impl(void);
+void avrtos_twi_repeated_start_impl(void);
+void avrtos_twi_write_impl(uint8_t value);
+void avrtos_twi_read_impl(bool ack);
+void avrtos_twi_finish_impl(bool stop);
+
+bool avrtos_adc_start_impl(uint8_t channel, uint32_t conversion_rate);
+void avrtos_adc_stop_impl(void);
+bool avrtos_adc_busy_impl(void);
+void avrtos_adc_select_impl(uint8_t channel);
+
+uint8_t avrtos_eeprom_read_impl(uint16_t address);
+void avrtos_eeprom_write_impl(uint16_t address, uint8_t value);
+void avrtos_eeprom_ready_enable_impl(void);
+void avrtos_eeprom_ready_disable_impl(void);
 
 void avrtos_delay_timer_init_impl(void);
+avrtos_tick_t avrtos_delay_get_ticks_impl(void);
 uint64_t avrtos_delay_get_microseconds_impl(void);
 
+uint8_t avrtos_irq_lock_impl(void);
+void avrtos_irq_unlock_impl(uint8_t key);
+
+void avrtos_trace_timestamp_impl(uint16_t *ticks, uint8_t *subticks);
+uint8_t avrtos_trace_get_subticks_per_tick_impl(void);
+
+void avrtos_cs_timer_init_impl(void);
+uint16_t avrtos_cs_timer_count_impl(void);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
 
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+/* after the declarations, the instrumented sections are inline functions */
+#include "../critical_section_arch_ind.h"
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
 #endif /* AVRTOS_BOARD_IMPL_H_ */
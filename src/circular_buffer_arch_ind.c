@@ -1,5 +1,55 @@
+#include <string.h>
+
 #include "circular_buffer_arch_ind.h"
 
+/* Returns the index right behind the last element. */
+static size_t _circ_buff_tail(struct circular_buffer *circ_buff) {
+    size_t tail = circ_buff->head + circ_buff->occupancy;
+    if (tail >= circ_buff->capacity) {
+        tail -= circ_buff->capacity;
+    }
+
+    return tail;
+}
+
+/* Returns the length of the contiguous free region starting at the tail. */
+static size_t _circ_buff_free_contiguous(struct circular_buffer *circ_buff,
+                                         size_t tail) {
+    size_t space_left = circ_buff->capacity - circ_buff->occupancy;
+    size_t to_end = circ_buff->capacity - tail;
+
+    return space_left < to_end ? space_left : to_end;
+}
+
+/* Copies count elements (count <= space left) behind the last element, in at
+   most two contiguous segments. */
+static void _circ_buff_copy_in(struct circular_buffer *circ_buff,
+                               const char *values,
+                               size_t count) {
+    size_t tail = _circ_buff_tail(circ_buff);
+    size_t first_segment = circ_buff->capacity - tail;
+    if (first_segment > count) {
+        first_segment = count;
+    }
+    memcpy(&circ_buff->data[tail], values, first_segment);
+    memcpy(circ_buff->data, &values[first_segment], count - first_segment);
+    circ_buff->occupancy += count;
+}
+
+/* Copies count elements (count <= occupancy) from the front of the buffer, in
+   at most two contiguous segments, and removes them. */
+static void _circ_buff_copy_out(struct circular_buffer *circ_buff,
+                                char *out_values,
+                                size_t count) {
+    size_t first_segment = circ_buff->capacity - circ_buff->head;
+    if (first_segment > count) {
+        first_segment = count;
+    }
+    memcpy(out_values, &circ_buff->data[circ_buff->head], first_segment);
+    memcpy(&out_values[first_segment], circ_buff->data, count - first_segment);
+    (void) circ_buff_consume(circ_buff, count);
+}
+
 enum circular_buffer_status circ_buff_initialize(
         struct circular_buffer *circ_buff, char *buffer, size_t size) {
     if (!(circ_buff && buffer && size > 0)) {
@@ -21,8 +71,13 @@ circ_buff_insert_one(struct circular_buffer *circ_buff, char value) {
     if (!circ_buff_has_space_for_one(circ_buff)) {
         return CIRC_BUFF_FULL;
     }
-    circ_buff->data[(circ_buff->head + circ_buff->occupancy)
-                    % circ_buff->capacity] = value;
+    /* head < capacity and occupancy < capacity, so a single subtraction
+       replaces the modulo operation */
+    size_t index = circ_buff->head + circ_buff->occupancy;
+    if (index >= circ_buff->capacity) {
+        index -= circ_buff->capacity;
+    }
+    circ_buff->data[index] = value;
     circ_buff->occupancy++;
 
     return CIRC_BUFF_OK;
@@ -33,13 +88,53 @@ enum circular_buffer_status circ_buff_insert_few(
     if (!(circ_buff && values)) {
         return CIRC_BUFF_INVALID;
     }
-    size_t space_left;
-    circ_buff_get_space_left(circ_buff, &space_left);
-    if (space_left < count) {
+    if (circ_buff->capacity - circ_buff->occupancy < count) {
         return CIRC_BUFF_FULL;
     }
-    for (size_t i = 0; i < count; i++) {
-        circ_buff_insert_one(circ_buff, values[i]);
+    _circ_buff_copy_in(circ_buff, values, count);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_insert_partial(struct circular_buffer *circ_buff,
+                         const char *values,
+                         size_t count,
+                         size_t *out_inserted) {
+    if (!(circ_buff && values && out_inserted)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t space_left = circ_buff->capacity - circ_buff->occupancy;
+    size_t to_insert = count < space_left ? count : space_left;
+    _circ_buff_copy_in(circ_buff, values, to_insert);
+    *out_inserted = to_insert;
+
+    return (count > 0 && to_insert == 0) ? CIRC_BUFF_FULL : CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_insert_overwrite(struct circular_buffer *circ_buff,
+                           const char *values,
+                           size_t count,
+                           size_t *out_overwritten) {
+    if (!(circ_buff && values)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t overwritten = 0;
+    if (count > circ_buff->capacity) {
+        /* the oldest part of the input would be overwritten anyway */
+        overwritten = count - circ_buff->capacity;
+        values += overwritten;
+        count = circ_buff->capacity;
+    }
+    size_t space_left = circ_buff->capacity - circ_buff->occupancy;
+    if (count > space_left) {
+        (void) circ_buff_consume(circ_buff, count - space_left);
+        overwritten += count - space_left;
+    }
+    _circ_buff_copy_in(circ_buff, values, count);
+    if (out_overwritten) {
+        *out_overwritten = overwritten;
     }
 
     return CIRC_BUFF_OK;
@@ -54,7 +149,9 @@ enum circular_buffer_status circ_buff_get_one(struct circular_buffer *circ_buff,
         return CIRC_BUFF_EMPTY;
     }
     *out_value = circ_buff->data[circ_buff->head++];
-    circ_buff->head %= circ_buff->capacity;
+    if (circ_buff->head == circ_buff->capacity) {
+        circ_buff->head = 0;
+    }
     circ_buff->occupancy--;
 
     return CIRC_BUFF_OK;
@@ -66,14 +163,81 @@ enum circular_buffer_status circ_buff_get_few(struct circular_buffer *circ_buff,
     if (!(circ_buff && out_values)) {
         return CIRC_BUFF_INVALID;
     }
-    size_t occupancy;
-    circ_buff_get_occupancy(circ_buff, &occupancy);
-    if (occupancy < count) {
+    if (circ_buff->occupancy < count) {
         return CIRC_BUFF_EMPTY;
     }
-    for (size_t i = 0; i < count; i++) {
-        circ_buff_get_one(circ_buff, &out_values[i]);
+    _circ_buff_copy_out(circ_buff, out_values, count);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_get_partial(struct circular_buffer *circ_buff,
+                      char *out_values,
+                      size_t count,
+                      size_t *out_retrieved) {
+    if (!(circ_buff && out_values && out_retrieved)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t to_retrieve =
+            count < circ_buff->occupancy ? count : circ_buff->occupancy;
+    _circ_buff_copy_out(circ_buff, out_values, to_retrieve);
+    *out_retrieved = to_retrieve;
+
+    return (count > 0 && to_retrieve == 0) ? CIRC_BUFF_EMPTY : CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status circ_buff_reserve(struct circular_buffer *circ_buff,
+                                              char **out_ptr,
+                                              size_t *out_len) {
+    if (!(circ_buff && out_ptr && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t tail = _circ_buff_tail(circ_buff);
+    *out_ptr = &circ_buff->data[tail];
+    *out_len = _circ_buff_free_contiguous(circ_buff, tail);
+
+    return *out_len ? CIRC_BUFF_OK : CIRC_BUFF_FULL;
+}
+
+enum circular_buffer_status circ_buff_commit(struct circular_buffer *circ_buff,
+                                             size_t count) {
+    if (!circ_buff) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t tail = _circ_buff_tail(circ_buff);
+    if (count > _circ_buff_free_contiguous(circ_buff, tail)) {
+        return CIRC_BUFF_INVALID;
+    }
+    circ_buff->occupancy += count;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_peek_contiguous(struct circular_buffer *circ_buff,
+                          char **out_ptr,
+                          size_t *out_len) {
+    if (!(circ_buff && out_ptr && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t to_end = circ_buff->capacity - circ_buff->head;
+    *out_ptr = &circ_buff->data[circ_buff->head];
+    *out_len = circ_buff->occupancy < to_end ? circ_buff->occupancy : to_end;
+
+    return *out_len ? CIRC_BUFF_OK : CIRC_BUFF_EMPTY;
+}
+
+enum circular_buffer_status circ_buff_consume(struct circular_buffer *circ_buff,
+                                              size_t count) {
+    if (!circ_buff || count > circ_buff->occupancy) {
+        return CIRC_BUFF_INVALID;
+    }
+    circ_buff->head += count;
+    if (circ_buff->head >= circ_buff->capacity) {
+        circ_buff->head -= circ_buff->capacity;
     }
+    circ_buff->occupancy -= count;
 
     return CIRC_BUFF_OK;
 }
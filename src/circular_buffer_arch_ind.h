@@ -79,6 +79,53 @@ circ_buff_insert_one(struct circular_buffer *circ_buff, char value);
 enum circular_buffer_status circ_buff_insert_few(
         struct circular_buffer *circ_buff, char *values, size_t count);
 
+/**
+ * Inserts as many of @ref count elements as there is space for. The data is
+ * copied in at most two contiguous segments.
+ *
+ * @param circ_buff    Pointer to non NULL circular buffer.
+ *
+ * @param values       Pointer to non NULL value array.
+ *
+ * @param count        Number of elements we want to insert into the buffer.
+ *
+ * @param out_inserted Pointer to the non NULL variable to which the number of
+ *                     inserted elements will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff, values or out_inserted are NULL,
+ *          CIRC_BUFF_FULL if count is not zero and no element was inserted,
+ *          CIRC_BUFF_OK otherwise (also if only a part was inserted).
+ */
+enum circular_buffer_status
+circ_buff_insert_partial(struct circular_buffer *circ_buff,
+                         const char *values,
+                         size_t count,
+                         size_t *out_inserted);
+
+/**
+ * Inserts @ref count elements, removing the oldest elements if there is not
+ * enough space (drop-oldest policy), so the insertion never fails for lack of
+ * space. If @ref count is greater than the capacity, only the last capacity
+ * elements are kept.
+ *
+ * @param circ_buff       Pointer to non NULL circular buffer.
+ *
+ * @param values          Pointer to non NULL value array.
+ *
+ * @param count           Number of elements we want to insert into the buffer.
+ *
+ * @param out_overwritten Pointer to the variable to which the number of
+ *                        dropped elements will be copied, may be NULL.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or values are NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_insert_overwrite(struct circular_buffer *circ_buff,
+                           const char *values,
+                           size_t count,
+                           size_t *out_overwritten);
+
 /**
  * Gets one value from the buffer.
  *
@@ -114,6 +161,108 @@ enum circular_buffer_status circ_buff_get_few(struct circular_buffer *circ_buff,
                                               char *out_values,
                                               size_t count);
 
+/**
+ * Gets up to @ref count elements from the buffer. The data is copied out in at
+ * most two contiguous segments.
+ *
+ * @param circ_buff     Pointer to non NULL circular buffer.
+ *
+ * @param out_values    Pointer to the non NULL arary to which the result will
+ *                      be copied.
+ *
+ * @param count         Maximum number of elements we want to retrieve.
+ *
+ * @param out_retrieved Pointer to the non NULL variable to which the number of
+ *                      retrieved elements will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff, out_values or out_retrieved are
+ *          NULL,
+ *          CIRC_BUFF_EMPTY if count is not zero and no element was retrieved,
+ *          CIRC_BUFF_OK otherwise (also if only a part was retrieved).
+ */
+enum circular_buffer_status
+circ_buff_get_partial(struct circular_buffer *circ_buff,
+                      char *out_values,
+                      size_t count,
+                      size_t *out_retrieved);
+
+/**
+ * Gets the contiguous free region behind the last element, so the producer can
+ * write into the buffer directly. The written elements become visible after
+ * @ref circ_buff_commit. The region ends at the end of the data buffer, so it
+ * may be shorter than the space left.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param out_ptr   Pointer to the non NULL variable to which the start of the
+ *                  region will be copied.
+ *
+ * @param out_len   Pointer to the non NULL variable to which the length of the
+ *                  region will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff, out_ptr or out_len are NULL,
+ *          CIRC_BUFF_FULL if there is no space in the buffer,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status circ_buff_reserve(struct circular_buffer *circ_buff,
+                                              char **out_ptr,
+                                              size_t *out_len);
+
+/**
+ * Appends @ref count elements written into the region returned by
+ * @ref circ_buff_reserve.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param count     Number of written elements, not greater than the reserved
+ *                  length.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff is NULL or count is greater than the
+ *          contiguous free region,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status circ_buff_commit(struct circular_buffer *circ_buff,
+                                             size_t count);
+
+/**
+ * Gets the contiguous region of elements starting at the first element, so
+ * the consumer can read them directly. The elements are removed by
+ * @ref circ_buff_consume. The region ends at the end of the data buffer, so it
+ * may be shorter than the occupancy.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param out_ptr   Pointer to the non NULL variable to which the start of the
+ *                  region will be copied.
+ *
+ * @param out_len   Pointer to the non NULL variable to which the length of the
+ *                  region will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff, out_ptr or out_len are NULL,
+ *          CIRC_BUFF_EMPTY if there are no elements in the buffer,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_peek_contiguous(struct circular_buffer *circ_buff,
+                          char **out_ptr,
+                          size_t *out_len);
+
+/**
+ * Removes @ref count elements from the front of the buffer, e.g. after they
+ * were read using @ref circ_buff_peek_contiguous.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param count     Number of elements to remove, not greater than the
+ *                  occupancy.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff is NULL or count is greater than the
+ *          occupancy,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status circ_buff_consume(struct circular_buffer *circ_buff,
+                                              size_t count);
+
 /**
  * Gets the capacity (size, number of elements it can hold) of the buffer.
  *
@@ -0,0 +1,127 @@
+#include "circular_buffer_pow2_arch_ind.h"
+
+enum circular_buffer_status circ_buff_pow2_initialize(
+        struct circular_buffer_pow2 *circ_buff, char *buffer, size_t size) {
+    if (!(circ_buff && buffer && size > 0 && (size & (size - 1)) == 0
+          && size <= CIRC_BUFF_POW2_MAX_SIZE)) {
+        return CIRC_BUFF_INVALID;
+    }
+    circ_buff->data = buffer;
+    circ_buff->mask = (uint8_t)(size - 1);
+    circ_buff->head = 0;
+    circ_buff->tail = 0;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_insert_one(struct circular_buffer_pow2 *circ_buff, char value) {
+    if (!circ_buff) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (circ_buff_pow2_is_full(circ_buff)) {
+        return CIRC_BUFF_FULL;
+    }
+    circ_buff->data[circ_buff->tail & circ_buff->mask] = value;
+    circ_buff->tail++;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_insert_few(struct circular_buffer_pow2 *circ_buff,
+                          char *values,
+                          size_t count) {
+    if (!(circ_buff && values)) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (_circ_buff_pow2_space_left(circ_buff) < count) {
+        return CIRC_BUFF_FULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        circ_buff->data[circ_buff->tail & circ_buff->mask] = values[i];
+        circ_buff->tail++;
+    }
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_get_one(struct circular_buffer_pow2 *circ_buff,
+                       char *out_value) {
+    if (!(circ_buff && out_value)) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (circ_buff_pow2_is_empty(circ_buff)) {
+        return CIRC_BUFF_EMPTY;
+    }
+    *out_value = circ_buff->data[circ_buff->head & circ_buff->mask];
+    circ_buff->head++;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_get_few(struct circular_buffer_pow2 *circ_buff,
+                       char *out_values,
+                       size_t count) {
+    if (!(circ_buff && out_values)) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (_circ_buff_pow2_occupancy(circ_buff) < count) {
+        return CIRC_BUFF_EMPTY;
+    }
+    for (size_t i = 0; i < count; i++) {
+        out_values[i] = circ_buff->data[circ_buff->head & circ_buff->mask];
+        circ_buff->head++;
+    }
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_get_capacity(struct circular_buffer_pow2 *circ_buff,
+                            size_t *out_capacity) {
+    if (!(circ_buff && out_capacity)) {
+        return CIRC_BUFF_INVALID;
+    }
+
+    *out_capacity = (size_t) circ_buff->mask + 1;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_get_occupancy(struct circular_buffer_pow2 *circ_buff,
+                             size_t *out_occupancy) {
+    if (!(circ_buff && out_occupancy)) {
+        return CIRC_BUFF_INVALID;
+    }
+
+    *out_occupancy = _circ_buff_pow2_occupancy(circ_buff);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_get_space_left(struct circular_buffer_pow2 *circ_buff,
+                              size_t *out_space_left) {
+    if (!(circ_buff && out_space_left)) {
+        return CIRC_BUFF_INVALID;
+    }
+
+    *out_space_left = _circ_buff_pow2_space_left(circ_buff);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+circ_buff_pow2_reset(struct circular_buffer_pow2 *circ_buff) {
+    if (!circ_buff) {
+        return CIRC_BUFF_INVALID;
+    }
+    circ_buff->head = 0;
+    circ_buff->tail = 0;
+
+    return CIRC_BUFF_OK;
+}
@@ -0,0 +1,249 @@
+#ifndef CIRCULAR_BUFFER_POW2_ARCH_IND_H_
+#define CIRCULAR_BUFFER_POW2_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "circular_buffer_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * Maximum capacity of @ref struct circular_buffer_pow2. Indices are 8-bit
+ * free-running counters, so the occupancy (difference of the indices) has to
+ * fit in 8 bits as well.
+ */
+#define CIRC_BUFF_POW2_MAX_SIZE 128
+
+/**
+ * Power-of-two size circular buffer. Indexing uses a bit mask instead of the
+ * modulo operation, and both indices are single bytes. Functions mirror the
+ * @ref struct circular_buffer API and return the same status codes.
+ */
+struct circular_buffer_pow2 {
+    char *data;
+    uint8_t mask;
+    uint8_t head;
+    uint8_t tail;
+};
+
+/**
+ * Compile-time sized circular buffer definition. The data buffer is defined
+ * as well.
+ *
+ * @param BuffName Name of the circular buffer identifier.
+ *
+ * @param Size     Capacity of the buffer. Must be a power of two, not greater
+ *                 than @ref CIRC_BUFF_POW2_MAX_SIZE.
+ */
+#define CIRC_BUFF_POW2_DEFINE(BuffName, Size)                              \
+    AVRTOS_STATIC_ASSERT((Size) > 0 && ((Size) & ((Size) - 1)) == 0       \
+                                 && (Size) <= CIRC_BUFF_POW2_MAX_SIZE,     \
+                         BuffName##_SizeIsNotValidPowerOfTwo);             \
+    char BuffName##_data[Size];                                            \
+    struct circular_buffer_pow2 BuffName = {.data = BuffName##_data,       \
+                                            .mask = (uint8_t)((Size) - 1), \
+                                            .head = 0,                     \
+                                            .tail = 0}
+
+/**
+ * Initializes circular buffer. Requires a pointer to non NULL circular buffer,
+ * data buffer and data buffer's size.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param buffer    Pointer to non NULL data buffer.
+ *
+ * @param size      Size of @ref buffer. Must be a power of two, not greater
+ *                  than @ref CIRC_BUFF_POW2_MAX_SIZE.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or buffer are NULL or size is not a
+ *          valid power of two,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status circ_buff_pow2_initialize(
+        struct circular_buffer_pow2 *circ_buff, char *buffer, size_t size);
+
+/**
+ * Inserts one element into the buffer.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param value     A value we want to insert into the buffer.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff is NULL,
+ *          CIRC_BUFF_FULL if there is no space in the buffer,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_insert_one(struct circular_buffer_pow2 *circ_buff, char value);
+
+/**
+ * Insert a various number of elements into the buffer. If there is no space for
+ * all @ref count elements, does not insert any element and returns.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param values    Pointer to non NULL value array.
+ *
+ * @param count     Number of elements we want to insert into the buffer.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or values are NULL,
+ *          CIRC_BUFF_FULL if there is no space for all the elements,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_insert_few(struct circular_buffer_pow2 *circ_buff,
+                          char *values,
+                          size_t count);
+
+/**
+ * Gets one value from the buffer.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @param out_value Pointer to the non NULL variable to which the result will be
+ *                  copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or out_value are NULL,
+ *          CIRC_BUFF_EMPTY if there is no value to retrieve,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_get_one(struct circular_buffer_pow2 *circ_buff, char *out_value);
+
+/**
+ * Gets a various number of elements from the buffer. If there is less elements
+ * in the buffer that @ref count, does not modify the @ref out_values array.
+ *
+ * @param circ_buff  Pointer to non NULL circular buffer.
+ *
+ * @param out_values Pointer to the non NULL arary to which the result will be
+ *                   copied.
+ *
+ * @param count      Number of elements we want to retrieve from the buffer.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or out_values are NULL,
+ *          CIRC_BUFF_EMPTY if there is not enough values in the buffer to
+ *          retrieve,
+ *          CIRC_BUFF_OK otherwise
+ */
+enum circular_buffer_status
+circ_buff_pow2_get_few(struct circular_buffer_pow2 *circ_buff,
+                       char *out_values,
+                       size_t count);
+
+/**
+ * Gets the capacity (size, number of elements it can hold) of the buffer.
+ *
+ * @param circ_buff    Pointer to non NULL circular buffer.
+ *
+ * @param out_capacity Pointer to the non NULL variable to which the capacity
+ *                     will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or out_capacity are NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_get_capacity(struct circular_buffer_pow2 *circ_buff,
+                            size_t *out_capacity);
+
+/**
+ * Gets the occupancy (number of elements that are currently in the buffer) of
+ * the buffer.
+ *
+ * @param circ_buff     Pointer to non NULL circular buffer.
+ *
+ * @param out_occupancy Pointer to the non NULL variable to which the occupancy
+ *                      will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or out_occupancy are NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_get_occupancy(struct circular_buffer_pow2 *circ_buff,
+                             size_t *out_occupancy);
+
+/**
+ * Gets the number of elements that can be inserted into the buffer at the
+ * moment.
+ *
+ * @param circ_buff      Pointer to non NULL circular buffer.
+ *
+ * @param out_space_left Pointer to the non NULL variable to which the space
+ *                       left will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff or out_space_left are NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_get_space_left(struct circular_buffer_pow2 *circ_buff,
+                              size_t *out_space_left);
+
+/**
+ * Returns the number of elements in the buffer. Does not check @p circ_buff.
+ * Should be a "private" function.
+ */
+static inline uint8_t
+_circ_buff_pow2_occupancy(struct circular_buffer_pow2 *circ_buff) {
+    return (uint8_t)(circ_buff->tail - circ_buff->head);
+}
+
+/**
+ * Returns the number of free elements in the buffer. Does not check
+ * @p circ_buff. Should be a "private" function.
+ */
+static inline uint8_t
+_circ_buff_pow2_space_left(struct circular_buffer_pow2 *circ_buff) {
+    return (uint8_t)(circ_buff->mask + 1
+                     - _circ_buff_pow2_occupancy(circ_buff));
+}
+
+/**
+ * Checks wether the buffer is full.
+ *
+ * @param circ_buff Pointer to circular buffer.
+ *
+ * @returns true if there is no space left in the buffer or the circ_buff is
+ *          NULL,
+ *          false otherwise.
+ */
+static inline bool
+circ_buff_pow2_is_full(struct circular_buffer_pow2 *circ_buff) {
+    return circ_buff ? _circ_buff_pow2_space_left(circ_buff) == 0 : true;
+}
+
+/**
+ * Checks wether the buffer is empty.
+ *
+ * @param circ_buff Pointer to circular buffer.
+ *
+ * @returns true if there are no elements in the buffer or the circ_buff is NULL
+ *          false otherwise.
+ */
+static inline bool
+circ_buff_pow2_is_empty(struct circular_buffer_pow2 *circ_buff) {
+    return circ_buff ? circ_buff->head == circ_buff->tail : true;
+}
+
+/**
+ * Removes all elements from the buffer. Does not clear the buffer.
+ *
+ * @param circ_buff Pointer to non NULL circular buffer.
+ *
+ * @returns CIRC_BUFF_INVALID if circ_buff is NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+circ_buff_pow2_reset(struct circular_buffer_pow2 *circ_buff);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* CIRCULAR_BUFFER_POW2_ARCH_IND_H_ */
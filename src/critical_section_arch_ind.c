@@ -0,0 +1,92 @@
+#include "critical_section_arch_ind.h"
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+/* written by tasks and ISRs with interrupts disabled */
+static struct avrtos_cs_stats g_cs_stats[AVRTOS_CS_SITE_COUNT];
+
+/* scheduler interrupt windows, only touched by the scheduler interrupt */
+static uint16_t g_cs_scheduler_start;
+static uint16_t g_cs_scheduler_elapsed;
+
+static uint8_t cs_histogram_bucket(uint16_t duration) {
+    uint8_t bucket = 0;
+    duration >>= AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS;
+    while (duration && bucket < AVRTOS_CS_HISTOGRAM_BUCKETS - 1) {
+        duration >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+bool avrtos_cs_stats_get(uint8_t site, struct avrtos_cs_stats *out_stats) {
+    if (site >= AVRTOS_CS_SITE_COUNT || !out_stats) {
+        return false;
+    }
+
+    uint8_t key = avrtos_irq_lock_impl();
+    *out_stats = g_cs_stats[site];
+    avrtos_irq_unlock_impl(key);
+
+    return true;
+}
+
+uint16_t avrtos_cs_stats_get_worst(uint8_t *out_site) {
+    uint16_t worst = 0;
+    uint8_t worst_site = 0;
+    for (uint8_t site = 0; site < AVRTOS_CS_SITE_COUNT; site++) {
+        uint8_t key = avrtos_irq_lock_impl();
+        uint16_t max = g_cs_stats[site].max;
+        avrtos_irq_unlock_impl(key);
+
+        if (max > worst) {
+            worst = max;
+            worst_site = site;
+        }
+    }
+
+    if (out_site) {
+        *out_site = worst_site;
+    }
+    return worst;
+}
+
+void avrtos_cs_stats_reset(void) {
+    for (uint8_t site = 0; site < AVRTOS_CS_SITE_COUNT; site++) {
+        uint8_t key = avrtos_irq_lock_impl();
+        g_cs_stats[site] = (struct avrtos_cs_stats){0};
+        avrtos_irq_unlock_impl(key);
+    }
+}
+
+void _avrtos_cs_record(uint8_t site, uint16_t duration) {
+    if (site >= AVRTOS_CS_SITE_COUNT) {
+        return;
+    }
+
+    uint8_t key = avrtos_irq_lock_impl();
+    struct avrtos_cs_stats *stats = &g_cs_stats[site];
+    if (duration > stats->max) {
+        stats->max = duration;
+    }
+    uint16_t *counter = &stats->histogram[cs_histogram_bucket(duration)];
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+    avrtos_irq_unlock_impl(key);
+}
+
+void _avrtos_cs_scheduler_begin(void) {
+    g_cs_scheduler_start = avrtos_cs_timer_count_impl();
+}
+
+void _avrtos_cs_scheduler_end(bool last) {
+    g_cs_scheduler_elapsed +=
+            (uint16_t) (avrtos_cs_timer_count_impl() - g_cs_scheduler_start);
+    if (last) {
+        _avrtos_cs_record(AVRTOS_CS_SITE_SCHEDULER, g_cs_scheduler_elapsed);
+        g_cs_scheduler_elapsed = 0;
+    }
+}
+
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
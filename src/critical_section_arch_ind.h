@@ -0,0 +1,237 @@
+#ifndef CRITICAL_SECTION_ARCH_IND_H_
+#define CRITICAL_SECTION_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "boards/avrtos_board_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+#ifndef AVRTOS_CS_USER_SITES
+#define AVRTOS_CS_USER_SITES 2
+#endif // AVRTOS_CS_USER_SITES
+
+#ifndef AVRTOS_CS_HISTOGRAM_BUCKETS
+#define AVRTOS_CS_HISTOGRAM_BUCKETS 8
+#endif // AVRTOS_CS_HISTOGRAM_BUCKETS
+
+#ifndef AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS
+#define AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS 4
+#endif // AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS
+
+/* the bound of the last but one bucket should fit in 16 bits */
+AVRTOS_STATIC_ASSERT(AVRTOS_CS_HISTOGRAM_BUCKETS >= 2
+                             && AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS
+                                                + AVRTOS_CS_HISTOGRAM_BUCKETS
+                                        <= 17,
+                     CriticalSectionHistogramIsNotValid);
+
+/**
+ * Instrumented call sites. The scheduler site covers the parts of the
+ * scheduler interrupt that run with interrupts disabled after the task
+ * registers have been saved and before they are restored, the fixed-length
+ * register save and restore sequences are not included. The non-preemptive
+ * site covers AVRTOS_NON_PREEMPTIVE_SECTION(), which keeps interrupts enabled
+ * and only stops the scheduler timer. The application can use
+ * AVRTOS_CS_SITE_USER(0) to AVRTOS_CS_SITE_USER(AVRTOS_CS_USER_SITES - 1).
+ */
+enum avrtos_cs_site {
+    AVRTOS_CS_SITE_SCHEDULER,
+    AVRTOS_CS_SITE_YIELD,
+    AVRTOS_CS_SITE_DELAY,
+    AVRTOS_CS_SITE_TICKS,
+#ifdef AVRTOS_WITH_MUTEX
+    AVRTOS_CS_SITE_MUTEX_LOCK,
+    AVRTOS_CS_SITE_MUTEX_UNLOCK,
+#endif // AVRTOS_WITH_MUTEX
+#ifdef AVRTOS_WITH_COMPLETION
+    AVRTOS_CS_SITE_COMPLETION,
+#endif // AVRTOS_WITH_COMPLETION
+#ifdef AVRTOS_WITH_COROUTINES
+    AVRTOS_CS_SITE_CORO_SEM_GIVE,
+    AVRTOS_CS_SITE_CORO_SEM_TAKE,
+    AVRTOS_CS_SITE_CORO_QUEUE_PUT,
+    AVRTOS_CS_SITE_CORO_QUEUE_GET,
+#endif // AVRTOS_WITH_COROUTINES
+#ifdef AVRTOS_WITH_ACTIVE_OBJECTS
+    AVRTOS_CS_SITE_AO_CREATE,
+    AVRTOS_CS_SITE_AO_POST,
+    AVRTOS_CS_SITE_AO_TAKE,
+#endif // AVRTOS_WITH_ACTIVE_OBJECTS
+#ifdef AVRTOS_WITH_WORK_QUEUE
+    AVRTOS_CS_SITE_WORK_SUBMIT,
+    AVRTOS_CS_SITE_WORK_TAKE,
+#endif // AVRTOS_WITH_WORK_QUEUE
+#ifdef AVRTOS_WITH_INTROSPECTION
+    AVRTOS_CS_SITE_TASK_INFO,
+#endif // AVRTOS_WITH_INTROSPECTION
+#ifdef AVRTOS_WITH_USART
+    AVRTOS_CS_SITE_USART,
+#endif // AVRTOS_WITH_USART
+#ifdef AVRTOS_WITH_SPI
+    AVRTOS_CS_SITE_SPI,
+#endif // AVRTOS_WITH_SPI
+#ifdef AVRTOS_WITH_TWI
+    AVRTOS_CS_SITE_TWI,
+#endif // AVRTOS_WITH_TWI
+#ifdef AVRTOS_WITH_ADC
+    AVRTOS_CS_SITE_ADC,
+#endif // AVRTOS_WITH_ADC
+#ifdef AVRTOS_WITH_EEPROM
+    AVRTOS_CS_SITE_EEPROM,
+#endif // AVRTOS_WITH_EEPROM
+    AVRTOS_CS_SITE_NON_PREEMPTIVE,
+    AVRTOS_CS_SITE_USER_FIRST,
+    AVRTOS_CS_SITE_COUNT = AVRTOS_CS_SITE_USER_FIRST + AVRTOS_CS_USER_SITES
+};
+
+#define AVRTOS_CS_SITE_USER(Index) (AVRTOS_CS_SITE_USER_FIRST + (Index))
+
+/**
+ * Converts a duration in critical section timer counts to CPU cycles.
+ */
+#define AVRTOS_CS_COUNTS_TO_CYCLES(Counts)            \
+    ((uint32_t) (Counts) * AVRTOS_CS_TIMER_PRESCALER)
+
+/**
+ * Durations of a call site in critical section timer counts. Bucket 0 counts
+ * sections shorter than 2^AVRTOS_CS_HISTOGRAM_FIRST_BUCKET_BITS counts, every
+ * next bucket doubles the bound and the last one counts everything longer.
+ * Counters saturate.
+ */
+struct avrtos_cs_stats {
+    uint16_t max;
+    uint16_t histogram[AVRTOS_CS_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * Copies the durations recorded at a call site.
+ *
+ * @param site      Call site (@ref enum avrtos_cs_site).
+ *
+ * @param out_stats Destination of the durations.
+ *
+ * @returns false if @p site is not valid.
+ */
+bool avrtos_cs_stats_get(uint8_t site, struct avrtos_cs_stats *out_stats);
+
+/**
+ * Returns the longest duration recorded at any call site, in critical section
+ * timer counts.
+ *
+ * @param out_site If not NULL, receives the call site of the longest duration.
+ */
+uint16_t avrtos_cs_stats_get_worst(uint8_t *out_site);
+
+/**
+ * Clears the durations of all call sites.
+ */
+void avrtos_cs_stats_reset(void);
+
+/**
+ * Records a duration at a call site. Can be called from ISRs. Should be a
+ * "private" function.
+ *
+ * @param site     Call site (@ref enum avrtos_cs_site).
+ *
+ * @param duration Duration in critical section timer counts.
+ */
+void _avrtos_cs_record(uint8_t site, uint16_t duration);
+
+/**
+ * Measure the scheduler interrupt windows with interrupts disabled, the
+ * windows between a begin and an end are summed up until the last end.
+ * Should be "private" functions.
+ */
+void _avrtos_cs_scheduler_begin(void);
+void _avrtos_cs_scheduler_end(bool last);
+
+/**
+ * State of an instrumented section. Should be a "private" struct.
+ */
+struct _avrtos_cs_guard {
+    uint16_t start;
+    uint8_t key;
+    uint8_t site;
+    bool run;
+};
+
+static inline struct _avrtos_cs_guard _avrtos_cs_enter(uint8_t site) {
+    struct _avrtos_cs_guard guard;
+    guard.key = avrtos_irq_lock_impl();
+    guard.site = site;
+    guard.run = true;
+    guard.start = avrtos_cs_timer_count_impl();
+    return guard;
+}
+
+static inline void _avrtos_cs_exit(struct _avrtos_cs_guard *guard) {
+    _avrtos_cs_record(guard->site,
+                      (uint16_t) (avrtos_cs_timer_count_impl() - guard->start));
+    avrtos_irq_unlock_impl(guard->key);
+}
+
+static inline struct _avrtos_cs_guard _avrtos_cs_non_preemptive_enter(
+        uint8_t site) {
+    struct _avrtos_cs_guard guard;
+    avrtos_sched_timer_stop_impl();
+    guard.site = site;
+    guard.run = true;
+    guard.start = avrtos_cs_timer_count_impl();
+    return guard;
+}
+
+static inline void _avrtos_cs_non_preemptive_exit(
+        struct _avrtos_cs_guard *guard) {
+    _avrtos_cs_record(guard->site,
+                      (uint16_t) (avrtos_cs_timer_count_impl() - guard->start));
+    avrtos_sched_timer_resume_impl();
+    guard->run = false;
+}
+
+/**
+ * Runs the following block with interrupts disabled and restores the previous
+ * interrupt state on any exit from the block (including return and goto), like
+ * ATOMIC_BLOCK(ATOMIC_RESTORESTATE). Records the duration of the block at
+ * @p Site.
+ *
+ * @param Site Call site (@ref enum avrtos_cs_site).
+ */
+#define AVRTOS_CRITICAL_SECTION(Site)                            \
+    for (struct _avrtos_cs_guard _avrtos_cs_guard                \
+                 __attribute__((__cleanup__(_avrtos_cs_exit))) = \
+                         _avrtos_cs_enter(Site);                 \
+         _avrtos_cs_guard.run; _avrtos_cs_guard.run = false)
+
+/**
+ * Same as AVRTOS_NON_PREEMPTIVE_SECTION(), records the duration of the block
+ * at @p Site. Leaving the block with break, return or goto is not allowed.
+ *
+ * @param Site Call site (@ref enum avrtos_cs_site).
+ */
+#define AVRTOS_NON_PREEMPTIVE_SECTION_AT(Site)              \
+    for (struct _avrtos_cs_guard _avrtos_np_guard =         \
+                 _avrtos_cs_non_preemptive_enter(Site);     \
+         _avrtos_np_guard.run;                              \
+         _avrtos_cs_non_preemptive_exit(&_avrtos_np_guard))
+
+#else // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+#define AVRTOS_CRITICAL_SECTION(Site) ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#define AVRTOS_NON_PREEMPTIVE_SECTION_AT(Site) AVRTOS_NON_PREEMPTIVE_SECTION()
+
+#endif // AVRTOS_WITH_CRITICAL_SECTION_STATS
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* CRITICAL_SECTION_ARCH_IND_H_ */
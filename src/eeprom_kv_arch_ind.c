@@ -0,0 +1,166 @@
+#include "eeprom_kv_arch_ind.h"
+
+#define RECORD_SEQ_OFFSET 1
+#define RECORD_VALUE_OFFSET 5
+#define RECORD_CRC_OFFSET (RECORD_VALUE_OFFSET + EEPROM_KV_VALUE_SIZE)
+
+static uint16_t kv_crc16(const uint8_t *data, uint8_t len) {
+    /* CRC-16-CCITT, polynomial 0x1021 */
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t) *data++ << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 0x8000 ? (uint16_t) (crc << 1) ^ 0x1021
+                               : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t kv_slot_address(struct eeprom_kv *kv, uint8_t slot) {
+    return kv->start + (uint16_t) slot * EEPROM_KV_RECORD_SIZE;
+}
+
+static uint32_t kv_record_seq(const uint8_t *record) {
+    uint32_t seq = 0;
+    for (uint8_t i = 4; i > 0; i--) {
+        seq = seq << 8 | record[RECORD_SEQ_OFFSET + i - 1];
+    }
+    return seq;
+}
+
+static void
+kv_read_record(struct eeprom_kv *kv, uint8_t slot, uint8_t *record) {
+    uint16_t address = kv_slot_address(kv, slot);
+    for (uint8_t i = 0; i < EEPROM_KV_RECORD_SIZE; i++) {
+        record[i] = kv->read(address + i);
+    }
+}
+
+static bool kv_record_is_valid(const uint8_t *record) {
+    uint16_t crc = kv_crc16(record, RECORD_CRC_OFFSET);
+    return record[0] != EEPROM_KV_NO_KEY
+           && record[RECORD_CRC_OFFSET] == (uint8_t) crc
+           && record[RECORD_CRC_OFFSET + 1] == (uint8_t) (crc >> 8);
+}
+
+static uint8_t kv_find(struct eeprom_kv *kv, uint8_t key) {
+    for (uint8_t slot = 0; slot < kv->slots_count; slot++) {
+        if (kv->slot_keys[slot] == key) {
+            return slot;
+        }
+    }
+    return kv->slots_count;
+}
+
+enum eeprom_kv_status eeprom_kv_mount(struct eeprom_kv *kv,
+                                      uint16_t start,
+                                      uint8_t *slot_keys,
+                                      uint8_t slots_count,
+                                      uint8_t (*read)(uint16_t address)) {
+    if (!(kv && slot_keys && read && slots_count >= 2)) {
+        return EEPROM_KV_INVALID;
+    }
+
+    kv->read = read;
+    kv->slot_keys = slot_keys;
+    kv->seq = 0;
+    kv->start = start;
+    kv->slots_count = slots_count;
+    kv->head = 0;
+    kv->keys_count = 0;
+
+    for (uint8_t slot = 0; slot < slots_count; slot++) {
+        slot_keys[slot] = EEPROM_KV_NO_KEY;
+    }
+
+    uint8_t record[EEPROM_KV_RECORD_SIZE];
+    uint8_t other[EEPROM_KV_RECORD_SIZE];
+    for (uint8_t slot = 0; slot < slots_count; slot++) {
+        kv_read_record(kv, slot, record);
+        if (!kv_record_is_valid(record)) {
+            continue;
+        }
+
+        uint8_t key = record[0];
+        uint32_t seq = kv_record_seq(record);
+        if (seq >= kv->seq) {
+            /* the next record goes after the newest one */
+            kv->seq = seq;
+            kv->head = slot + 1 == slots_count ? 0 : slot + 1;
+        }
+
+        uint8_t previous = kv_find(kv, key);
+        if (previous == slots_count) {
+            kv->keys_count++;
+        } else {
+            kv_read_record(kv, previous, other);
+            if (kv_record_seq(other) > seq) {
+                continue;
+            }
+            slot_keys[previous] = EEPROM_KV_NO_KEY;
+        }
+        slot_keys[slot] = key;
+    }
+
+    return EEPROM_KV_OK;
+}
+
+enum eeprom_kv_status
+eeprom_kv_get(struct eeprom_kv *kv, uint8_t key, uint8_t *out_value) {
+    uint8_t slot = kv_find(kv, key);
+    if (key == EEPROM_KV_NO_KEY || slot == kv->slots_count) {
+        return EEPROM_KV_NOT_FOUND;
+    }
+
+    uint16_t address = kv_slot_address(kv, slot) + RECORD_VALUE_OFFSET;
+    for (uint8_t i = 0; i < EEPROM_KV_VALUE_SIZE; i++) {
+        out_value[i] = kv->read(address + i);
+    }
+    return EEPROM_KV_OK;
+}
+
+enum eeprom_kv_status eeprom_kv_prepare(struct eeprom_kv *kv,
+                                        uint8_t key,
+                                        const uint8_t *value,
+                                        uint16_t *out_address,
+                                        uint8_t *out_record) {
+    if (key == EEPROM_KV_NO_KEY || !value) {
+        return EEPROM_KV_INVALID;
+    }
+
+    uint8_t previous = kv_find(kv, key);
+    /* a slot stays free for the next update, the newest record of a key is
+       never overwritten */
+    if (previous == kv->slots_count && kv->keys_count >= kv->slots_count - 1) {
+        return EEPROM_KV_FULL;
+    }
+
+    uint8_t slot = kv->head;
+    while (kv->slot_keys[slot] != EEPROM_KV_NO_KEY) {
+        slot = slot + 1 == kv->slots_count ? 0 : slot + 1;
+    }
+
+    kv->seq++;
+    out_record[0] = key;
+    for (uint8_t i = 0; i < 4; i++) {
+        out_record[RECORD_SEQ_OFFSET + i] = (uint8_t) (kv->seq >> (8 * i));
+    }
+    for (uint8_t i = 0; i < EEPROM_KV_VALUE_SIZE; i++) {
+        out_record[RECORD_VALUE_OFFSET + i] = value[i];
+    }
+    uint16_t crc = kv_crc16(out_record, RECORD_CRC_OFFSET);
+    out_record[RECORD_CRC_OFFSET] = (uint8_t) crc;
+    out_record[RECORD_CRC_OFFSET + 1] = (uint8_t) (crc >> 8);
+    *out_address = kv_slot_address(kv, slot);
+
+    if (previous == kv->slots_count) {
+        kv->keys_count++;
+    } else {
+        kv->slot_keys[previous] = EEPROM_KV_NO_KEY;
+    }
+    kv->slot_keys[slot] = key;
+    kv->head = slot + 1 == kv->slots_count ? 0 : slot + 1;
+
+    return EEPROM_KV_OK;
+}
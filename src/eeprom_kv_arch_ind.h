@@ -0,0 +1,130 @@
+#ifndef EEPROM_KV_ARCH_IND_H_
+#define EEPROM_KV_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifndef AVRTOS_EEPROM_KV_VALUE_SIZE
+#define AVRTOS_EEPROM_KV_VALUE_SIZE 4
+#endif // AVRTOS_EEPROM_KV_VALUE_SIZE
+
+/**
+ * Size of a value stored under a key.
+ */
+#define EEPROM_KV_VALUE_SIZE AVRTOS_EEPROM_KV_VALUE_SIZE
+
+/**
+ * Size of a record: key, 32-bit sequence number, value and CRC-16.
+ */
+#define EEPROM_KV_RECORD_SIZE (1 + 4 + EEPROM_KV_VALUE_SIZE + 2)
+
+/**
+ * Key of an erased slot, it cannot be used by the application.
+ */
+#define EEPROM_KV_NO_KEY 0xFF
+
+enum eeprom_kv_status {
+    EEPROM_KV_OK,
+    EEPROM_KV_NOT_FOUND,
+    EEPROM_KV_FULL,
+    EEPROM_KV_INVALID,
+    EEPROM_KV_TIMEOUT
+};
+
+/**
+ * Wear-leveled key-value store in a region of fixed-size slots of an EEPROM.
+ * Every update appends a record with the next sequence number to a slot that
+ * does not hold the newest record of any key, the slots are reused round
+ * robin. The newest record of a key with a valid CRC wins, so a record torn by
+ * a reset leaves the previous value in place. The sequence number does not
+ * wrap within the endurance of the EEPROM.
+ *
+ * Field "slot_keys" is the RAM index: the key whose newest record is in a
+ * slot, EEPROM_KV_NO_KEY otherwise. The store does not write the EEPROM
+ * itself, the caller writes the records returned by
+ * @ref eeprom_kv_prepare in the order they were prepared. At most
+ * "slots_count" - 1 keys can be stored.
+ */
+struct eeprom_kv {
+    uint8_t (*read)(uint16_t address);
+    uint8_t *slot_keys;
+    uint32_t seq;
+    uint16_t start;
+    uint8_t slots_count;
+    uint8_t head;
+    uint8_t keys_count;
+};
+
+/**
+ * Rebuilds the RAM index from the records in the EEPROM.
+ *
+ * @param kv          Pointer to non NULL store.
+ *
+ * @param start       EEPROM address of the first slot.
+ *
+ * @param slot_keys   RAM index, @p slots_count bytes.
+ *
+ * @param slots_count Number of slots, at least 2.
+ *
+ * @param read        Reads a byte of the EEPROM.
+ *
+ * @returns EEPROM_KV_INVALID if the arguments are not valid, EEPROM_KV_OK
+ *          otherwise.
+ */
+enum eeprom_kv_status eeprom_kv_mount(struct eeprom_kv *kv,
+                                      uint16_t start,
+                                      uint8_t *slot_keys,
+                                      uint8_t slots_count,
+                                      uint8_t (*read)(uint16_t address));
+
+/**
+ * Reads the value of a key. The EEPROM has to hold all the prepared records.
+ *
+ * @param kv        Pointer to non NULL mounted store.
+ *
+ * @param key       Key of the value.
+ *
+ * @param out_value Destination of EEPROM_KV_VALUE_SIZE bytes.
+ *
+ * @returns EEPROM_KV_NOT_FOUND if the key is not stored, EEPROM_KV_OK
+ *          otherwise.
+ */
+enum eeprom_kv_status
+eeprom_kv_get(struct eeprom_kv *kv, uint8_t key, uint8_t *out_value);
+
+/**
+ * Prepares the record setting the value of a key and updates the RAM index as
+ * if it had been written already.
+ *
+ * @param kv          Pointer to non NULL mounted store.
+ *
+ * @param key         Key of the value, not EEPROM_KV_NO_KEY.
+ *
+ * @param value       EEPROM_KV_VALUE_SIZE bytes.
+ *
+ * @param out_address Destination of the EEPROM address of the record.
+ *
+ * @param out_record  Destination of EEPROM_KV_RECORD_SIZE bytes to be written
+ *                    at @p out_address.
+ *
+ * @returns EEPROM_KV_FULL if a new key does not fit, EEPROM_KV_INVALID if the
+ *          key is not valid, EEPROM_KV_OK otherwise.
+ */
+enum eeprom_kv_status eeprom_kv_prepare(struct eeprom_kv *kv,
+                                        uint8_t key,
+                                        const uint8_t *value,
+                                        uint16_t *out_address,
+                                        uint8_t *out_record);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* EEPROM_KV_ARCH_IND_H_ */
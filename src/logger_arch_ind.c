@@ -10,42 +10,176 @@
 
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
-void _avrtos_log_buffer_append(const char *module,
-                               const char *level,
-                               const char *msg,
-                               ...) {
+static uint8_t g_log_policy =
+        AVRTOS_CONCAT(AVRTOS_LOG_POLICY_, AVRTOS_LOG_FULL_BUFFER_POLICY);
+
+static uint8_t g_log_level = AVRTOS_LOG_LEVEL_DEBUG;
+
+/* written by logging tasks with the log buffer locked, read by any task */
+static volatile uint16_t g_log_dropped[AVRTOS_LOG_LEVELS_COUNT];
+static uint16_t g_log_unreported_dropped;
+
+static const char g_log_dropped_fmt[] AVRTOS_PROGMEM =
+        "WARNING [log] %u messages dropped";
+
+/* state of the message being appended, guarded by the log buffer lock */
+static uint8_t g_log_message_len;
+static bool g_log_message_wait;
+static bool g_log_message_full;
+
+void avrtos_log_set_policy(enum avrtos_log_policy policy) {
+    g_log_policy = (uint8_t) policy;
+}
+
+enum avrtos_log_policy avrtos_log_get_policy(void) {
+    return (enum avrtos_log_policy) g_log_policy;
+}
+
+void avrtos_log_set_level(enum avrtos_log_level level) {
+    if (level < AVRTOS_LOG_LEVELS_COUNT) {
+        g_log_level = (uint8_t) level;
+    }
+}
+
+enum avrtos_log_level avrtos_log_get_level(void) {
+    return (enum avrtos_log_level) g_log_level;
+}
+
+bool _avrtos_log_level_is_enabled(uint8_t level) {
+    return level <= g_log_level;
+}
+
+uint16_t avrtos_log_get_dropped(enum avrtos_log_level level) {
+    if (level >= AVRTOS_LOG_LEVELS_COUNT) {
+        return 0;
+    }
+    return avrtos_read_volatile_u16(&g_log_dropped[level]);
+}
+
+void _avrtos_log_count_dropped(uint8_t level) {
+    if (level < AVRTOS_LOG_LEVELS_COUNT && g_log_dropped[level] < UINT16_MAX) {
+        g_log_dropped[level]++;
+    }
+    if (g_log_unreported_dropped < UINT16_MAX) {
+        g_log_unreported_dropped++;
+    }
+}
+
+uint16_t _avrtos_log_get_unreported_dropped(void) {
+    return g_log_unreported_dropped;
+}
+
+void _avrtos_log_clear_unreported_dropped(void) {
+    g_log_unreported_dropped = 0;
+}
+
+static void _avrtos_log_begin_message(bool wait) {
+    g_log_message_len = 0;
+    g_log_message_wait = wait;
+    g_log_message_full = false;
+}
+
+/**
+ * Appends one formatted character to the current message. Characters that do
+ * not fit in @p AVRTOS_SINGLE_LOG_MAX_SIZE (including the trailing "\n\0")
+ * are trimmed, characters that do not fit in the log buffer mark the message
+ * as incomplete.
+ */
+static void _avrtos_log_putc(char c) {
+    if (g_log_message_full
+        || g_log_message_len >= AVRTOS_SINGLE_LOG_MAX_SIZE - 2) {
+        return;
+    }
+    if (_avrtos_log_put(c, g_log_message_wait)) {
+        g_log_message_len++;
+    } else {
+        g_log_message_full = true;
+    }
+}
+
+#ifdef __AVR__
+
+static int _avrtos_log_stream_put(char c, FILE *stream) {
+    (void) stream;
+    _avrtos_log_putc(c);
+    return 0;
+}
+
+/* formatted characters go straight to the log buffer, no message copy on the
+   stack */
+static FILE g_log_stream =
+        FDEV_SETUP_STREAM(_avrtos_log_stream_put, NULL, _FDEV_SETUP_WRITE);
+
+static void _avrtos_log_vformat_P(const char *fmt, va_list args) {
+    vfprintf_P(&g_log_stream, fmt, args);
+}
+
+#else
+
+static void _avrtos_log_vformat_P(const char *fmt, va_list args) {
+    /* the standard C library has no user-defined streams, format the message
+       in a temporary buffer instead */
     char buffer[AVRTOS_SINGLE_LOG_MAX_SIZE];
-    char *pointer = buffer;
+    int size = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    for (int i = 0; i < size && (size_t) i < sizeof(buffer) - 1; i++) {
+        _avrtos_log_putc(buffer[i]);
+    }
+}
 
-    int message_header_expected_size =
-            snprintf(pointer, AVRTOS_SINGLE_LOG_MAX_SIZE, "%s [%s] ", level,
-                     module);
+#endif // __AVR__
+
+static void _avrtos_log_format_P(const char *fmt, ...) {
+    va_list argptr;
+    va_start(argptr, fmt);
+    _avrtos_log_vformat_P(fmt, argptr);
+    va_end(argptr);
+}
 
-    if (message_header_expected_size + 1 >= AVRTOS_SINGLE_LOG_MAX_SIZE) {
-        /* buffer overflow, last characters should be equal to "\n\0" */
-        buffer[AVRTOS_SINGLE_LOG_MAX_SIZE - 2] = '\n';
+/**
+ * Appends the "N messages dropped" line to the log buffer, if there are
+ * unreported dropped messages and the line fits. Never waits for the USART.
+ */
+static void _avrtos_log_report_dropped(void) {
+    if (!g_log_unreported_dropped) {
+        return;
+    }
+    _avrtos_log_begin_message(false);
+    _avrtos_log_format_P(g_log_dropped_fmt,
+                         (unsigned int) g_log_unreported_dropped);
+    if (g_log_message_full) {
+        _avrtos_log_discard();
+    } else if (_avrtos_log_finish('\n', false)) {
+        g_log_unreported_dropped = 0;
+    }
+}
+
+void _avrtos_log_buffer_append_P(enum avrtos_log_level level,
+                                 const char *fmt,
+                                 ...) {
+    _avrtos_log_lock();
+    _avrtos_log_begin_message(g_log_policy == AVRTOS_LOG_POLICY_BLOCK);
+
+    /* level and module name are part of the format string kept in flash */
+    va_list argptr;
+    va_start(argptr, fmt);
+    _avrtos_log_vformat_P(fmt, argptr);
+    va_end(argptr);
+
+    bool sent = false;
+    if (!g_log_message_full
+        || (g_log_policy == AVRTOS_LOG_POLICY_TRUNCATE
+            && g_log_message_len > 0)) {
+        sent = _avrtos_log_finish('\n', g_log_message_wait);
     } else {
-        pointer += message_header_expected_size;
-        va_list argptr;
-        va_start(argptr, msg);
-        int message_content_expected_size = vsnprintf(
-                pointer,
-                AVRTOS_SINGLE_LOG_MAX_SIZE - message_header_expected_size, msg,
-                argptr);
-        va_end(argptr);
-
-        if (message_header_expected_size + message_content_expected_size + 1
-            >= AVRTOS_SINGLE_LOG_MAX_SIZE) {
-            /* buffer overflow, last characters should be equal to "\n\0" */
-            buffer[AVRTOS_SINGLE_LOG_MAX_SIZE - 2] = '\n';
-        } else {
-            pointer += message_content_expected_size;
-            *(pointer++) = '\n';
-            *pointer = '\0';
-        }
-    }
-
-    _avrtos_handle_log_buffer(buffer, AVRTOS_SINGLE_LOG_MAX_SIZE);
+        /* not enough free space in the log buffer */
+        _avrtos_log_discard();
+    }
+    if (!sent) {
+        _avrtos_log_count_dropped(level);
+    }
+
+    _avrtos_log_report_dropped();
+    _avrtos_log_unlock();
 }
 
 #endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
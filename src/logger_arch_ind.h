@@ -1,11 +1,14 @@
 #ifndef LOGGER_ARCH_IND_H_
 #define LOGGER_ARCH_IND_H_
 
+#include <inttypes.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include "avrtos_config.h"
 #include "avrtos_utils.h"
 #include "boards/avrtos_board_impl.h"
+#include "logger_binary_arch_ind.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,21 +17,107 @@ extern "C" {
 #ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
 
 /**
- * Creates a log message and appends it to the global log buffer. Should be a
+ * Log levels, dropped messages are counted separately for each of them.
+ */
+enum avrtos_log_level {
+    AVRTOS_LOG_LEVEL_ERROR,
+    AVRTOS_LOG_LEVEL_WARNING,
+    AVRTOS_LOG_LEVEL_INFO,
+    AVRTOS_LOG_LEVEL_DEBUG,
+    AVRTOS_LOG_LEVELS_COUNT
+};
+
+/**
+ * Behaviour of avrtos_log() when the log buffer is full.
+ */
+enum avrtos_log_policy {
+    /* wait until the USART sends enough data */
+    AVRTOS_LOG_POLICY_BLOCK,
+    /* drop the whole message */
+    AVRTOS_LOG_POLICY_DROP,
+    /* send as much of the message as fits, binary records are dropped */
+    AVRTOS_LOG_POLICY_TRUNCATE
+};
+
+/**
+ * Sets the behaviour of avrtos_log() when the log buffer is full. The default
+ * one is set with AVRTOS_LOG_FULL_BUFFER_POLICY.
+ *
+ * @param policy New policy.
+ */
+void avrtos_log_set_policy(enum avrtos_log_policy policy);
+
+/**
+ * Returns the current behaviour of avrtos_log() when the log buffer is full.
+ */
+enum avrtos_log_policy avrtos_log_get_policy(void);
+
+/**
+ * Sets the most verbose level sent at run time, e.g. to silence DEBUG messages
+ * without rebuilding. Levels removed at compile time by
+ * AVRTOS_LOG_DEFAULT_LEVEL are not sent either. All levels are sent by default.
+ * Arguments of skipped messages are not evaluated and skipped messages are not
+ * counted as dropped.
+ *
+ * @param level New level.
+ */
+void avrtos_log_set_level(enum avrtos_log_level level);
+
+/**
+ * Returns the most verbose level sent at run time.
+ */
+enum avrtos_log_level avrtos_log_get_level(void);
+
+/**
+ * Checks whether messages of given level are sent at run time. Should be a
  * "private" function.
  *
- * @param module Stringified module name.
+ * @param level Level of the message.
+ */
+bool _avrtos_log_level_is_enabled(uint8_t level);
+
+/**
+ * Returns the number of messages of given level dropped since the startup
+ * (saturates at UINT16_MAX).
  *
- * @param level  Stringified log level.
+ * @param level Log level.
+ */
+uint16_t avrtos_log_get_dropped(enum avrtos_log_level level);
+
+/**
+ * Counts a dropped message. Has to be called with the log buffer locked.
+ * Should be a "private" function.
  *
- * @param msg    Message to be added to the buffer.
+ * @param level Level of the dropped message.
+ */
+void _avrtos_log_count_dropped(uint8_t level);
+
+/**
+ * Returns the number of dropped messages not reported in the log output yet.
+ * Has to be called with the log buffer locked. Should be a "private" function.
+ */
+uint16_t _avrtos_log_get_unreported_dropped(void);
+
+/**
+ * Marks all dropped messages as reported in the log output. Has to be called
+ * with the log buffer locked. Should be a "private" function.
+ */
+void _avrtos_log_clear_unreported_dropped(void);
+
+/**
+ * Creates a log message and appends it to the global log buffer. Should be a
+ * "private" function.
+ *
+ * @param level  Level of the message.
+ *
+ * @param fmt    Format string of the whole message (level and module name
+ *               included), placed in flash memory.
  *
  * @param vaargs Specified formatting of the message.
  */
-void _avrtos_log_buffer_append(const char *module,
-                               const char *level,
-                               const char *msg,
-                               ...);
+void _avrtos_log_buffer_append_P(enum avrtos_log_level level,
+                                 const char *fmt,
+                                 ...);
 
 /**
  * Initialize asynchronous logger. This function should be defined separately
@@ -40,16 +129,65 @@ static inline void _avrtos_logger_init(void) {
 }
 
 /**
- * Handles created log message. This function should be defined separately for
+ * Locks the global log buffer, blocks other log producers until
+ * @ref _avrtos_log_unlock is called. This function should be defined
+ * separately for each AVR board (if no abstraction-layer defines have been
+ * created). Should be a "private" function.
+ */
+static inline void _avrtos_log_lock(void) {
+    avrtos_log_lock_impl();
+}
+
+/**
+ * Unlocks the global log buffer. This function should be defined separately for
+ * each AVR board (if no abstraction-layer defines have been created). Should be
+ * a "private" function.
+ */
+static inline void _avrtos_log_unlock(void) {
+    avrtos_log_unlock_impl();
+}
+
+/**
+ * Appends one character of the current message to the locked global log
+ * buffer. The message is not sent until @ref _avrtos_log_finish is called,
+ * unless the function had to wait for free space. The last free slot of the
+ * buffer is kept for @ref _avrtos_log_finish. This function should be defined
+ * separately for each AVR board (if no abstraction-layer defines have been
+ * created). Should be a "private" function.
+ *
+ * @param c    Character to be appended.
+ *
+ * @param wait If true, waits until there is free space in the log buffer.
+ *
+ * @returns true if the character has been appended, false otherwise.
+ */
+static inline bool _avrtos_log_put(char c, bool wait) {
+    return avrtos_log_put_impl(c, wait);
+}
+
+/**
+ * Appends the last character of the current message and hands the whole
+ * message over to the output. This function should be defined separately for
  * each AVR board (if no abstraction-layer defines have been created). Should be
  * a "private" function.
  *
- * @param buffer Pointer to the buffer containing formatted log message.
+ * @param c    Last character of the message.
+ *
+ * @param wait If true, waits until there is free space in the log buffer.
  *
- * @param buf_len Length of the log buffer.
+ * @returns true if the message has been sent, false if it has been dropped.
  */
-static inline void _avrtos_handle_log_buffer(char *buffer, size_t buf_len) {
-    avrtos_handle_log_buffer_impl(buffer, buf_len);
+static inline bool _avrtos_log_finish(char c, bool wait) {
+    return avrtos_log_finish_impl(c, wait);
+}
+
+/**
+ * Drops the characters of the current message appended so far. This function
+ * should be defined separately for each AVR board (if no abstraction-layer
+ * defines have been created). Should be a "private" function.
+ */
+static inline void _avrtos_log_discard(void) {
+    avrtos_log_discard_impl();
 }
 
 #define LOG_LEVEL_ERROR_CONTAIN_ERROR 1
@@ -76,17 +214,45 @@ static inline void _avrtos_handle_log_buffer(char *buffer, size_t buf_len) {
     do {                \
     } while (0)
 
-#define _LOG_NOT_EMPTY(Module, Level, ...)              \
-    _avrtos_log_buffer_append(AVRTOS_STRINGIFY(Module), \
-                              AVRTOS_STRINGIFY(Level), __VA_ARGS__)
+#ifdef AVRTOS_WITH_BINARY_LOGGER
+#define _LOG_SEND(Module, Level, ...) \
+    _AVRTOS_LOG_BINARY(Module, Level, __VA_ARGS__)
+#else // AVRTOS_WITH_BINARY_LOGGER
+#define _LOG_SEND(Module, Level, ...) \
+    _AVRTOS_LOG_TEXT(Module, Level, __VA_ARGS__)
+#endif // AVRTOS_WITH_BINARY_LOGGER
+
+/* the run-time level is checked before the arguments are evaluated */
+#define _LOG_NOT_EMPTY(Module, Level, ...)                      \
+    do {                                                        \
+        if (_avrtos_log_level_is_enabled(                       \
+                    AVRTOS_CONCAT(AVRTOS_LOG_LEVEL_, Level))) { \
+            _LOG_SEND(Module, Level, __VA_ARGS__);              \
+        }                                                       \
+    } while (0)
+
+/**
+ * Level, module name and format string are merged into a single string literal
+ * kept in flash memory, so a log call site takes no SRAM. The format string has
+ * to be a string literal. tools/avrtos_log_sram_report.py lists the SRAM
+ * recovered this way.
+ */
+#define _AVRTOS_LOG_TEXT(Module, Level, Fmt, ...)                            \
+    do {                                                                     \
+        static const char _avrtos_log_fmt[] AVRTOS_PROGMEM =                 \
+                AVRTOS_STRINGIFY(Level) " [" AVRTOS_STRINGIFY(Module) "] "   \
+                Fmt;                                                         \
+        _avrtos_log_buffer_append_P(AVRTOS_CONCAT(AVRTOS_LOG_LEVEL_, Level), \
+                                    _avrtos_log_fmt, ##__VA_ARGS__);         \
+    } while (0)
 
 #define _AVRTOS_LOG(Module, Level, ...)                      \
     AVRTOS_CONCAT(_LOG_, _LOG_TYPE(Level, NOT_EMPTY, EMPTY)) \
     (Module, Level, __VA_ARGS__)
 
 /**
- * Prepares proper log message and passes it to @ref
- * avrtos_handle_log_buffer_impl.
+ * Formats proper log message directly in the global log buffer or, with
+ * AVRTOS_WITH_BINARY_LOGGER, sends it as a binary record.
  */
 #define avrtos_log(Module, Level, ...) _AVRTOS_LOG(Module, Level, __VA_ARGS__)
 #else // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
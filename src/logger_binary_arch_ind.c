@@ -0,0 +1,69 @@
+#include <string.h>
+
+#include "logger_arch_ind.h"
+
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+static const char g_log_dropped_fmt[]
+        __attribute__((section(_AVRTOS_LOG_FMT_SECTION), used)) =
+                "WARNING [log] %u messages dropped\n";
+
+void _avrtos_log_record_begin(struct _avrtos_log_record *record,
+                              uint8_t level,
+                              const char *fmt) {
+    uint16_t fmt_id = (uint16_t)(uintptr_t) fmt;
+    avrtos_tick_t timestamp = avrtos_delay_get_ticks_impl();
+
+    record->data[0] = (char) AVRTOS_BINARY_LOG_SYNC;
+    /* little-endian, independent of the host byte order */
+    record->data[2] = (char) (fmt_id & 0xFF);
+    record->data[3] = (char) (fmt_id >> 8);
+    for (uint8_t i = 0; i < 4; i++) {
+        record->data[4 + i] = (char) ((uint32_t) timestamp >> (8 * i));
+    }
+    record->len = AVRTOS_BINARY_LOG_HEADER_SIZE;
+    record->level = level;
+    record->truncated = false;
+}
+
+void _avrtos_log_record_put(struct _avrtos_log_record *record,
+                            const void *value,
+                            size_t size) {
+    if (record->truncated
+        || record->len + size > AVRTOS_BINARY_LOG_MAX_SIZE) {
+        /* do not send any further argument either, the decoder notices the
+           missing ones from the record length */
+        record->truncated = true;
+        return;
+    }
+    memcpy(&record->data[record->len], value, size);
+    record->len += (uint8_t) size;
+}
+
+void _avrtos_log_record_end(struct _avrtos_log_record *record) {
+    bool wait = avrtos_log_get_policy() == AVRTOS_LOG_POLICY_BLOCK;
+    record->data[1] = (char) record->len;
+
+    avrtos_log_lock_impl();
+    if (!avrtos_log_write_impl(record->data, record->len, wait)) {
+        /* a record cannot be truncated, it is dropped with TRUNCATE policy
+           too */
+        _avrtos_log_count_dropped(record->level);
+    }
+
+    /* report dropped records if there is room, never wait for the USART */
+    uint16_t unreported = _avrtos_log_get_unreported_dropped();
+    if (unreported) {
+        unsigned int count = unreported;
+        _avrtos_log_record_begin(record, AVRTOS_LOG_LEVEL_WARNING,
+                                 g_log_dropped_fmt);
+        _avrtos_log_record_put(record, &count, sizeof(count));
+        record->data[1] = (char) record->len;
+        if (avrtos_log_write_impl(record->data, record->len, false)) {
+            _avrtos_log_clear_unreported_dropped();
+        }
+    }
+    avrtos_log_unlock_impl();
+}
+
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
@@ -0,0 +1,158 @@
+#ifndef LOGGER_BINARY_ARCH_IND_H_
+#define LOGGER_BINARY_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "boards/avrtos_board_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+#ifndef AVRTOS_BINARY_LOG_MAX_SIZE
+#define AVRTOS_BINARY_LOG_MAX_SIZE 24
+#endif // AVRTOS_BINARY_LOG_MAX_SIZE
+
+/**
+ * Binary log record layout (all fields little-endian):
+ * | sync (1) | record length (1) | format ID (2) | timestamp (4) | arguments |
+ * Record length covers the whole record. Format ID is the address of the
+ * format string in the format section, timestamp is in delay timer ticks.
+ * Arguments are raw values after the default argument promotions.
+ */
+#define AVRTOS_BINARY_LOG_SYNC 0xA5
+#define AVRTOS_BINARY_LOG_HEADER_SIZE 8
+
+AVRTOS_STATIC_ASSERT(AVRTOS_BINARY_LOG_MAX_SIZE >= AVRTOS_BINARY_LOG_HEADER_SIZE
+                             && AVRTOS_BINARY_LOG_MAX_SIZE <= 255,
+                     BinaryLogMaxSizeIsNotValid);
+
+/**
+ * Section holding the format strings. On AVR it is emitted without the
+ * "allocatable" flag (the rest of the flags GCC appends is commented out), so
+ * it stays in the ELF file and never takes flash or SRAM.
+ */
+#if defined(__AVR__)
+#define _AVRTOS_LOG_FMT_SECTION ".avrtos_log_fmt,\"\",@progbits;"
+#else // defined(__AVR__)
+#define _AVRTOS_LOG_FMT_SECTION ".avrtos_log_fmt"
+#endif // defined(__AVR__)
+
+/**
+ * Binary log record being built on the caller's stack. Should be a "private"
+ * structure.
+ */
+struct _avrtos_log_record {
+    char data[AVRTOS_BINARY_LOG_MAX_SIZE];
+    uint8_t len;
+    uint8_t level;
+    bool truncated;
+};
+
+/**
+ * Starts a binary log record: fills the header. Should be a "private" function.
+ *
+ * @param record Pointer to the record.
+ *
+ * @param level  Level of the message (enum avrtos_log_level).
+ *
+ * @param fmt    Format string placed in the format section.
+ */
+void _avrtos_log_record_begin(struct _avrtos_log_record *record,
+                              uint8_t level,
+                              const char *fmt);
+
+/**
+ * Appends one raw argument to the record. If it does not fit, the record is
+ * sent without it (and without any following argument). Should be a "private"
+ * function.
+ *
+ * @param record Pointer to the record.
+ *
+ * @param value  Pointer to the argument value.
+ *
+ * @param size   Size of the argument value.
+ */
+void _avrtos_log_record_put(struct _avrtos_log_record *record,
+                            const void *value,
+                            size_t size);
+
+/**
+ * Finishes the record and passes it to @ref avrtos_log_write_impl, followed by
+ * the "N messages dropped" record if needed (built in @p record). Should be a
+ * "private" function.
+ *
+ * @param record Pointer to the record.
+ */
+void _avrtos_log_record_end(struct _avrtos_log_record *record);
+
+/**
+ * Appends one argument after the default argument promotions (e.g. uint8_t is
+ * sent as int, arrays as pointers), so its size matches what printf expects.
+ */
+#define _AVRTOS_LOG_RECORD_PUT(Arg)                                      \
+    {                                                                    \
+        __typeof__((Arg) + 0) _avrtos_log_arg = (Arg);                   \
+        _avrtos_log_record_put(&_avrtos_log_record, &_avrtos_log_arg,    \
+                               sizeof(_avrtos_log_arg));                 \
+    }
+
+/**
+ * Argument counting and iteration, up to 8 arguments.
+ */
+#define _AVRTOS_LOG_NARGS(...) \
+    _AVRTOS_LOG_NARGS_N(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _AVRTOS_LOG_NARGS_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#define _AVRTOS_LOG_PUT_0()
+#define _AVRTOS_LOG_PUT_1(A) _AVRTOS_LOG_RECORD_PUT(A)
+#define _AVRTOS_LOG_PUT_2(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_1(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_3(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_2(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_4(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_3(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_5(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_4(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_6(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_5(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_7(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_6(__VA_ARGS__)
+#define _AVRTOS_LOG_PUT_8(A, ...) \
+    _AVRTOS_LOG_RECORD_PUT(A) _AVRTOS_LOG_PUT_7(__VA_ARGS__)
+
+/**
+ * Sends a binary log record. The format string has to be a string literal, it
+ * is prefixed with the level and the module name at compile time. "%s"
+ * arguments are sent as pointers, the decoder resolves them only if they point
+ * to constant strings.
+ */
+#define _AVRTOS_LOG_BINARY(Module, Level, ...) \
+    _AVRTOS_LOG_BINARY_FMT(Module, Level, __VA_ARGS__)
+#define _AVRTOS_LOG_BINARY_FMT(Module, Level, Fmt, ...)                      \
+    do {                                                                     \
+        static const char _avrtos_log_fmt[] __attribute__((                  \
+                section(_AVRTOS_LOG_FMT_SECTION), used)) =                   \
+                AVRTOS_STRINGIFY(Level) " [" AVRTOS_STRINGIFY(Module) "] "   \
+                Fmt "\n";                                                    \
+        struct _avrtos_log_record _avrtos_log_record;                        \
+        _avrtos_log_record_begin(&_avrtos_log_record,                        \
+                                 AVRTOS_CONCAT(AVRTOS_LOG_LEVEL_, Level),    \
+                                 _avrtos_log_fmt);                           \
+        AVRTOS_CONCAT(_AVRTOS_LOG_PUT_, _AVRTOS_LOG_NARGS(__VA_ARGS__))      \
+        (__VA_ARGS__) _avrtos_log_record_end(&_avrtos_log_record);           \
+    } while (0)
+
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* LOGGER_BINARY_ARCH_IND_H_ */
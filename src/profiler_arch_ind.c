@@ -0,0 +1,126 @@
+#include "profiler_arch_ind.h"
+
+#ifdef AVRTOS_WITH_PROFILER
+
+#define PROFILER_INDEX_MASK (AVRTOS_PROFILER_TABLE_SIZE - 1)
+
+/* written by the scheduler interrupt, read and cleared by tasks with
+   interrupts disabled */
+static struct avrtos_profiler_entry g_profiler_table[AVRTOS_PROFILER_TABLE_SIZE];
+static uint32_t g_profiler_samples;
+static uint16_t g_profiler_dropped;
+static bool g_profiler_enabled = true;
+
+void avrtos_profiler_set_enabled(bool enabled) {
+    g_profiler_enabled = enabled;
+}
+
+uint32_t avrtos_profiler_get_samples(void) {
+    uint8_t key = avrtos_irq_lock_impl();
+    uint32_t samples = g_profiler_samples;
+    avrtos_irq_unlock_impl(key);
+
+    return samples;
+}
+
+void avrtos_profiler_reset(void) {
+    uint8_t key = avrtos_irq_lock_impl();
+    for (uint8_t i = 0; i < AVRTOS_PROFILER_TABLE_SIZE; i++) {
+        g_profiler_table[i].count = 0;
+    }
+    g_profiler_samples = 0;
+    g_profiler_dropped = 0;
+    avrtos_irq_unlock_impl(key);
+}
+
+static inline uint8_t profiler_hash(uint8_t task_id, uint16_t pc) {
+    /* samples of a hot loop differ in the low bits of the program counter */
+    return ((uint8_t) pc ^ (uint8_t) (pc >> 8) ^ (uint8_t) (task_id << 3))
+           & PROFILER_INDEX_MASK;
+}
+
+void _avrtos_profiler_record(uint8_t task_id, uint16_t pc) {
+    if (!g_profiler_enabled) {
+        return;
+    }
+
+    g_profiler_samples++;
+    uint8_t index = profiler_hash(task_id, pc);
+    for (uint8_t probe = 0; probe < AVRTOS_PROFILER_PROBES; probe++) {
+        struct avrtos_profiler_entry *entry = &g_profiler_table[index];
+        if (entry->count == 0) {
+            entry->pc = pc;
+            entry->task_id = task_id;
+            entry->count = 1;
+            return;
+        }
+        if (entry->pc == pc && entry->task_id == task_id) {
+            if (entry->count < UINT16_MAX) {
+                entry->count++;
+            }
+            return;
+        }
+        index = (index + 1) & PROFILER_INDEX_MASK;
+    }
+
+    if (g_profiler_dropped < UINT16_MAX) {
+        g_profiler_dropped++;
+    }
+}
+
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+static void profiler_frame_send(char *frame, uint8_t len) {
+    uint8_t checksum = 0;
+    frame[0] = (char) AVRTOS_PROFILER_SYNC;
+    for (uint8_t i = 1; i < len - 1; i++) {
+        checksum += (uint8_t) frame[i];
+    }
+    frame[len - 1] = (char) checksum;
+    (void) avrtos_log_write_impl(frame, len, true);
+}
+
+void avrtos_profiler_dump(void) {
+    char frame[AVRTOS_PROFILER_HEADER_FRAME_SIZE];
+
+    uint8_t key = avrtos_irq_lock_impl();
+    uint32_t samples = g_profiler_samples;
+    uint16_t dropped = g_profiler_dropped;
+    g_profiler_samples = 0;
+    g_profiler_dropped = 0;
+    avrtos_irq_unlock_impl(key);
+
+    avrtos_log_lock_impl();
+    frame[1] = AVRTOS_PROFILER_FRAME_HEADER;
+    frame[2] = AVRTOS_PROFILER_VERSION;
+    for (uint8_t i = 0; i < sizeof(samples); i++) {
+        frame[3 + i] = (char) (samples >> (8 * i));
+    }
+    frame[7] = (char) (dropped & 0xFF);
+    frame[8] = (char) (dropped >> 8);
+    profiler_frame_send(frame, AVRTOS_PROFILER_HEADER_FRAME_SIZE);
+
+    for (uint8_t i = 0; i < AVRTOS_PROFILER_TABLE_SIZE; i++) {
+        /* entries are taken one by one to keep interrupt latency low */
+        key = avrtos_irq_lock_impl();
+        struct avrtos_profiler_entry entry = g_profiler_table[i];
+        g_profiler_table[i].count = 0;
+        avrtos_irq_unlock_impl(key);
+
+        if (entry.count == 0) {
+            continue;
+        }
+        frame[1] = AVRTOS_PROFILER_FRAME_ENTRY;
+        frame[2] = (char) entry.task_id;
+        frame[3] = (char) (entry.pc & 0xFF);
+        frame[4] = (char) (entry.pc >> 8);
+        frame[5] = (char) (entry.count & 0xFF);
+        frame[6] = (char) (entry.count >> 8);
+        profiler_frame_send(frame, AVRTOS_PROFILER_ENTRY_FRAME_SIZE);
+    }
+    avrtos_log_unlock_impl();
+}
+
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+#endif // AVRTOS_WITH_PROFILER
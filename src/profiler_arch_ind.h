@@ -0,0 +1,121 @@
+#ifndef PROFILER_ARCH_IND_H_
+#define PROFILER_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "boards/avrtos_board_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#ifdef AVRTOS_WITH_PROFILER
+
+#ifndef AVRTOS_PROFILER_TABLE_SIZE
+#define AVRTOS_PROFILER_TABLE_SIZE 32
+#endif // AVRTOS_PROFILER_TABLE_SIZE
+
+#ifndef AVRTOS_PROFILER_PROBES
+#define AVRTOS_PROFILER_PROBES 4
+#endif // AVRTOS_PROFILER_PROBES
+
+AVRTOS_STATIC_ASSERT(AVRTOS_PROFILER_TABLE_SIZE >= 2
+                             && AVRTOS_PROFILER_TABLE_SIZE <= 128
+                             && (AVRTOS_PROFILER_TABLE_SIZE
+                                 & (AVRTOS_PROFILER_TABLE_SIZE - 1))
+                                        == 0,
+                     ProfilerTableSizeIsNotValid);
+AVRTOS_STATIC_ASSERT(AVRTOS_PROFILER_PROBES >= 1
+                             && AVRTOS_PROFILER_PROBES
+                                        <= AVRTOS_PROFILER_TABLE_SIZE,
+                     ProfilerProbesAreNotValid);
+
+/**
+ * Histogram entry: number of samples of a single program counter (word
+ * address) in a single task. Entries with zero count are free.
+ */
+struct avrtos_profiler_entry {
+    uint16_t pc;
+    uint16_t count;
+    uint8_t task_id;
+};
+
+/**
+ * Dump frame layout (all fields little-endian):
+ * | sync (1) | kind (1) | payload | checksum (1) |
+ * Checksum is the 8-bit sum of kind and payload. Payload of the header frame:
+ * | version (1) | samples (4) | dropped samples (2) |
+ * Payload of the entry frame:
+ * | task ID (1) | program counter (2) | count (2) |
+ */
+#define AVRTOS_PROFILER_SYNC 0xA8
+#define AVRTOS_PROFILER_FRAME_HEADER 'P'
+#define AVRTOS_PROFILER_FRAME_ENTRY 'S'
+#define AVRTOS_PROFILER_VERSION 1
+#define AVRTOS_PROFILER_HEADER_FRAME_SIZE 10
+#define AVRTOS_PROFILER_ENTRY_FRAME_SIZE 8
+
+/**
+ * Starts or stops the sampling. The profiler samples from startup.
+ *
+ * @param enabled true to record samples.
+ */
+void avrtos_profiler_set_enabled(bool enabled);
+
+/**
+ * Returns the number of samples taken since the last dump or reset, including
+ * the dropped ones.
+ */
+uint32_t avrtos_profiler_get_samples(void);
+
+/**
+ * Clears the histogram and the sample counters.
+ */
+void avrtos_profiler_reset(void);
+
+/**
+ * Sends the histogram over the logger USART and clears it: a header frame
+ * followed by one frame per entry. Samples taken in the meantime are kept for
+ * the next dump, so the same program counter can appear in more than one
+ * entry. Waits until the USART has sent enough data. Use
+ * tools/avrtos_profile.py to print the flat profile.
+ */
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+void avrtos_profiler_dump(void);
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+/**
+ * Counts a sample in the histogram. When all @ref AVRTOS_PROFILER_PROBES
+ * entries the program counter hashes to are taken by other program counters,
+ * the sample is counted as dropped. Should be called with interrupts disabled.
+ * Should be a "private" function.
+ *
+ * @param task_id ID of the interrupted task.
+ *
+ * @param pc      Interrupted program counter (word address).
+ */
+void _avrtos_profiler_record(uint8_t task_id, uint16_t pc);
+
+#else // AVRTOS_WITH_PROFILER
+
+#define avrtos_profiler_set_enabled(...) \
+    do {                                 \
+    } while (0)
+#define avrtos_profiler_reset(...) \
+    do {                           \
+    } while (0)
+#define avrtos_profiler_dump(...) \
+    do {                          \
+    } while (0)
+
+#endif // AVRTOS_WITH_PROFILER
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* PROFILER_ARCH_IND_H_ */
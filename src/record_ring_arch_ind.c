@@ -0,0 +1,101 @@
+#include "record_ring_arch_ind.h"
+
+/* Drops the oldest record and counts it as overwritten. Fails if there is no
+   record or its length byte runs past the stored data. */
+static enum circular_buffer_status
+_record_ring_drop_oldest(struct record_ring *ring) {
+    uint8_t len;
+    enum circular_buffer_status status = record_ring_peek_length(ring, &len);
+    if (status != CIRC_BUFF_OK) {
+        return status;
+    }
+    status = circ_buff_consume(&ring->buffer, (size_t) len + 1);
+    if (status != CIRC_BUFF_OK) {
+        return status;
+    }
+    ring->overwritten_records++;
+    ring->overwritten_bytes += len;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+record_ring_initialize(struct record_ring *ring, char *buffer, size_t size) {
+    if (!(ring && buffer && size > 1)) {
+        return CIRC_BUFF_INVALID;
+    }
+    ring->overwritten_records = 0;
+    ring->overwritten_bytes = 0;
+
+    return circ_buff_initialize(&ring->buffer, buffer, size);
+}
+
+enum circular_buffer_status record_ring_write(struct record_ring *ring,
+                                              const char *record,
+                                              uint8_t len) {
+    if (!(ring && record)) {
+        return CIRC_BUFF_INVALID;
+    }
+    size_t needed = (size_t) len + 1;
+    if (needed > ring->buffer.capacity) {
+        return CIRC_BUFF_INVALID;
+    }
+    while (ring->buffer.capacity - ring->buffer.occupancy < needed) {
+        if (_record_ring_drop_oldest(ring) != CIRC_BUFF_OK) {
+            return CIRC_BUFF_INVALID;
+        }
+    }
+    size_t inserted;
+    (void) circ_buff_insert_one(&ring->buffer, (char) len);
+    (void) circ_buff_insert_partial(&ring->buffer, record, len, &inserted);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status record_ring_peek_length(struct record_ring *ring,
+                                                    uint8_t *out_len) {
+    if (!(ring && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    char *ptr;
+    size_t contiguous;
+    if (circ_buff_peek_contiguous(&ring->buffer, &ptr, &contiguous)
+        != CIRC_BUFF_OK) {
+        return CIRC_BUFF_EMPTY;
+    }
+    *out_len = (uint8_t) *ptr;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status record_ring_read(struct record_ring *ring,
+                                             char *out_record,
+                                             size_t size,
+                                             uint8_t *out_len) {
+    if (!(ring && out_record && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t len;
+    enum circular_buffer_status ret = record_ring_peek_length(ring, &len);
+    if (ret != CIRC_BUFF_OK) {
+        return ret;
+    }
+    if (len > size) {
+        return CIRC_BUFF_INVALID;
+    }
+    (void) circ_buff_consume(&ring->buffer, 1);
+    (void) circ_buff_get_few(&ring->buffer, out_record, len);
+    *out_len = len;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status record_ring_reset(struct record_ring *ring) {
+    if (!ring) {
+        return CIRC_BUFF_INVALID;
+    }
+    ring->overwritten_records = 0;
+    ring->overwritten_bytes = 0;
+
+    return circ_buff_reset(&ring->buffer);
+}
@@ -0,0 +1,156 @@
+#ifndef RECORD_RING_ARCH_IND_H_
+#define RECORD_RING_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "circular_buffer_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * Maximum length of a single record (the length is stored in one byte).
+ */
+#define RECORD_RING_MAX_RECORD_LEN 255
+
+/**
+ * Flight-recorder ring of variable length records. Each record is stored as a
+ * length byte followed by the record data. Writes never block: if there is not
+ * enough space, the oldest whole records are dropped and counted, so readers
+ * always start at a record boundary.
+ *
+ * The ring is not lock-free. If it is shared between a task and an ISR, the
+ * task has to access it with interrupts disabled.
+ */
+struct record_ring {
+    struct circular_buffer buffer;
+    size_t overwritten_records;
+    size_t overwritten_bytes;
+};
+
+/**
+ * Compile-time sized record ring definition. The data buffer is defined as
+ * well.
+ *
+ * @param RingName Name of the record ring identifier.
+ *
+ * @param Size     Size of the data buffer in bytes, including one length byte
+ *                 per record.
+ */
+#define RECORD_RING_DEFINE(RingName, Size)                        \
+    AVRTOS_STATIC_ASSERT((Size) > 1, RingName##_SizeIsTooSmall);  \
+    char RingName##_data[Size];                                   \
+    struct record_ring RingName = {                               \
+            .buffer = {.data = RingName##_data,                   \
+                       .head = 0,                                 \
+                       .capacity = (Size),                        \
+                       .occupancy = 0},                           \
+            .overwritten_records = 0,                             \
+            .overwritten_bytes = 0}
+
+/**
+ * Initializes the record ring and clears the overwrite counters.
+ *
+ * @param ring   Pointer to non NULL record ring.
+ *
+ * @param buffer Pointer to non NULL data buffer.
+ *
+ * @param size   Size of @ref buffer, greater than 1.
+ *
+ * @returns CIRC_BUFF_INVALID if ring or buffer are NULL or size is too small,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+record_ring_initialize(struct record_ring *ring, char *buffer, size_t size);
+
+/**
+ * Appends one record, dropping the oldest records if there is not enough
+ * space. Dropped records and their data bytes are added to
+ * @ref overwritten_records and @ref overwritten_bytes.
+ *
+ * @param ring   Pointer to non NULL record ring.
+ *
+ * @param record Pointer to non NULL record data.
+ *
+ * @param len    Length of the record. Together with its length byte, the
+ *               record has to fit into the data buffer.
+ *
+ * @returns CIRC_BUFF_INVALID if ring or record are NULL, the record can never
+ *          fit into the ring or the stored records are corrupted,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status record_ring_write(struct record_ring *ring,
+                                              const char *record,
+                                              uint8_t len);
+
+/**
+ * Gets the length of the oldest record without removing it.
+ *
+ * @param ring    Pointer to non NULL record ring.
+ *
+ * @param out_len Pointer to the non NULL variable to which the length will be
+ *                copied.
+ *
+ * @returns CIRC_BUFF_INVALID if ring or out_len are NULL,
+ *          CIRC_BUFF_EMPTY if there are no records,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status record_ring_peek_length(struct record_ring *ring,
+                                                    uint8_t *out_len);
+
+/**
+ * Removes the oldest record and copies it to @ref out_record. If
+ * @ref out_record is too small, the record is left in the ring.
+ *
+ * @param ring       Pointer to non NULL record ring.
+ *
+ * @param out_record Pointer to the non NULL array to which the record will be
+ *                   copied.
+ *
+ * @param size       Size of @ref out_record.
+ *
+ * @param out_len    Pointer to the non NULL variable to which the record length
+ *                   will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if ring, out_record or out_len are NULL or
+ *          out_record is too small,
+ *          CIRC_BUFF_EMPTY if there are no records,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status record_ring_read(struct record_ring *ring,
+                                             char *out_record,
+                                             size_t size,
+                                             uint8_t *out_len);
+
+/**
+ * Checks wether there are no records in the ring.
+ *
+ * @param ring Pointer to record ring.
+ *
+ * @returns true if there are no records or the ring is NULL,
+ *          false otherwise.
+ */
+static inline bool record_ring_is_empty(struct record_ring *ring) {
+    return ring ? circ_buff_is_empty(&ring->buffer) : true;
+}
+
+/**
+ * Removes all records and clears the overwrite counters.
+ *
+ * @param ring Pointer to non NULL record ring.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status record_ring_reset(struct record_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* RECORD_RING_ARCH_IND_H_ */
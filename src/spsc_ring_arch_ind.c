@@ -0,0 +1,155 @@
+#include "spsc_ring_arch_ind.h"
+
+/* Returns index + count wrapped to the ring size, count < ring size. */
+static uint8_t _spsc_ring_advance(struct spsc_ring *ring,
+                                  uint8_t index,
+                                  uint8_t count) {
+    uint16_t advanced = (uint16_t) index + count;
+
+    return (uint8_t)(advanced >= ring->size ? advanced - ring->size
+                                            : advanced);
+}
+
+/* Returns the length of the contiguous free region starting at tail. */
+static uint8_t _spsc_ring_free_contiguous(struct spsc_ring *ring,
+                                          uint8_t tail) {
+    uint8_t head = ring->head;
+    if (head > tail) {
+        return (uint8_t)(head - tail - 1);
+    }
+    /* the slot right before head has to stay free */
+    return (uint8_t)(ring->size - tail - (head == 0 ? 1 : 0));
+}
+
+enum circular_buffer_status
+spsc_ring_initialize(struct spsc_ring *ring, char *buffer, size_t size) {
+    if (!(ring && buffer && size >= SPSC_RING_MIN_SIZE
+          && size <= SPSC_RING_MAX_SIZE)) {
+        return CIRC_BUFF_INVALID;
+    }
+    ring->data = buffer;
+    ring->size = (uint8_t) size;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status spsc_ring_insert_one(struct spsc_ring *ring,
+                                                 char value) {
+    if (!ring) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t tail = ring->tail;
+    uint8_t next = _spsc_ring_next(ring, tail);
+    if (next == ring->head) {
+        return CIRC_BUFF_FULL;
+    }
+    ring->data[tail] = value;
+    /* the element has to be stored before it is published to the consumer */
+    AVRTOS_COMPILER_BARRIER();
+    ring->tail = next;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status spsc_ring_get_one(struct spsc_ring *ring,
+                                              char *out_value) {
+    if (!(ring && out_value)) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t head = ring->head;
+    if (head == ring->tail) {
+        return CIRC_BUFF_EMPTY;
+    }
+    /* the element must not be read before the producer's index */
+    AVRTOS_COMPILER_BARRIER();
+    *out_value = ring->data[head];
+    /* the element has to be read before its slot is given back */
+    AVRTOS_COMPILER_BARRIER();
+    ring->head = _spsc_ring_next(ring, head);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+spsc_ring_reserve(struct spsc_ring *ring, char **out_ptr, uint8_t *out_len) {
+    if (!(ring && out_ptr && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t tail = ring->tail;
+    *out_ptr = &ring->data[tail];
+    *out_len = _spsc_ring_free_contiguous(ring, tail);
+
+    return *out_len ? CIRC_BUFF_OK : CIRC_BUFF_FULL;
+}
+
+enum circular_buffer_status spsc_ring_commit(struct spsc_ring *ring,
+                                             uint8_t count) {
+    if (!ring) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t tail = ring->tail;
+    if (count > _spsc_ring_free_contiguous(ring, tail)) {
+        return CIRC_BUFF_INVALID;
+    }
+    /* the elements have to be stored before they are published */
+    AVRTOS_COMPILER_BARRIER();
+    ring->tail = _spsc_ring_advance(ring, tail, count);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status
+spsc_ring_stage(struct spsc_ring *ring, uint8_t offset, char value) {
+    if (!ring) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (offset >= spsc_ring_get_space_left(ring)) {
+        return CIRC_BUFF_FULL;
+    }
+    ring->data[_spsc_ring_advance(ring, ring->tail, offset)] = value;
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status spsc_ring_publish(struct spsc_ring *ring,
+                                              uint8_t count) {
+    if (!ring || count > spsc_ring_get_space_left(ring)) {
+        return CIRC_BUFF_INVALID;
+    }
+    /* the elements have to be stored before they are published */
+    AVRTOS_COMPILER_BARRIER();
+    ring->tail = _spsc_ring_advance(ring, ring->tail, count);
+
+    return CIRC_BUFF_OK;
+}
+
+enum circular_buffer_status spsc_ring_peek_contiguous(struct spsc_ring *ring,
+                                                      char **out_ptr,
+                                                      uint8_t *out_len) {
+    if (!(ring && out_ptr && out_len)) {
+        return CIRC_BUFF_INVALID;
+    }
+    uint8_t head = ring->head;
+    uint8_t tail = ring->tail;
+    /* the elements must not be read before the producer's index */
+    AVRTOS_COMPILER_BARRIER();
+    *out_ptr = &ring->data[head];
+    *out_len = tail >= head ? (uint8_t)(tail - head)
+                            : (uint8_t)(ring->size - head);
+
+    return *out_len ? CIRC_BUFF_OK : CIRC_BUFF_EMPTY;
+}
+
+enum circular_buffer_status spsc_ring_consume(struct spsc_ring *ring,
+                                              uint8_t count) {
+    if (!ring || count > spsc_ring_get_occupancy(ring)) {
+        return CIRC_BUFF_INVALID;
+    }
+    /* the elements have to be read before their slots are given back */
+    AVRTOS_COMPILER_BARRIER();
+    ring->head = _spsc_ring_advance(ring, ring->head, count);
+
+    return CIRC_BUFF_OK;
+}
@@ -0,0 +1,280 @@
+#ifndef SPSC_RING_ARCH_IND_H_
+#define SPSC_RING_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "circular_buffer_arch_ind.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * Minimum and maximum size of the @ref struct spsc_ring data buffer. One
+ * element is always kept free to distinguish a full ring from an empty one, so
+ * the capacity is equal to size - 1.
+ */
+#define SPSC_RING_MIN_SIZE 2
+#define SPSC_RING_MAX_SIZE 255
+
+/**
+ * Lock-free single-producer/single-consumer ring buffer. The producer (e.g. a
+ * task) modifies only @ref tail and the consumer (e.g. an ISR) modifies only
+ * @ref head. Both indices are single bytes, so each of them is read and written
+ * atomically and neither side has to disable interrupts.
+ *
+ * If there is more than one producer (or consumer), the callers on that side
+ * have to be serialized (e.g. with a mutex).
+ */
+struct spsc_ring {
+    char *data;
+    uint8_t size;
+    volatile uint8_t head;
+    volatile uint8_t tail;
+};
+
+/**
+ * Compile-time sized ring definition. The data buffer is defined as well.
+ *
+ * @param RingName Name of the ring identifier.
+ *
+ * @param Size     Size of the data buffer, in range [@ref SPSC_RING_MIN_SIZE,
+ *                 @ref SPSC_RING_MAX_SIZE]. The ring holds up to Size - 1
+ *                 elements.
+ */
+#define SPSC_RING_DEFINE(RingName, Size)                                 \
+    AVRTOS_STATIC_ASSERT((Size) >= SPSC_RING_MIN_SIZE                    \
+                                 && (Size) <= SPSC_RING_MAX_SIZE,        \
+                         RingName##_SizeIsNotValid);                     \
+    char RingName##_data[Size];                                          \
+    struct spsc_ring RingName = {.data = RingName##_data,                \
+                                 .size = (uint8_t)(Size),                \
+                                 .head = 0,                              \
+                                 .tail = 0}
+
+/**
+ * Initializes the ring. Requires a pointer to non NULL ring, data buffer and
+ * data buffer's size. Must not be called while the ring is in use.
+ *
+ * @param ring   Pointer to non NULL ring.
+ *
+ * @param buffer Pointer to non NULL data buffer.
+ *
+ * @param size   Size of @ref buffer, in range [@ref SPSC_RING_MIN_SIZE,
+ *               @ref SPSC_RING_MAX_SIZE].
+ *
+ * @returns CIRC_BUFF_INVALID if ring or buffer are NULL or size is out of
+ *          range,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+spsc_ring_initialize(struct spsc_ring *ring, char *buffer, size_t size);
+
+/**
+ * Inserts one element into the ring. Producer side only.
+ *
+ * @param ring  Pointer to non NULL ring.
+ *
+ * @param value A value we want to insert into the ring.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL,
+ *          CIRC_BUFF_FULL if there is no space in the ring,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_insert_one(struct spsc_ring *ring,
+                                                 char value);
+
+/**
+ * Gets one element from the ring. Consumer side only.
+ *
+ * @param ring      Pointer to non NULL ring.
+ *
+ * @param out_value Pointer to the non NULL variable to which the result will be
+ *                  copied.
+ *
+ * @returns CIRC_BUFF_INVALID if ring or out_value are NULL,
+ *          CIRC_BUFF_EMPTY if there is no value to retrieve,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_get_one(struct spsc_ring *ring,
+                                              char *out_value);
+
+/**
+ * Gets the contiguous free region starting at the producer's index, so the
+ * producer can write into the ring directly. The written elements become
+ * visible to the consumer after @ref spsc_ring_commit. Producer side only.
+ *
+ * @param ring    Pointer to non NULL ring.
+ *
+ * @param out_ptr Pointer to the non NULL variable to which the start of the
+ *                region will be copied.
+ *
+ * @param out_len Pointer to the non NULL variable to which the length of the
+ *                region will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if ring, out_ptr or out_len are NULL,
+ *          CIRC_BUFF_FULL if the contiguous free region is empty,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+spsc_ring_reserve(struct spsc_ring *ring, char **out_ptr, uint8_t *out_len);
+
+/**
+ * Publishes @ref count elements written into the region returned by
+ * @ref spsc_ring_reserve. Producer side only.
+ *
+ * @param ring  Pointer to non NULL ring.
+ *
+ * @param count Number of written elements, not greater than the reserved
+ *              length.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL or count is greater than the
+ *          contiguous free region,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_commit(struct spsc_ring *ring,
+                                             uint8_t count);
+
+/**
+ * Writes an element @p offset positions after the producer's index without
+ * publishing it, so a producer can build a message of several elements (also
+ * across the end of the data buffer) that becomes visible to the consumer at
+ * once, after @ref spsc_ring_publish. Producer side only.
+ *
+ * @param ring   Pointer to non NULL ring.
+ *
+ * @param offset Position of the element after the producer's index.
+ *
+ * @param value  Value to be written.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL,
+ *          CIRC_BUFF_FULL if the element does not fit into the free space,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status
+spsc_ring_stage(struct spsc_ring *ring, uint8_t offset, char value);
+
+/**
+ * Publishes @p count elements written with @ref spsc_ring_stage. Producer side
+ * only.
+ *
+ * @param ring  Pointer to non NULL ring.
+ *
+ * @param count Number of staged elements.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL or count is greater than the free
+ *          space,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_publish(struct spsc_ring *ring,
+                                              uint8_t count);
+
+/**
+ * Gets the contiguous region of elements starting at the consumer's index, so
+ * the consumer can read them directly (e.g. to transmit them). The elements are
+ * released by @ref spsc_ring_consume. Consumer side only.
+ *
+ * @param ring    Pointer to non NULL ring.
+ *
+ * @param out_ptr Pointer to the non NULL variable to which the start of the
+ *                region will be copied.
+ *
+ * @param out_len Pointer to the non NULL variable to which the length of the
+ *                region will be copied.
+ *
+ * @returns CIRC_BUFF_INVALID if ring, out_ptr or out_len are NULL,
+ *          CIRC_BUFF_EMPTY if there are no elements in the ring,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_peek_contiguous(struct spsc_ring *ring,
+                                                      char **out_ptr,
+                                                      uint8_t *out_len);
+
+/**
+ * Releases @ref count elements from the front of the ring. Consumer side only.
+ *
+ * @param ring  Pointer to non NULL ring.
+ *
+ * @param count Number of elements to release, not greater than the occupancy.
+ *
+ * @returns CIRC_BUFF_INVALID if ring is NULL or count is greater than the
+ *          occupancy,
+ *          CIRC_BUFF_OK otherwise.
+ */
+enum circular_buffer_status spsc_ring_consume(struct spsc_ring *ring,
+                                              uint8_t count);
+
+/**
+ * Returns the index following @p index. Should be a "private" function.
+ */
+static inline uint8_t _spsc_ring_next(struct spsc_ring *ring, uint8_t index) {
+    index++;
+    return index == ring->size ? 0 : index;
+}
+
+/**
+ * Gets the number of elements currently in the ring. The value is a snapshot:
+ * it can only grow when read by the consumer and only shrink when read by the
+ * producer.
+ *
+ * @param ring Pointer to non NULL ring.
+ *
+ * @returns Number of elements in the ring (0 if ring is NULL).
+ */
+static inline uint8_t spsc_ring_get_occupancy(struct spsc_ring *ring) {
+    if (!ring) {
+        return 0;
+    }
+    uint8_t head = ring->head;
+    uint8_t tail = ring->tail;
+
+    return tail >= head ? (uint8_t)(tail - head)
+                        : (uint8_t)(ring->size - head + tail);
+}
+
+/**
+ * Gets the number of elements that can be inserted into the ring at the
+ * moment.
+ *
+ * @param ring Pointer to non NULL ring.
+ *
+ * @returns Number of free elements in the ring (0 if ring is NULL).
+ */
+static inline uint8_t spsc_ring_get_space_left(struct spsc_ring *ring) {
+    return ring ? (uint8_t)(ring->size - 1 - spsc_ring_get_occupancy(ring))
+                : 0;
+}
+
+/**
+ * Checks wether the ring is empty.
+ *
+ * @param ring Pointer to ring.
+ *
+ * @returns true if there are no elements in the ring or the ring is NULL,
+ *          false otherwise.
+ */
+static inline bool spsc_ring_is_empty(struct spsc_ring *ring) {
+    return ring ? ring->head == ring->tail : true;
+}
+
+/**
+ * Checks wether the ring is full.
+ *
+ * @param ring Pointer to ring.
+ *
+ * @returns true if there is no space left in the ring or the ring is NULL,
+ *          false otherwise.
+ */
+static inline bool spsc_ring_is_full(struct spsc_ring *ring) {
+    return ring ? _spsc_ring_next(ring, ring->tail) == ring->head : true;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* SPSC_RING_ARCH_IND_H_ */
@@ -0,0 +1,115 @@
+#include "trace_arch_ind.h"
+
+#ifdef AVRTOS_WITH_TRACE
+
+#define TRACE_INDEX_MASK (AVRTOS_TRACE_BUFFER_SIZE - 1)
+
+/* written by tasks and ISRs with interrupts disabled */
+static struct avrtos_trace_event g_trace_buffer[AVRTOS_TRACE_BUFFER_SIZE];
+static uint8_t g_trace_head;
+static uint8_t g_trace_count;
+static uint16_t g_trace_lost;
+static uint8_t g_trace_mask = AVRTOS_TRACE_DEFAULT_MASK;
+
+void avrtos_trace_set_mask(uint8_t mask) {
+    g_trace_mask = mask;
+}
+
+uint8_t avrtos_trace_get_mask(void) {
+    return g_trace_mask;
+}
+
+void avrtos_trace_marker(uint8_t id) {
+    _avrtos_trace_record(AVRTOS_TRACE_MARKER, id);
+}
+
+uint8_t avrtos_trace_get_count(void) {
+    return g_trace_count;
+}
+
+void _avrtos_trace_record(uint8_t type, uint8_t arg) {
+    if (!(g_trace_mask & (1 << (type >> 4)))) {
+        return;
+    }
+
+    uint8_t key = avrtos_irq_lock_impl();
+    uint8_t tail = (g_trace_head + g_trace_count) & TRACE_INDEX_MASK;
+    if (g_trace_count == AVRTOS_TRACE_BUFFER_SIZE) {
+        /* flight recorder, the newest events are the interesting ones */
+        g_trace_head = (g_trace_head + 1) & TRACE_INDEX_MASK;
+        if (g_trace_lost < UINT16_MAX) {
+            g_trace_lost++;
+        }
+    } else {
+        g_trace_count++;
+    }
+    struct avrtos_trace_event *event = &g_trace_buffer[tail];
+    event->type = type;
+    event->arg = arg;
+    avrtos_trace_timestamp_impl(&event->ticks, &event->subticks);
+    avrtos_irq_unlock_impl(key);
+}
+
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+static void trace_frame_send(char *frame, uint8_t len) {
+    uint8_t checksum = 0;
+    frame[0] = (char) AVRTOS_TRACE_SYNC;
+    for (uint8_t i = 1; i < len - 1; i++) {
+        checksum += (uint8_t) frame[i];
+    }
+    frame[len - 1] = (char) checksum;
+    (void) avrtos_log_write_impl(frame, len, true);
+}
+
+static bool trace_pop(struct avrtos_trace_event *out_event) {
+    bool popped = false;
+    uint8_t key = avrtos_irq_lock_impl();
+    if (g_trace_count) {
+        *out_event = g_trace_buffer[g_trace_head];
+        g_trace_head = (g_trace_head + 1) & TRACE_INDEX_MASK;
+        g_trace_count--;
+        popped = true;
+    }
+    avrtos_irq_unlock_impl(key);
+
+    return popped;
+}
+
+void avrtos_trace_dump(void) {
+    char frame[AVRTOS_TRACE_HEADER_FRAME_SIZE];
+
+    /* events recorded during the dump (e.g. by the logger mutex) are left for
+       the next one */
+    uint8_t key = avrtos_irq_lock_impl();
+    uint8_t count = g_trace_count;
+    uint16_t lost = g_trace_lost;
+    g_trace_lost = 0;
+    avrtos_irq_unlock_impl(key);
+
+    avrtos_log_lock_impl();
+    frame[1] = AVRTOS_TRACE_FRAME_HEADER;
+    frame[2] = AVRTOS_TRACE_VERSION;
+    frame[3] = (char) (AVRTOS_DELAY_TICK_PERIOD_US & 0xFF);
+    frame[4] = (char) (AVRTOS_DELAY_TICK_PERIOD_US >> 8);
+    frame[5] = (char) avrtos_trace_get_subticks_per_tick_impl();
+    frame[6] = (char) (lost & 0xFF);
+    frame[7] = (char) (lost >> 8);
+    trace_frame_send(frame, AVRTOS_TRACE_HEADER_FRAME_SIZE);
+
+    struct avrtos_trace_event event;
+    while (count-- && trace_pop(&event)) {
+        frame[1] = AVRTOS_TRACE_FRAME_EVENT;
+        frame[2] = (char) event.type;
+        frame[3] = (char) event.arg;
+        frame[4] = (char) (event.ticks & 0xFF);
+        frame[5] = (char) (event.ticks >> 8);
+        frame[6] = (char) event.subticks;
+        trace_frame_send(frame, AVRTOS_TRACE_EVENT_FRAME_SIZE);
+    }
+    avrtos_log_unlock_impl();
+}
+
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+#endif // AVRTOS_WITH_TRACE
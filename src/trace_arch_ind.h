@@ -0,0 +1,158 @@
+#ifndef TRACE_ARCH_IND_H_
+#define TRACE_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "boards/avrtos_board_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * Groups of trace events, used as bits of the trace mask. The category of an
+ * event is stored in the upper nibble of its type.
+ */
+#define AVRTOS_TRACE_TASKS (1 << 0)
+#define AVRTOS_TRACE_ISRS (1 << 1)
+#define AVRTOS_TRACE_MUTEXES (1 << 2)
+#define AVRTOS_TRACE_DELAYS (1 << 3)
+#define AVRTOS_TRACE_MARKERS (1 << 4)
+#define AVRTOS_TRACE_ALL                                           \
+    (AVRTOS_TRACE_TASKS | AVRTOS_TRACE_ISRS | AVRTOS_TRACE_MUTEXES \
+     | AVRTOS_TRACE_DELAYS | AVRTOS_TRACE_MARKERS)
+
+/**
+ * Types of trace events. The argument of an event is:
+ * - task ID for task switches and delays,
+ * - interrupt vector number for ISR entry and exit,
+ * - low byte of the mutex address for mutex events (the task is the one that
+ *   has been switched in last),
+ * - user-defined ID for markers.
+ */
+enum avrtos_trace_event_type {
+    AVRTOS_TRACE_TASK_SWITCH_IN = 0x00,
+    AVRTOS_TRACE_TASK_SWITCH_OUT = 0x01,
+    AVRTOS_TRACE_ISR_ENTER = 0x10,
+    AVRTOS_TRACE_ISR_EXIT = 0x11,
+    AVRTOS_TRACE_MUTEX_LOCK = 0x20,
+    AVRTOS_TRACE_MUTEX_BLOCK = 0x21,
+    AVRTOS_TRACE_MUTEX_UNLOCK = 0x22,
+    AVRTOS_TRACE_DELAY_START = 0x30,
+    AVRTOS_TRACE_DELAY_EXPIRE = 0x31,
+    AVRTOS_TRACE_MARKER = 0x40
+};
+
+#ifdef AVRTOS_WITH_TRACE
+
+#ifndef AVRTOS_TRACE_BUFFER_SIZE
+#define AVRTOS_TRACE_BUFFER_SIZE 32
+#endif // AVRTOS_TRACE_BUFFER_SIZE
+
+#ifndef AVRTOS_TRACE_DEFAULT_MASK
+#define AVRTOS_TRACE_DEFAULT_MASK AVRTOS_TRACE_ALL
+#endif // AVRTOS_TRACE_DEFAULT_MASK
+
+AVRTOS_STATIC_ASSERT(AVRTOS_TRACE_BUFFER_SIZE >= 2
+                             && AVRTOS_TRACE_BUFFER_SIZE <= 128
+                             && (AVRTOS_TRACE_BUFFER_SIZE
+                                 & (AVRTOS_TRACE_BUFFER_SIZE - 1))
+                                        == 0,
+                     TraceBufferSizeIsNotValid);
+
+/**
+ * Single trace event. Timestamp consists of the low 16 bits of the delay timer
+ * tick counter and the delay timer count within the tick.
+ */
+struct avrtos_trace_event {
+    uint8_t type;
+    uint8_t arg;
+    uint16_t ticks;
+    uint8_t subticks;
+};
+
+/**
+ * Dump frame layout (all fields little-endian):
+ * | sync (1) | kind (1) | payload | checksum (1) |
+ * Checksum is the 8-bit sum of kind and payload. Payload of the header frame:
+ * | version (1) | tick period in us (2) | subticks per tick (1) |
+ * | lost events (2) |
+ * Payload of the event frame:
+ * | type (1) | argument (1) | ticks (2) | subticks (1) |
+ */
+#define AVRTOS_TRACE_SYNC 0xA7
+#define AVRTOS_TRACE_FRAME_HEADER 'H'
+#define AVRTOS_TRACE_FRAME_EVENT 'E'
+#define AVRTOS_TRACE_VERSION 1
+#define AVRTOS_TRACE_HEADER_FRAME_SIZE 9
+#define AVRTOS_TRACE_EVENT_FRAME_SIZE 8
+
+/**
+ * Selects the groups of events that are recorded, 0 stops the recording.
+ *
+ * @param mask Bitwise OR of AVRTOS_TRACE_TASKS, AVRTOS_TRACE_ISRS, etc.
+ */
+void avrtos_trace_set_mask(uint8_t mask);
+
+/**
+ * Returns the groups of events that are recorded.
+ */
+uint8_t avrtos_trace_get_mask(void);
+
+/**
+ * Records a user marker event.
+ *
+ * @param id User-defined marker ID.
+ */
+void avrtos_trace_marker(uint8_t id);
+
+/**
+ * Returns the number of recorded events that have not been dumped yet.
+ */
+uint8_t avrtos_trace_get_count(void);
+
+/**
+ * Sends the recorded events over the logger USART and removes them from the
+ * trace buffer: a header frame followed by one frame per event, oldest first.
+ * Events recorded in the meantime are kept for the next dump, so calling it
+ * periodically streams the trace. Waits until the USART has sent enough data.
+ * Use tools/avrtos_trace_export.py to convert the output.
+ */
+#ifdef AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+void avrtos_trace_dump(void);
+#endif // AVRTOS_WITH_ASYNCHRONOUS_LOGGER
+
+/**
+ * Records a trace event if its group is enabled. When the trace buffer is
+ * full, the oldest event is overwritten and counted as lost. Can be called
+ * from ISRs. Should be a "private" function.
+ *
+ * @param type Type of the event (@ref enum avrtos_trace_event_type).
+ *
+ * @param arg  Argument of the event.
+ */
+void _avrtos_trace_record(uint8_t type, uint8_t arg);
+
+#else // AVRTOS_WITH_TRACE
+
+#define avrtos_trace_set_mask(...) \
+    do {                           \
+    } while (0)
+#define avrtos_trace_marker(...) \
+    do {                         \
+    } while (0)
+#define avrtos_trace_dump(...) \
+    do {                       \
+    } while (0)
+
+#endif // AVRTOS_WITH_TRACE
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* TRACE_ARCH_IND_H_ */
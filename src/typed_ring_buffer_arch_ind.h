@@ -0,0 +1,305 @@
+#ifndef TYPED_RING_BUFFER_ARCH_IND_H_
+#define TYPED_RING_BUFFER_ARCH_IND_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "avrtos_config.h"
+#include "avrtos_utils.h"
+#include "circular_buffer_arch_ind.h"
+
+/**
+ * Declares a ring buffer of @p Type elements: struct @p Name and its
+ * functions, all prefixed with @p Name (e.g. Name_insert_one()). Functions
+ * mirror the @ref struct circular_buffer API and return the same status codes,
+ * elements are copied with memcpy using sizeof(@p Type).
+ *
+ * @param Name Name of the generated struct and prefix of the functions.
+ *
+ * @param Type Type of the elements.
+ */
+#define TYPED_RING_BUFFER_DECLARE(Name, Type)                                  \
+    struct Name {                                                              \
+        Type *data;                                                            \
+        size_t head;                                                           \
+        size_t capacity;                                                       \
+        size_t occupancy;                                                      \
+    };                                                                         \
+                                                                               \
+    static inline enum circular_buffer_status Name##_initialize(               \
+            struct Name *ring, Type *buffer, size_t capacity) {                \
+        if (!(ring && buffer && capacity > 0)) {                               \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        ring->data = buffer;                                                   \
+        ring->head = 0;                                                        \
+        ring->capacity = capacity;                                             \
+        ring->occupancy = 0;                                                   \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline size_t _##Name##_wrap(struct Name *ring, size_t index) {     \
+        return index >= ring->capacity ? index - ring->capacity : index;       \
+    }                                                                          \
+                                                                               \
+    static inline enum circular_buffer_status Name##_insert_one(               \
+            struct Name *ring, const Type *value) {                            \
+        if (!(ring && value)) {                                                \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        if (ring->occupancy == ring->capacity) {                               \
+            return CIRC_BUFF_FULL;                                             \
+        }                                                                      \
+        ring->data[_##Name##_wrap(ring, ring->head + ring->occupancy)] =       \
+                *value;                                                        \
+        ring->occupancy++;                                                     \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline enum circular_buffer_status Name##_get_one(                  \
+            struct Name *ring, Type *out_value) {                              \
+        if (!(ring && out_value)) {                                            \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        if (ring->occupancy == 0) {                                            \
+            return CIRC_BUFF_EMPTY;                                            \
+        }                                                                      \
+        *out_value = ring->data[ring->head];                                   \
+        ring->head = _##Name##_wrap(ring, ring->head + 1);                     \
+        ring->occupancy--;                                                     \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline enum circular_buffer_status Name##_insert_few(               \
+            struct Name *ring, const Type *values, size_t count) {             \
+        if (!(ring && values)) {                                               \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        if (ring->capacity - ring->occupancy < count) {                        \
+            return CIRC_BUFF_FULL;                                             \
+        }                                                                      \
+        size_t tail = _##Name##_wrap(ring, ring->head + ring->occupancy);      \
+        size_t first_segment = ring->capacity - tail;                          \
+        if (first_segment > count) {                                           \
+            first_segment = count;                                             \
+        }                                                                      \
+        memcpy(&ring->data[tail], values, first_segment * sizeof(Type));       \
+        memcpy(ring->data, &values[first_segment],                             \
+               (count - first_segment) * sizeof(Type));                        \
+        ring->occupancy += count;                                              \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline enum circular_buffer_status Name##_get_few(                  \
+            struct Name *ring, Type *out_values, size_t count) {               \
+        if (!(ring && out_values)) {                                           \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        if (ring->occupancy < count) {                                         \
+            return CIRC_BUFF_EMPTY;                                            \
+        }                                                                      \
+        size_t first_segment = ring->capacity - ring->head;                    \
+        if (first_segment > count) {                                           \
+            first_segment = count;                                             \
+        }                                                                      \
+        memcpy(out_values, &ring->data[ring->head],                            \
+               first_segment * sizeof(Type));                                  \
+        memcpy(&out_values[first_segment], ring->data,                         \
+               (count - first_segment) * sizeof(Type));                        \
+        ring->head = _##Name##_wrap(ring, ring->head + count);                 \
+        ring->occupancy -= count;                                              \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline size_t Name##_get_occupancy(struct Name *ring) {             \
+        return ring ? ring->occupancy : 0;                                     \
+    }                                                                          \
+                                                                               \
+    static inline size_t Name##_get_space_left(struct Name *ring) {            \
+        return ring ? ring->capacity - ring->occupancy : 0;                    \
+    }                                                                          \
+                                                                               \
+    static inline bool Name##_is_full(struct Name *ring) {                     \
+        return ring ? ring->occupancy == ring->capacity : true;                \
+    }                                                                          \
+                                                                               \
+    static inline bool Name##_is_empty(struct Name *ring) {                    \
+        return ring ? ring->occupancy == 0 : true;                             \
+    }                                                                          \
+                                                                               \
+    static inline enum circular_buffer_status Name##_reset(                    \
+            struct Name *ring) {                                               \
+        if (!ring) {                                                           \
+            return CIRC_BUFF_INVALID;                                          \
+        }                                                                      \
+        ring->head = 0;                                                        \
+        ring->occupancy = 0;                                                   \
+                                                                               \
+        return CIRC_BUFF_OK;                                                   \
+    }                                                                          \
+    struct Name
+
+/**
+ * Compile-time sized ring buffer definition of a type declared with
+ * @ref TYPED_RING_BUFFER_DECLARE. The data buffer is defined as well.
+ *
+ * @param Name     Name used in @ref TYPED_RING_BUFFER_DECLARE.
+ *
+ * @param Type     Type of the elements.
+ *
+ * @param BuffName Name of the ring buffer identifier.
+ *
+ * @param Size     Capacity of the ring buffer (number of elements).
+ */
+#define TYPED_RING_BUFFER_DEFINE(Name, Type, BuffName, Size)   \
+    AVRTOS_STATIC_ASSERT((Size) > 0, BuffName##_SizeIsZero);   \
+    Type BuffName##_data[Size];                                \
+    struct Name BuffName = {.data = BuffName##_data,           \
+                            .head = 0,                         \
+                            .capacity = (Size),                \
+                            .occupancy = 0}
+
+#ifdef __cplusplus
+
+namespace avrtos {
+
+/**
+ * Selects the narrowest unsigned type able to hold values up to N. Should be a
+ * "private" type.
+ */
+template <bool FitsInByte>
+struct _RingBufferIndex {
+    typedef uint16_t Type;
+};
+
+template <>
+struct _RingBufferIndex<true> {
+    typedef uint8_t Type;
+};
+
+/**
+ * Statically sized ring buffer of N elements of type T. Indices use the
+ * narrowest type that fits N, there are no virtual calls and elements are
+ * copied using T's assignment.
+ */
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0, "RingBuffer capacity must be greater than zero");
+    /* avr-libc does not provide the limit macros in C++ by default */
+    static_assert(N <= 0xFFFFU, "RingBuffer capacity is too big");
+
+    typedef typename _RingBufferIndex<(N <= 0xFFU)>::Type Index;
+
+public:
+    RingBuffer() : head_(0), occupancy_(0) {}
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+    size_t size() const {
+        return occupancy_;
+    }
+
+    size_t space_left() const {
+        return N - occupancy_;
+    }
+
+    bool empty() const {
+        return occupancy_ == 0;
+    }
+
+    bool full() const {
+        return occupancy_ == N;
+    }
+
+    void clear() {
+        head_ = 0;
+        occupancy_ = 0;
+    }
+
+    /**
+     * Inserts one element, returns false if the buffer is full.
+     */
+    bool push(const T &value) {
+        if (full()) {
+            return false;
+        }
+        data_[wrap(head_ + occupancy_)] = value;
+        occupancy_++;
+        return true;
+    }
+
+    /**
+     * Gets one element, returns false if the buffer is empty.
+     */
+    bool pop(T &out_value) {
+        if (empty()) {
+            return false;
+        }
+        out_value = data_[head_];
+        head_ = static_cast<Index>(wrap(head_ + 1));
+        occupancy_--;
+        return true;
+    }
+
+    /**
+     * Inserts up to @p count elements in at most two contiguous segments,
+     * returns the number of inserted elements.
+     */
+    size_t push(const T *values, size_t count) {
+        if (count > space_left()) {
+            count = space_left();
+        }
+        size_t tail = wrap(head_ + occupancy_);
+        size_t first_segment = N - tail < count ? N - tail : count;
+        copy(&data_[tail], values, first_segment);
+        copy(data_, &values[first_segment], count - first_segment);
+        occupancy_ = static_cast<Index>(occupancy_ + count);
+        return count;
+    }
+
+    /**
+     * Gets up to @p count elements in at most two contiguous segments, returns
+     * the number of retrieved elements.
+     */
+    size_t pop(T *out_values, size_t count) {
+        if (count > occupancy_) {
+            count = occupancy_;
+        }
+        size_t first_segment = N - head_ < count ? N - head_ : count;
+        copy(out_values, &data_[head_], first_segment);
+        copy(&out_values[first_segment], data_, count - first_segment);
+        head_ = static_cast<Index>(wrap(head_ + count));
+        occupancy_ = static_cast<Index>(occupancy_ - count);
+        return count;
+    }
+
+private:
+    static size_t wrap(size_t index) {
+        return index >= N ? index - N : index;
+    }
+
+    static void copy(T *destination, const T *source, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            destination[i] = source[i];
+        }
+    }
+
+    T data_[N];
+    Index head_;
+    Index occupancy_;
+};
+
+} // namespace avrtos
+
+#endif // __cplusplus
+
+#endif /* TYPED_RING_BUFFER_ARCH_IND_H_ */
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Default number of operations performed by a single benchmark case.
+ */
+#define BENCHMARK_ITERATIONS 10000000UL
+
+static inline double benchmark_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/**
+ * Runs @p Body @p Iterations times and prints the average time of a single
+ * iteration.
+ */
+#define BENCHMARK_RUN_N(Name, Iterations, Body)                          \
+    do {                                                                 \
+        double _start = benchmark_now_ns();                              \
+        for (unsigned long _i = 0; _i < (Iterations); _i++) {            \
+            Body;                                                        \
+        }                                                                \
+        double _elapsed = benchmark_now_ns() - _start;                   \
+        printf("%-40s %10.2f ns/op\n", Name,                             \
+               _elapsed / (double) (Iterations));                        \
+    } while (0)
+
+/**
+ * Runs @p Body @ref BENCHMARK_ITERATIONS times and prints the average time of
+ * a single iteration.
+ */
+#define BENCHMARK_RUN(Name, Body) \
+    BENCHMARK_RUN_N(Name, BENCHMARK_ITERATIONS, Body)
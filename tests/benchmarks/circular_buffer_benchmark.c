@@ -0,0 +1,99 @@
+#include "benchmark_utils.h"
+
+#include <circular_buffer_arch_ind.h>
+#include <circular_buffer_pow2_arch_ind.h>
+
+#define BENCHMARK_BUFF_SIZE 64
+#define BENCHMARK_FRAME_SIZE 1024
+#define BENCHMARK_FRAME_ITERATIONS 100000UL
+
+/* modulo-based indexing used by circular_buffer before it became
+   division-free, kept here as the reference */
+static enum circular_buffer_status
+modulo_insert_one(struct circular_buffer *circ_buff, char value) {
+    if (!circ_buff) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (!circ_buff_has_space_for_one(circ_buff)) {
+        return CIRC_BUFF_FULL;
+    }
+    circ_buff->data[(circ_buff->head + circ_buff->occupancy)
+                    % circ_buff->capacity] = value;
+    circ_buff->occupancy++;
+
+    return CIRC_BUFF_OK;
+}
+
+static enum circular_buffer_status
+modulo_get_one(struct circular_buffer *circ_buff, char *out_value) {
+    if (!(circ_buff && out_value)) {
+        return CIRC_BUFF_INVALID;
+    }
+    if (circ_buff_is_empty(circ_buff)) {
+        return CIRC_BUFF_EMPTY;
+    }
+    *out_value = circ_buff->data[circ_buff->head++];
+    circ_buff->head %= circ_buff->capacity;
+    circ_buff->occupancy--;
+
+    return CIRC_BUFF_OK;
+}
+
+char buffer[BENCHMARK_BUFF_SIZE];
+char frame_buffer[4 * BENCHMARK_FRAME_SIZE];
+char frame[BENCHMARK_FRAME_SIZE];
+struct circular_buffer circ_buff;
+CIRC_BUFF_POW2_DEFINE(circ_buff_pow2, BENCHMARK_BUFF_SIZE);
+volatile char sink;
+
+int main(void) {
+    char value;
+
+    (void) circ_buff_initialize(&circ_buff, buffer, BENCHMARK_BUFF_SIZE);
+    BENCHMARK_RUN("circular_buffer (modulo) insert+get", {
+        (void) modulo_insert_one(&circ_buff, (char) _i);
+        (void) modulo_get_one(&circ_buff, &value);
+        sink = value;
+    });
+
+    (void) circ_buff_initialize(&circ_buff, buffer, BENCHMARK_BUFF_SIZE);
+    BENCHMARK_RUN("circular_buffer insert+get", {
+        (void) circ_buff_insert_one(&circ_buff, (char) _i);
+        (void) circ_buff_get_one(&circ_buff, &value);
+        sink = value;
+    });
+
+    BENCHMARK_RUN("circular_buffer_pow2 insert+get", {
+        (void) circ_buff_pow2_insert_one(&circ_buff_pow2, (char) _i);
+        (void) circ_buff_pow2_get_one(&circ_buff_pow2, &value);
+        sink = value;
+    });
+
+    /* kilobyte frames, the write position moves by a non-multiple of the
+       capacity so the copies are split */
+    (void) circ_buff_initialize(&circ_buff, frame_buffer,
+                                sizeof(frame_buffer) - 1);
+    BENCHMARK_RUN_N("circular_buffer 1 KiB frame per byte",
+                    BENCHMARK_FRAME_ITERATIONS, {
+                        for (size_t j = 0; j < BENCHMARK_FRAME_SIZE; j++) {
+                            (void) circ_buff_insert_one(&circ_buff, frame[j]);
+                        }
+                        for (size_t j = 0; j < BENCHMARK_FRAME_SIZE; j++) {
+                            (void) circ_buff_get_one(&circ_buff, &frame[j]);
+                        }
+                        sink = frame[_i % BENCHMARK_FRAME_SIZE];
+                    });
+
+    (void) circ_buff_initialize(&circ_buff, frame_buffer,
+                                sizeof(frame_buffer) - 1);
+    BENCHMARK_RUN_N("circular_buffer 1 KiB frame bulk",
+                    BENCHMARK_FRAME_ITERATIONS, {
+                        (void) circ_buff_insert_few(&circ_buff, frame,
+                                                    BENCHMARK_FRAME_SIZE);
+                        (void) circ_buff_get_few(&circ_buff, frame,
+                                                 BENCHMARK_FRAME_SIZE);
+                        sink = frame[_i % BENCHMARK_FRAME_SIZE];
+                    });
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "benchmark_utils.h"
+
+#include <circular_buffer_arch_ind.h>
+#include <typed_ring_buffer_arch_ind.h>
+
+#define BENCHMARK_RING_SIZE 64
+#define BENCHMARK_BLOCK_SIZE 16
+
+TYPED_RING_BUFFER_DECLARE(u16_ring, uint16_t);
+
+char byte_buffer[BENCHMARK_RING_SIZE * sizeof(uint16_t)];
+struct circular_buffer byte_ring;
+uint16_t u16_buffer[BENCHMARK_RING_SIZE];
+struct u16_ring typed_ring;
+avrtos::RingBuffer<uint16_t, BENCHMARK_RING_SIZE> template_ring;
+uint16_t block[BENCHMARK_BLOCK_SIZE];
+volatile uint16_t sink;
+
+int main(void) {
+    uint16_t value;
+
+    /* uint16_t samples serialized by hand through the char buffer */
+    (void) circ_buff_initialize(&byte_ring, byte_buffer, sizeof(byte_buffer));
+    BENCHMARK_RUN("circular_buffer uint16_t insert+get", {
+        value = static_cast<uint16_t>(_i);
+        (void) circ_buff_insert_few(&byte_ring,
+                                    reinterpret_cast<char *>(&value),
+                                    sizeof(value));
+        (void) circ_buff_get_few(&byte_ring, reinterpret_cast<char *>(&value),
+                                 sizeof(value));
+        sink = value;
+    });
+
+    (void) u16_ring_initialize(&typed_ring, u16_buffer, BENCHMARK_RING_SIZE);
+    BENCHMARK_RUN("typed ring (C) uint16_t insert+get", {
+        value = static_cast<uint16_t>(_i);
+        (void) u16_ring_insert_one(&typed_ring, &value);
+        (void) u16_ring_get_one(&typed_ring, &value);
+        sink = value;
+    });
+
+    BENCHMARK_RUN("RingBuffer<uint16_t> push+pop", {
+        (void) template_ring.push(static_cast<uint16_t>(_i));
+        (void) template_ring.pop(value);
+        sink = value;
+    });
+
+    (void) circ_buff_reset(&byte_ring);
+    BENCHMARK_RUN("circular_buffer 16 x uint16_t block", {
+        (void) circ_buff_insert_few(&byte_ring, reinterpret_cast<char *>(block),
+                                    sizeof(block));
+        (void) circ_buff_get_few(&byte_ring, reinterpret_cast<char *>(block),
+                                 sizeof(block));
+        sink = block[_i % BENCHMARK_BLOCK_SIZE];
+    });
+
+    (void) u16_ring_reset(&typed_ring);
+    BENCHMARK_RUN("typed ring (C) 16 x uint16_t block", {
+        (void) u16_ring_insert_few(&typed_ring, block, BENCHMARK_BLOCK_SIZE);
+        (void) u16_ring_get_few(&typed_ring, block, BENCHMARK_BLOCK_SIZE);
+        sink = block[_i % BENCHMARK_BLOCK_SIZE];
+    });
+
+    BENCHMARK_RUN("RingBuffer<uint16_t> 16 x uint16_t block", {
+        (void) template_ring.push(block, BENCHMARK_BLOCK_SIZE);
+        (void) template_ring.pop(block, BENCHMARK_BLOCK_SIZE);
+        sink = block[_i % BENCHMARK_BLOCK_SIZE];
+    });
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <circular_buffer_pow2_arch_ind.h>
+
+#define UNIT_TEST_CIRC_BUFF_SIZE 16
+CIRC_BUFF_POW2_DEFINE(test_circ_buff, UNIT_TEST_CIRC_BUFF_SIZE);
+
+void setUp(void) {
+    /* set all global buffer values to zero */
+    for (size_t i = 0; i < UNIT_TEST_CIRC_BUFF_SIZE; i++) {
+        test_circ_buff_data[i] = '\0';
+    }
+
+    /* initialize buffer before each test, critical part*/
+    enum circular_buffer_status ret =
+            circ_buff_pow2_initialize(&test_circ_buff, test_circ_buff_data,
+                                      UNIT_TEST_CIRC_BUFF_SIZE);
+    if (!(ret == CIRC_BUFF_OK && test_circ_buff.data == test_circ_buff_data
+          && test_circ_buff.mask == UNIT_TEST_CIRC_BUFF_SIZE - 1
+          && test_circ_buff.head == 0 && test_circ_buff.tail == 0)) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Buffer initialization failed, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestInitialize(void) {
+    struct circular_buffer_pow2 circ_buff;
+    char buffer[UNIT_TEST_CIRC_BUFF_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_initialize(NULL, buffer, 16));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_initialize(&circ_buff, NULL, 16));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_initialize(&circ_buff, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_initialize(&circ_buff, buffer, 12));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_initialize(
+                                  &circ_buff, buffer,
+                                  2 * CIRC_BUFF_POW2_MAX_SIZE));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_initialize(&circ_buff, buffer, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_initialize(&circ_buff, buffer, 8));
+}
+
+void TestInsertAndGetElements(void) {
+    char few_to_insert[UNIT_TEST_CIRC_BUFF_SIZE - 2];
+    for (size_t i = 0; i < sizeof(few_to_insert); i++) {
+        few_to_insert[i] = (char) (i * 3);
+    }
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_insert_one(NULL, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_insert_few(&test_circ_buff, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_insert_few(&test_circ_buff,
+                                                    few_to_insert,
+                                                    sizeof(few_to_insert)));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_insert_one(&test_circ_buff, 100));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          circ_buff_pow2_insert_few(&test_circ_buff,
+                                                    few_to_insert, 2));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_insert_one(&test_circ_buff, 101));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          circ_buff_pow2_insert_one(&test_circ_buff, 102));
+    TEST_ASSERT_TRUE(circ_buff_pow2_is_full(&test_circ_buff));
+
+    char out_few[UNIT_TEST_CIRC_BUFF_SIZE - 2];
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_few(&test_circ_buff, out_few,
+                                                 sizeof(out_few)));
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(few_to_insert, out_few, sizeof(out_few));
+
+    char out_one;
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_one(&test_circ_buff, &out_one));
+    TEST_ASSERT_EQUAL_CHAR(100, out_one);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          circ_buff_pow2_get_few(&test_circ_buff, out_few, 2));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_one(&test_circ_buff, &out_one));
+    TEST_ASSERT_EQUAL_CHAR(101, out_one);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          circ_buff_pow2_get_one(&test_circ_buff, &out_one));
+    TEST_ASSERT_TRUE(circ_buff_pow2_is_empty(&test_circ_buff));
+}
+
+void TestIndicesWrapAround(void) {
+    /* 8-bit indices overflow many times during this test */
+    char out_one;
+    for (size_t round = 0; round < 1000; round++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_pow2_insert_one(&test_circ_buff,
+                                                        (char) round));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_pow2_get_one(&test_circ_buff,
+                                                     &out_one));
+        TEST_ASSERT_EQUAL_CHAR((char) round, out_one);
+    }
+
+    char few_to_insert[UNIT_TEST_CIRC_BUFF_SIZE];
+    for (size_t i = 0; i < sizeof(few_to_insert); i++) {
+        few_to_insert[i] = (char) (i + 1);
+    }
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_insert_few(&test_circ_buff,
+                                                    few_to_insert,
+                                                    sizeof(few_to_insert)));
+    TEST_ASSERT_TRUE(circ_buff_pow2_is_full(&test_circ_buff));
+
+    char out_few[UNIT_TEST_CIRC_BUFF_SIZE];
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_few(&test_circ_buff, out_few,
+                                                 sizeof(out_few)));
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(few_to_insert, out_few, sizeof(out_few));
+}
+
+void TestGetCapacityOccupancyAndSpaceLeft(void) {
+    size_t value;
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_get_capacity(&test_circ_buff, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_get_occupancy(&test_circ_buff, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_pow2_get_space_left(&test_circ_buff,
+                                                        NULL));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_capacity(&test_circ_buff, &value));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_CIRC_BUFF_SIZE, value);
+
+    char few_to_insert[5] = {1, 2, 3, 4, 5};
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_insert_few(&test_circ_buff,
+                                                    few_to_insert,
+                                                    sizeof(few_to_insert)));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_occupancy(&test_circ_buff,
+                                                       &value));
+    TEST_ASSERT_EQUAL_size_t(sizeof(few_to_insert), value);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_pow2_get_space_left(&test_circ_buff,
+                                                        &value));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_CIRC_BUFF_SIZE - sizeof(few_to_insert),
+                             value);
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_pow2_reset(&test_circ_buff));
+    TEST_ASSERT_TRUE(circ_buff_pow2_is_empty(&test_circ_buff));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, circ_buff_pow2_reset(NULL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestInitialize);
+    RUN_TEST(TestInsertAndGetElements);
+    RUN_TEST(TestIndicesWrapAround);
+    RUN_TEST(TestGetCapacityOccupancyAndSpaceLeft);
+
+    return UNITY_END();
+}
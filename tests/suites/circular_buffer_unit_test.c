@@ -1,4 +1,5 @@
 #include "test_utils.h"
+#include <string.h>
 #include <unity.h>
 
 #include <circular_buffer_arch_ind.h>
@@ -223,6 +224,247 @@ void TestReset(void) {
     TEST_ASSERT_TRUE(circ_buff_is_empty(&test_circ_buff));
 }
 
+void TestWrapAround(void) {
+    char out_one;
+    for (size_t round = 0; round < 3 * UNIT_TEST_CIRC_BUFF_SIZE; round++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_insert_one(&test_circ_buff,
+                                                   (char) round));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_insert_one(&test_circ_buff,
+                                                   (char) (round + 1)));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_get_one(&test_circ_buff, &out_one));
+        TEST_ASSERT_EQUAL_CHAR((char) round, out_one);
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              circ_buff_get_one(&test_circ_buff, &out_one));
+        TEST_ASSERT_EQUAL_CHAR((char) (round + 1), out_one);
+        TEST_ASSERT_TRUE(test_circ_buff.head < UNIT_TEST_CIRC_BUFF_SIZE);
+    }
+    TEST_ASSERT_TRUE(circ_buff_is_empty(&test_circ_buff));
+}
+
+void TestFewElementsAcrossBufferEnd(void) {
+    char in_values[UNIT_TEST_CIRC_BUFF_SIZE];
+    char out_values[UNIT_TEST_CIRC_BUFF_SIZE];
+    for (size_t i = 0; i < UNIT_TEST_CIRC_BUFF_SIZE; i++) {
+        in_values[i] = (char) (i + 1);
+    }
+
+    /* move head close to the end so both copies are split in two */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_few(&test_circ_buff, in_values,
+                                               UNIT_TEST_CIRC_BUFF_SIZE - 3));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_few(&test_circ_buff, out_values,
+                                            UNIT_TEST_CIRC_BUFF_SIZE - 3));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_few(&test_circ_buff, in_values,
+                                               UNIT_TEST_CIRC_BUFF_SIZE));
+    TEST_ASSERT_TRUE(circ_buff_is_full(&test_circ_buff));
+    TEST_ASSERT_EQUAL_CHAR(in_values[0], test_data_buffer[7]);
+    TEST_ASSERT_EQUAL_CHAR(in_values[3], test_data_buffer[0]);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_few(&test_circ_buff, out_values,
+                                            UNIT_TEST_CIRC_BUFF_SIZE));
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(in_values, out_values,
+                                 UNIT_TEST_CIRC_BUFF_SIZE);
+    TEST_ASSERT_TRUE(circ_buff_is_empty(&test_circ_buff));
+    TEST_ASSERT_EQUAL_size_t(7, test_circ_buff.head);
+}
+
+void TestPartialInsertAndGet(void) {
+    char in_values[UNIT_TEST_CIRC_BUFF_SIZE + 5];
+    char out_values[UNIT_TEST_CIRC_BUFF_SIZE + 5];
+    size_t moved;
+    for (size_t i = 0; i < sizeof(in_values); i++) {
+        in_values[i] = (char) (i + 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_insert_partial(NULL, in_values, 1,
+                                                   &moved));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_insert_partial(&test_circ_buff, NULL, 1,
+                                                   &moved));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_insert_partial(&test_circ_buff, in_values,
+                                                   1, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_get_partial(NULL, out_values, 1, &moved));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_get_partial(&test_circ_buff, NULL, 1,
+                                                &moved));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_get_partial(&test_circ_buff, out_values, 1,
+                                                NULL));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          circ_buff_get_partial(&test_circ_buff, out_values, 3,
+                                                &moved));
+    TEST_ASSERT_EQUAL_size_t(0, moved);
+
+    /* more than capacity, only a part fits */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_partial(&test_circ_buff, in_values,
+                                                   sizeof(in_values), &moved));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_CIRC_BUFF_SIZE, moved);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          circ_buff_insert_partial(&test_circ_buff, in_values,
+                                                   1, &moved));
+    TEST_ASSERT_EQUAL_size_t(0, moved);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_partial(&test_circ_buff, in_values,
+                                                   0, &moved));
+    TEST_ASSERT_EQUAL_size_t(0, moved);
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_partial(&test_circ_buff, out_values, 4,
+                                                &moved));
+    TEST_ASSERT_EQUAL_size_t(4, moved);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(in_values, out_values, 4);
+
+    /* wraps around the end of the data buffer */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_partial(&test_circ_buff,
+                                                   &in_values[10], 5, &moved));
+    TEST_ASSERT_EQUAL_size_t(4, moved);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_partial(&test_circ_buff, out_values,
+                                                sizeof(out_values), &moved));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_CIRC_BUFF_SIZE, moved);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(&in_values[4], out_values, 6);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(&in_values[10], &out_values[6], 4);
+    TEST_ASSERT_TRUE(circ_buff_is_empty(&test_circ_buff));
+}
+
+void TestReserveCommitPeekConsume(void) {
+    char *ptr;
+    size_t len;
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_reserve(NULL, &ptr, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_reserve(&test_circ_buff, NULL, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_reserve(&test_circ_buff, &ptr, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, circ_buff_commit(NULL, 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_peek_contiguous(NULL, &ptr, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, circ_buff_consume(NULL, 0));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          circ_buff_peek_contiguous(&test_circ_buff, &ptr,
+                                                    &len));
+    TEST_ASSERT_EQUAL_size_t(0, len);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_consume(&test_circ_buff, 1));
+
+    /* empty buffer, whole data buffer is contiguous */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_reserve(&test_circ_buff, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(test_data_buffer, ptr);
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_CIRC_BUFF_SIZE, len);
+    memcpy(ptr, "abcdefgh", 8);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_commit(&test_circ_buff,
+                                           UNIT_TEST_CIRC_BUFF_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_commit(&test_circ_buff, 8));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_peek_contiguous(&test_circ_buff, &ptr,
+                                                    &len));
+    TEST_ASSERT_EQUAL_PTR(test_data_buffer, ptr);
+    TEST_ASSERT_EQUAL_size_t(8, len);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_consume(&test_circ_buff, 6));
+
+    /* free region ends at the end of the data buffer */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_reserve(&test_circ_buff, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(&test_data_buffer[8], ptr);
+    TEST_ASSERT_EQUAL_size_t(2, len);
+    memcpy(ptr, "ij", 2);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_commit(&test_circ_buff, 2));
+
+    /* and continues from its start */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_reserve(&test_circ_buff, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(test_data_buffer, ptr);
+    TEST_ASSERT_EQUAL_size_t(6, len);
+    memcpy(ptr, "klmnop", 6);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_commit(&test_circ_buff, 6));
+    TEST_ASSERT_TRUE(circ_buff_is_full(&test_circ_buff));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          circ_buff_reserve(&test_circ_buff, &ptr, &len));
+    TEST_ASSERT_EQUAL_size_t(0, len);
+
+    /* filled part also ends at the end of the data buffer */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_peek_contiguous(&test_circ_buff, &ptr,
+                                                    &len));
+    TEST_ASSERT_EQUAL_size_t(4, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("ghij", ptr, 4);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_consume(&test_circ_buff, 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_peek_contiguous(&test_circ_buff, &ptr,
+                                                    &len));
+    TEST_ASSERT_EQUAL_size_t(6, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("klmnop", ptr, 6);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, circ_buff_consume(&test_circ_buff, 6));
+    TEST_ASSERT_TRUE(circ_buff_is_empty(&test_circ_buff));
+}
+
+void TestInsertOverwrite(void) {
+    char in_values[2 * UNIT_TEST_CIRC_BUFF_SIZE];
+    char out_values[UNIT_TEST_CIRC_BUFF_SIZE];
+    size_t overwritten;
+    for (size_t i = 0; i < sizeof(in_values); i++) {
+        in_values[i] = (char) (i + 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_insert_overwrite(NULL, in_values, 1,
+                                                     &overwritten));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          circ_buff_insert_overwrite(&test_circ_buff, NULL, 1,
+                                                     &overwritten));
+
+    /* enough space, nothing dropped */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_overwrite(&test_circ_buff, in_values,
+                                                     6, &overwritten));
+    TEST_ASSERT_EQUAL_size_t(0, overwritten);
+
+    /* 4 bytes of space left, the 3 oldest are dropped */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_overwrite(&test_circ_buff,
+                                                     &in_values[6], 7,
+                                                     &overwritten));
+    TEST_ASSERT_EQUAL_size_t(3, overwritten);
+    TEST_ASSERT_TRUE(circ_buff_is_full(&test_circ_buff));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_few(&test_circ_buff, out_values,
+                                            UNIT_TEST_CIRC_BUFF_SIZE));
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(&in_values[3], out_values,
+                                 UNIT_TEST_CIRC_BUFF_SIZE);
+
+    /* more than capacity, only the newest elements are kept */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_overwrite(&test_circ_buff, in_values,
+                                                     3, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_insert_overwrite(&test_circ_buff, in_values,
+                                                     sizeof(in_values),
+                                                     &overwritten));
+    TEST_ASSERT_EQUAL_size_t(3 + UNIT_TEST_CIRC_BUFF_SIZE, overwritten);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_get_few(&test_circ_buff, out_values,
+                                            UNIT_TEST_CIRC_BUFF_SIZE));
+    TEST_ASSERT_EQUAL_CHAR_ARRAY(&in_values[UNIT_TEST_CIRC_BUFF_SIZE],
+                                 out_values, UNIT_TEST_CIRC_BUFF_SIZE);
+}
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -232,6 +474,11 @@ int main(void) {
     RUN_TEST(TestGetOccupancy);
     RUN_TEST(TestHasSpaceIsFullOrEmpty);
     RUN_TEST(TestReset);
+    RUN_TEST(TestWrapAround);
+    RUN_TEST(TestFewElementsAcrossBufferEnd);
+    RUN_TEST(TestPartialInsertAndGet);
+    RUN_TEST(TestReserveCommitPeekConsume);
+    RUN_TEST(TestInsertOverwrite);
 
     return UNITY_END();
 }
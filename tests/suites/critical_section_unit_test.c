@@ -0,0 +1,149 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <critical_section_arch_ind.h>
+
+uint16_t unit_test_now;
+uint8_t unit_test_lock_depth;
+uint8_t unit_test_sched_timer_stops;
+uint8_t unit_test_sched_timer_resumes;
+
+uint8_t avrtos_irq_lock_impl(void) {
+    return unit_test_lock_depth++;
+}
+
+void avrtos_irq_unlock_impl(uint8_t key) {
+    unit_test_lock_depth = key;
+}
+
+uint16_t avrtos_cs_timer_count_impl(void) {
+    return unit_test_now;
+}
+
+void avrtos_sched_timer_stop_impl(void) {
+    unit_test_sched_timer_stops++;
+}
+
+void avrtos_sched_timer_resume_impl(void) {
+    unit_test_sched_timer_resumes++;
+}
+
+static struct avrtos_cs_stats unit_test_get(uint8_t site) {
+    struct avrtos_cs_stats stats;
+    TEST_ASSERT_TRUE(avrtos_cs_stats_get(site, &stats));
+    return stats;
+}
+
+static bool unit_test_section_with_return(uint16_t duration) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USER(1)) {
+        unit_test_now += duration;
+        return true;
+    }
+    return false;
+}
+
+void setUp(void) {
+    avrtos_cs_stats_reset();
+    if (avrtos_cs_stats_get_worst(NULL) != 0) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Statistics are not empty, abort all test cases");
+    }
+    unit_test_now = 0x1234;
+    unit_test_sched_timer_stops = 0;
+    unit_test_sched_timer_resumes = 0;
+}
+
+void tearDown(void) {}
+
+void TestCriticalSection(void) {
+    AVRTOS_CRITICAL_SECTION(AVRTOS_CS_SITE_USER(0)) {
+        TEST_ASSERT_EQUAL_UINT8(1, unit_test_lock_depth);
+        unit_test_now += 40;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, unit_test_lock_depth);
+
+    struct avrtos_cs_stats stats = unit_test_get(AVRTOS_CS_SITE_USER(0));
+    TEST_ASSERT_EQUAL_UINT16(40, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[2]);
+
+    /* leaving the section early still records it and restores the state */
+    TEST_ASSERT_TRUE(unit_test_section_with_return(3));
+    TEST_ASSERT_EQUAL_UINT8(0, unit_test_lock_depth);
+    stats = unit_test_get(AVRTOS_CS_SITE_USER(1));
+    TEST_ASSERT_EQUAL_UINT16(3, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[0]);
+
+    TEST_ASSERT_FALSE(avrtos_cs_stats_get(AVRTOS_CS_SITE_COUNT, &stats));
+}
+
+void TestHistogramAndWorst(void) {
+    _avrtos_cs_record(AVRTOS_CS_SITE_DELAY, 0);
+    _avrtos_cs_record(AVRTOS_CS_SITE_DELAY, 15);
+    _avrtos_cs_record(AVRTOS_CS_SITE_DELAY, 16);
+    _avrtos_cs_record(AVRTOS_CS_SITE_DELAY, 1000);
+    _avrtos_cs_record(AVRTOS_CS_SITE_YIELD, UINT16_MAX);
+
+    struct avrtos_cs_stats stats = unit_test_get(AVRTOS_CS_SITE_DELAY);
+    TEST_ASSERT_EQUAL_UINT16(1000, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(2, stats.histogram[0]);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[6]);
+
+    stats = unit_test_get(AVRTOS_CS_SITE_YIELD);
+    TEST_ASSERT_EQUAL_UINT16(1,
+                             stats.histogram[AVRTOS_CS_HISTOGRAM_BUCKETS - 1]);
+
+    uint8_t site;
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, avrtos_cs_stats_get_worst(&site));
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_CS_SITE_YIELD, site);
+    TEST_ASSERT_EQUAL_UINT32(8 * (uint32_t) UINT16_MAX,
+                             AVRTOS_CS_COUNTS_TO_CYCLES(UINT16_MAX));
+}
+
+void TestNonPreemptiveSection(void) {
+    /* durations are measured across the timer wrap-around */
+    unit_test_now = 0xFFF0;
+    AVRTOS_NON_PREEMPTIVE_SECTION() {
+        TEST_ASSERT_EQUAL_UINT8(1, unit_test_sched_timer_stops);
+        TEST_ASSERT_EQUAL_UINT8(0, unit_test_sched_timer_resumes);
+        unit_test_now += 0x20;
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, unit_test_sched_timer_resumes);
+
+    struct avrtos_cs_stats stats =
+            unit_test_get(AVRTOS_CS_SITE_NON_PREEMPTIVE);
+    TEST_ASSERT_EQUAL_UINT16(0x20, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[2]);
+}
+
+void TestSchedulerWindowsAreSummed(void) {
+    _avrtos_cs_scheduler_begin();
+    unit_test_now += 10;
+    _avrtos_cs_scheduler_end(false);
+    unit_test_now += 500;
+    _avrtos_cs_scheduler_begin();
+    unit_test_now += 12;
+    _avrtos_cs_scheduler_end(true);
+
+    struct avrtos_cs_stats stats = unit_test_get(AVRTOS_CS_SITE_SCHEDULER);
+    TEST_ASSERT_EQUAL_UINT16(22, stats.max);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[1]);
+
+    /* the next interrupt starts from zero */
+    _avrtos_cs_scheduler_begin();
+    unit_test_now += 5;
+    _avrtos_cs_scheduler_end(true);
+    stats = unit_test_get(AVRTOS_CS_SITE_SCHEDULER);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.histogram[0]);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestCriticalSection);
+    RUN_TEST(TestHistogramAndWorst);
+    RUN_TEST(TestNonPreemptiveSection);
+    RUN_TEST(TestSchedulerWindowsAreSummed);
+
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <string.h>
+
+#include <eeprom_kv_arch_ind.h>
+
+#define UNIT_TEST_EEPROM_KV_START 8
+#define UNIT_TEST_EEPROM_KV_SLOTS 4
+#define UNIT_TEST_EEPROM_SIZE \
+    (UNIT_TEST_EEPROM_KV_START \
+     + UNIT_TEST_EEPROM_KV_SLOTS * EEPROM_KV_RECORD_SIZE)
+
+static uint8_t test_eeprom[UNIT_TEST_EEPROM_SIZE];
+static uint8_t test_slot_keys[UNIT_TEST_EEPROM_KV_SLOTS];
+static struct eeprom_kv test_kv;
+
+static uint8_t test_eeprom_read(uint16_t address) {
+    TEST_ASSERT_TRUE(address < UNIT_TEST_EEPROM_SIZE);
+    return test_eeprom[address];
+}
+
+static enum eeprom_kv_status test_mount(void) {
+    return eeprom_kv_mount(&test_kv, UNIT_TEST_EEPROM_KV_START, test_slot_keys,
+                           UNIT_TEST_EEPROM_KV_SLOTS, test_eeprom_read);
+}
+
+/* writes only the first "written" bytes of the record, like a reset would */
+static enum eeprom_kv_status test_put(uint8_t key, uint32_t value,
+                                      uint8_t written) {
+    uint8_t bytes[EEPROM_KV_VALUE_SIZE];
+    uint8_t record[EEPROM_KV_RECORD_SIZE];
+    uint16_t address;
+
+    memcpy(bytes, &value, sizeof(bytes));
+    enum eeprom_kv_status status =
+            eeprom_kv_prepare(&test_kv, key, bytes, &address, record);
+    if (status == EEPROM_KV_OK) {
+        TEST_ASSERT_TRUE(address + EEPROM_KV_RECORD_SIZE
+                         <= UNIT_TEST_EEPROM_SIZE);
+        memcpy(&test_eeprom[address], record, written);
+    }
+    return status;
+}
+
+static uint32_t test_get(uint8_t key) {
+    uint8_t bytes[EEPROM_KV_VALUE_SIZE];
+    uint32_t value;
+
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, eeprom_kv_get(&test_kv, key, bytes));
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void setUp(void) {
+    /* erased EEPROM before each test, critical part */
+    memset(test_eeprom, 0xFF, sizeof(test_eeprom));
+    if (test_mount() != EEPROM_KV_OK || test_kv.keys_count != 0) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Store initialization failed, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestMount(void) {
+    uint8_t bytes[EEPROM_KV_VALUE_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_INVALID,
+                          eeprom_kv_mount(NULL, 0, test_slot_keys, 2,
+                                          test_eeprom_read));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_INVALID,
+                          eeprom_kv_mount(&test_kv, 0, NULL, 2,
+                                          test_eeprom_read));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_INVALID,
+                          eeprom_kv_mount(&test_kv, 0, test_slot_keys, 1,
+                                          test_eeprom_read));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_INVALID,
+                          eeprom_kv_mount(&test_kv, 0, test_slot_keys, 2,
+                                          NULL));
+
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_NOT_FOUND,
+                          eeprom_kv_get(&test_kv, 0, bytes));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_NOT_FOUND,
+                          eeprom_kv_get(&test_kv, EEPROM_KV_NO_KEY, bytes));
+}
+
+void TestPutAndGet(void) {
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_INVALID,
+                          test_put(EEPROM_KV_NO_KEY, 1,
+                                   EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(1, 100, EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(2, 200, EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(1, 101, EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(101, test_get(1));
+    TEST_ASSERT_EQUAL_UINT32(200, test_get(2));
+
+    /* the values survive a reset */
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+    TEST_ASSERT_EQUAL_UINT8(2, test_kv.keys_count);
+    TEST_ASSERT_EQUAL_UINT32(101, test_get(1));
+    TEST_ASSERT_EQUAL_UINT32(200, test_get(2));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(2, 201, EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(201, test_get(2));
+}
+
+void TestFullAndWearLeveling(void) {
+    uint8_t writes[UNIT_TEST_EEPROM_KV_SLOTS] = {0};
+
+    /* one slot always stays free */
+    for (uint8_t key = 0; key < UNIT_TEST_EEPROM_KV_SLOTS - 1; key++) {
+        TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                              test_put(key, key, EEPROM_KV_RECORD_SIZE));
+    }
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_FULL,
+                          test_put(UNIT_TEST_EEPROM_KV_SLOTS, 0,
+                                   EEPROM_KV_RECORD_SIZE));
+
+    /* updates of the other keys rotate through the slots that are not
+       holding the cold key 0 */
+    for (uint32_t i = 0; i < 30; i++) {
+        uint8_t key = 1 + i % 2;
+        uint8_t bytes[EEPROM_KV_VALUE_SIZE] = {0};
+        uint8_t record[EEPROM_KV_RECORD_SIZE];
+        uint16_t address;
+
+        TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                              eeprom_kv_prepare(&test_kv, key, bytes,
+                                                &address, record));
+        memcpy(&test_eeprom[address], record, sizeof(record));
+        writes[(address - UNIT_TEST_EEPROM_KV_START)
+               / EEPROM_KV_RECORD_SIZE]++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, writes[0]);
+    TEST_ASSERT_EQUAL_UINT8(10, writes[1]);
+    TEST_ASSERT_EQUAL_UINT8(10, writes[2]);
+    TEST_ASSERT_EQUAL_UINT8(10, writes[3]);
+
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+    TEST_ASSERT_EQUAL_UINT32(0, test_get(0));
+    TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_EEPROM_KV_SLOTS - 1, test_kv.keys_count);
+}
+
+void TestTornRecords(void) {
+    uint8_t saved[UNIT_TEST_EEPROM_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(1, 100, EEPROM_KV_RECORD_SIZE));
+    TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                          test_put(1, 101, EEPROM_KV_RECORD_SIZE));
+    memcpy(saved, test_eeprom, sizeof(saved));
+
+    /* a reset after any byte of an update keeps the previous value, also in
+       slots holding stale records of the same key */
+    for (uint8_t update = 0; update < 2 * UNIT_TEST_EEPROM_KV_SLOTS;
+         update++) {
+        for (uint8_t written = 0; written < EEPROM_KV_RECORD_SIZE;
+             written++) {
+            memcpy(test_eeprom, saved, sizeof(saved));
+            TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+            TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_put(1, 200, written));
+            TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_put(2, 300, written));
+
+            TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+            TEST_ASSERT_EQUAL_UINT32(101 + update, test_get(1));
+            TEST_ASSERT_EQUAL_UINT8(1, test_kv.keys_count);
+        }
+
+        memcpy(test_eeprom, saved, sizeof(saved));
+        TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK, test_mount());
+        TEST_ASSERT_EQUAL_INT(EEPROM_KV_OK,
+                              test_put(1, 102 + update,
+                                       EEPROM_KV_RECORD_SIZE));
+        memcpy(saved, test_eeprom, sizeof(saved));
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestMount);
+    RUN_TEST(TestPutAndGet);
+    RUN_TEST(TestFullAndWearLeveling);
+    RUN_TEST(TestTornRecords);
+
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+#include "test_utils.h"
+#include <string.h>
+#include <unity.h>
+
+#define AVRTOS_WITH_BINARY_LOGGER
+#include <logger_arch_ind.h>
+
+#define UNIT_TEST_TIMESTAMP 0x12345678UL
+
+char unit_test_record[AVRTOS_BINARY_LOG_MAX_SIZE];
+size_t unit_test_record_len;
+size_t unit_test_records_written;
+size_t unit_test_free_space;
+
+avrtos_tick_t avrtos_delay_get_ticks_impl(void) {
+    return UNIT_TEST_TIMESTAMP;
+}
+
+void avrtos_log_lock_impl(void) {}
+
+void avrtos_log_unlock_impl(void) {}
+
+bool avrtos_log_put_impl(char c, bool wait) {
+    (void) c;
+    (void) wait;
+    TEST_FAIL_MESSAGE("text log buffer used by the binary logger");
+    return false;
+}
+
+bool avrtos_log_finish_impl(char c, bool wait) {
+    (void) c;
+    (void) wait;
+    TEST_FAIL_MESSAGE("text log buffer used by the binary logger");
+    return false;
+}
+
+void avrtos_log_discard_impl(void) {
+    TEST_FAIL_MESSAGE("text log buffer used by the binary logger");
+}
+
+bool avrtos_log_write_impl(const char *data, size_t len, bool wait) {
+    TEST_ASSERT_LESS_OR_EQUAL_UINT(AVRTOS_BINARY_LOG_MAX_SIZE, len);
+    if (!wait && len > unit_test_free_space) {
+        return false;
+    }
+    memcpy(unit_test_record, data, len);
+    unit_test_record_len = len;
+    unit_test_records_written++;
+    return true;
+}
+
+void setUp(void) {
+    memset(unit_test_record, 0, sizeof(unit_test_record));
+    unit_test_record_len = 0;
+    unit_test_records_written = 0;
+    unit_test_free_space = AVRTOS_BINARY_LOG_MAX_SIZE;
+    avrtos_log_set_policy(AVRTOS_LOG_POLICY_BLOCK);
+}
+
+void tearDown(void) {}
+
+static void assert_record_header(size_t expected_len) {
+    TEST_ASSERT_EQUAL_size_t(expected_len, unit_test_record_len);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_BINARY_LOG_SYNC,
+                            (uint8_t) unit_test_record[0]);
+    TEST_ASSERT_EQUAL_UINT8(expected_len, (uint8_t) unit_test_record[1]);
+    TEST_ASSERT_EQUAL_UINT8(0x78, (uint8_t) unit_test_record[4]);
+    TEST_ASSERT_EQUAL_UINT8(0x56, (uint8_t) unit_test_record[5]);
+    TEST_ASSERT_EQUAL_UINT8(0x34, (uint8_t) unit_test_record[6]);
+    TEST_ASSERT_EQUAL_UINT8(0x12, (uint8_t) unit_test_record[7]);
+}
+
+void TestRecordWithoutArguments(void) {
+    avrtos_log(test, INFO, "no arguments");
+    assert_record_header(AVRTOS_BINARY_LOG_HEADER_SIZE);
+}
+
+void TestRecordLevelFiltering(void) {
+    avrtos_log(test, DEBUG, "filtered out %d", 1);
+    TEST_ASSERT_EQUAL_size_t(0, unit_test_record_len);
+}
+
+void TestRecordArgumentsArePromoted(void) {
+    uint8_t small = 0xAB;
+    long big = 0x01020304L;
+    char name[] = "x";
+
+    /* uint8_t is sent as int, the array as a pointer */
+    avrtos_log(test, ERROR, "%d %s", small, name);
+    assert_record_header(AVRTOS_BINARY_LOG_HEADER_SIZE + sizeof(int)
+                         + sizeof(char *));
+    int small_sent;
+    char *name_sent;
+    memcpy(&small_sent, &unit_test_record[AVRTOS_BINARY_LOG_HEADER_SIZE],
+           sizeof(int));
+    memcpy(&name_sent,
+           &unit_test_record[AVRTOS_BINARY_LOG_HEADER_SIZE + sizeof(int)],
+           sizeof(char *));
+    TEST_ASSERT_EQUAL_INT(0xAB, small_sent);
+    TEST_ASSERT_EQUAL_PTR(name, name_sent);
+
+    avrtos_log(test, ERROR, "%ld", big);
+    assert_record_header(AVRTOS_BINARY_LOG_HEADER_SIZE + sizeof(long));
+    long big_sent;
+    memcpy(&big_sent, &unit_test_record[AVRTOS_BINARY_LOG_HEADER_SIZE],
+           sizeof(long));
+    TEST_ASSERT_EQUAL_INT(0x01020304L, big_sent);
+}
+
+void TestRecordFormatIdsDiffer(void) {
+    avrtos_log(test, INFO, "first");
+    uint16_t first_id = (uint16_t) ((uint8_t) unit_test_record[2]
+                                    | ((uint8_t) unit_test_record[3] << 8));
+    avrtos_log(test, INFO, "second");
+    uint16_t second_id = (uint16_t) ((uint8_t) unit_test_record[2]
+                                     | ((uint8_t) unit_test_record[3] << 8));
+    TEST_ASSERT_TRUE(first_id != second_id);
+}
+
+void TestRecordTruncation(void) {
+    long args[AVRTOS_BINARY_LOG_MAX_SIZE / sizeof(long) + 1];
+    for (size_t i = 0; i < sizeof(args) / sizeof(args[0]); i++) {
+        args[i] = (long) i;
+    }
+
+    /* arguments that do not fit are dropped, and so are the following ones
+       even if they would fit */
+    avrtos_log(test, INFO, "%ld %ld %ld %d", args[0], args[1], args[2], 1);
+    size_t fitting = (AVRTOS_BINARY_LOG_MAX_SIZE - AVRTOS_BINARY_LOG_HEADER_SIZE)
+                     / sizeof(long);
+    if (fitting > 3) {
+        fitting = 3;
+    }
+    assert_record_header(AVRTOS_BINARY_LOG_HEADER_SIZE
+                         + fitting * sizeof(long));
+}
+
+void TestRecordDroppedWhenBufferIsFull(void) {
+    uint16_t dropped_info = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO);
+    uint16_t dropped_error = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_ERROR);
+
+    /* records are not truncated, even with TRUNCATE policy */
+    avrtos_log_set_policy(AVRTOS_LOG_POLICY_TRUNCATE);
+    unit_test_free_space = AVRTOS_BINARY_LOG_HEADER_SIZE;
+    avrtos_log(test, INFO, "%d", 1);
+    TEST_ASSERT_EQUAL_size_t(0, unit_test_records_written);
+    TEST_ASSERT_EQUAL_UINT16(dropped_info + 1,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO));
+    TEST_ASSERT_EQUAL_UINT16(dropped_error,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_ERROR));
+
+    /* the report follows the next record that fits */
+    unit_test_free_space = AVRTOS_BINARY_LOG_MAX_SIZE;
+    avrtos_log(test, INFO, "fits");
+    TEST_ASSERT_EQUAL_size_t(2, unit_test_records_written);
+    assert_record_header(AVRTOS_BINARY_LOG_HEADER_SIZE + sizeof(unsigned int));
+    unsigned int reported;
+    memcpy(&reported, &unit_test_record[AVRTOS_BINARY_LOG_HEADER_SIZE],
+           sizeof(reported));
+    TEST_ASSERT_EQUAL_UINT(1, reported);
+
+    avrtos_log(test, INFO, "fits");
+    TEST_ASSERT_EQUAL_size_t(3, unit_test_records_written);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestRecordWithoutArguments);
+    RUN_TEST(TestRecordLevelFiltering);
+    RUN_TEST(TestRecordArgumentsArePromoted);
+    RUN_TEST(TestRecordFormatIdsDiffer);
+    RUN_TEST(TestRecordTruncation);
+    RUN_TEST(TestRecordDroppedWhenBufferIsFull);
+
+    return UNITY_END();
+}
@@ -4,22 +4,66 @@
 
 #include <logger_arch_ind.h>
 
-char unit_test_global_buffer[AVRTOS_UNIT_TEST_SINGLE_LOG_MAX_SIZE];
+/* finished messages are appended, "dropped" reports may follow them */
+char unit_test_global_buffer[4 * AVRTOS_UNIT_TEST_SINGLE_LOG_MAX_SIZE];
+size_t unit_test_global_buffer_used;
+size_t unit_test_staged;
+size_t unit_test_free_space;
 
-#define GLOBAL_BUFFER_RESET() unit_test_global_buffer[0] = '\0'
+#define GLOBAL_BUFFER_RESET()              \
+    do {                                   \
+        unit_test_global_buffer[0] = '\0'; \
+        unit_test_global_buffer_used = 0;  \
+    } while (0)
 #define UNIT_TEST_LOG(...) \
     GLOBAL_BUFFER_RESET(); \
     avrtos_log(__VA_ARGS__)
-#define TEST_ASSERT_LOG_EQUAL_TO(...) \
+#define TEST_ASSERT_LOG_EQUAL_TO(...)                             \
+    /* only the finished part of the messages is visible */       \
+    unit_test_global_buffer[unit_test_global_buffer_used] = '\0'; \
     TEST_ASSERT_EQUAL_STRING(__VA_ARGS__, unit_test_global_buffer);
 
-void avrtos_handle_log_buffer_impl(char *buffer, size_t buf_len) {
-    (void) buf_len;
-    strcpy(unit_test_global_buffer, buffer);
+void avrtos_log_lock_impl(void) {}
+
+void avrtos_log_unlock_impl(void) {}
+
+static void unit_test_stage(char c) {
+    TEST_ASSERT_TRUE(unit_test_global_buffer_used + unit_test_staged + 1
+                     < sizeof(unit_test_global_buffer));
+    unit_test_global_buffer[unit_test_global_buffer_used + unit_test_staged++] =
+            c;
+}
+
+bool avrtos_log_put_impl(char c, bool wait) {
+    /* the last free byte is kept for the end of the message */
+    if (!wait && unit_test_staged + 2 > unit_test_free_space) {
+        return false;
+    }
+    unit_test_stage(c);
+    return true;
+}
+
+bool avrtos_log_finish_impl(char c, bool wait) {
+    if (!wait && unit_test_staged + 1 > unit_test_free_space) {
+        unit_test_staged = 0;
+        return false;
+    }
+    unit_test_stage(c);
+    unit_test_global_buffer_used += unit_test_staged;
+    unit_test_staged = 0;
+    return true;
+}
+
+void avrtos_log_discard_impl(void) {
+    unit_test_staged = 0;
 }
 
 void setUp(void) {
     GLOBAL_BUFFER_RESET();
+    unit_test_staged = 0;
+    unit_test_free_space = sizeof(unit_test_global_buffer);
+    avrtos_log_set_policy(AVRTOS_LOG_POLICY_BLOCK);
+    avrtos_log_set_level(AVRTOS_LOG_LEVEL_DEBUG);
 }
 
 void tearDown(void) {}
@@ -134,12 +178,94 @@ void TestBasicSnprintfFormatting(void) {
     TEST_ASSERT_LOG_EQUAL_TO("INFO [test] string is unit test\n");
 }
 
+void TestDropPolicy(void) {
+#undef AVRTOS_LOG_DEFAULT_LEVEL
+#define AVRTOS_LOG_DEFAULT_LEVEL INFO
+
+    uint16_t dropped_info = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO);
+    uint16_t dropped_warning = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_WARNING);
+
+    avrtos_log_set_policy(AVRTOS_LOG_POLICY_DROP);
+    /* one byte short */
+    unit_test_free_space = strlen("INFO [test] test message\n") - 1;
+    UNIT_TEST_LOG(test, INFO, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("");
+    UNIT_TEST_LOG(test, WARNING, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("");
+    TEST_ASSERT_EQUAL_UINT16(dropped_info + 1,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO));
+    TEST_ASSERT_EQUAL_UINT16(dropped_warning + 1,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_WARNING));
+
+    /* dropped messages are reported once there is room */
+    unit_test_free_space = sizeof(unit_test_global_buffer);
+    UNIT_TEST_LOG(test, INFO, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("INFO [test] test message\n"
+                             "WARNING [log] 2 messages dropped\n");
+    UNIT_TEST_LOG(test, INFO, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("INFO [test] test message\n");
+}
+
+void TestTruncatePolicy(void) {
+#undef AVRTOS_LOG_DEFAULT_LEVEL
+#define AVRTOS_LOG_DEFAULT_LEVEL INFO
+
+    uint16_t dropped_info = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO);
+
+    avrtos_log_set_policy(AVRTOS_LOG_POLICY_TRUNCATE);
+    unit_test_free_space = strlen("INFO [test]\n");
+    UNIT_TEST_LOG(test, INFO, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("INFO [test]\n");
+    TEST_ASSERT_EQUAL_UINT16(dropped_info,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO));
+
+    /* no room even for the new line */
+    unit_test_free_space = 1;
+    UNIT_TEST_LOG(test, INFO, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("");
+    TEST_ASSERT_EQUAL_UINT16(dropped_info + 1,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO));
+}
+
+void TestRuntimeLogLevel(void) {
+#undef AVRTOS_LOG_DEFAULT_LEVEL
+#define AVRTOS_LOG_DEFAULT_LEVEL DEBUG
+
+    /* report the messages dropped by the previous tests */
+    UNIT_TEST_LOG(test, INFO, "test message");
+
+    uint16_t dropped_info = avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO);
+    int evaluated = 0;
+
+    avrtos_log_set_level(AVRTOS_LOG_LEVEL_WARNING);
+    TEST_ASSERT_EQUAL_INT(AVRTOS_LOG_LEVEL_WARNING, avrtos_log_get_level());
+    UNIT_TEST_LOG(test, WARNING, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("WARNING [test] test message\n");
+    UNIT_TEST_LOG(test, INFO, "test message %d", ++evaluated);
+    TEST_ASSERT_LOG_EQUAL_TO("");
+    /* skipped messages are neither evaluated nor counted as dropped */
+    TEST_ASSERT_EQUAL_INT(0, evaluated);
+    TEST_ASSERT_EQUAL_UINT16(dropped_info,
+                             avrtos_log_get_dropped(AVRTOS_LOG_LEVEL_INFO));
+
+    /* invalid levels are ignored */
+    avrtos_log_set_level(AVRTOS_LOG_LEVELS_COUNT);
+    TEST_ASSERT_EQUAL_INT(AVRTOS_LOG_LEVEL_WARNING, avrtos_log_get_level());
+
+    avrtos_log_set_level(AVRTOS_LOG_LEVEL_DEBUG);
+    UNIT_TEST_LOG(test, DEBUG, "test message");
+    TEST_ASSERT_LOG_EQUAL_TO("DEBUG [test] test message\n");
+}
+
 int main(void) {
     UNITY_BEGIN();
 
     RUN_TEST(TestCheckLogLevels);
     RUN_TEST(TestCheckNullTermination);
     RUN_TEST(TestBasicSnprintfFormatting);
+    RUN_TEST(TestDropPolicy);
+    RUN_TEST(TestTruncatePolicy);
+    RUN_TEST(TestRuntimeLogLevel);
 
     return UNITY_END();
 }
@@ -0,0 +1,159 @@
+#include "test_utils.h"
+#include <string.h>
+#include <unity.h>
+
+#include <profiler_arch_ind.h>
+
+char unit_test_output[AVRTOS_PROFILER_HEADER_FRAME_SIZE
+                      + AVRTOS_PROFILER_TABLE_SIZE
+                                * AVRTOS_PROFILER_ENTRY_FRAME_SIZE];
+size_t unit_test_output_len;
+uint8_t unit_test_lock_depth;
+
+uint8_t avrtos_irq_lock_impl(void) {
+    return unit_test_lock_depth++;
+}
+
+void avrtos_irq_unlock_impl(uint8_t key) {
+    unit_test_lock_depth = key;
+}
+
+void avrtos_log_lock_impl(void) {}
+
+void avrtos_log_unlock_impl(void) {}
+
+bool avrtos_log_write_impl(const char *data, size_t len, bool wait) {
+    TEST_ASSERT_TRUE(wait);
+    TEST_ASSERT_TRUE(unit_test_output_len + len <= sizeof(unit_test_output));
+    memcpy(&unit_test_output[unit_test_output_len], data, len);
+    unit_test_output_len += len;
+    return true;
+}
+
+static void unit_test_dump(void) {
+    unit_test_output_len = 0;
+    avrtos_profiler_dump();
+}
+
+static uint8_t unit_test_checksum(const char *frame, size_t len) {
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < len - 1; i++) {
+        checksum += (uint8_t) frame[i];
+    }
+    return checksum;
+}
+
+static void unit_test_assert_header(uint32_t samples, uint16_t dropped) {
+    const char *frame = unit_test_output;
+    TEST_ASSERT_TRUE(unit_test_output_len
+                     >= AVRTOS_PROFILER_HEADER_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_PROFILER_SYNC, (uint8_t) frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_PROFILER_FRAME_HEADER, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_PROFILER_VERSION, frame[2]);
+    uint32_t frame_samples = 0;
+    for (uint8_t i = 0; i < sizeof(frame_samples); i++) {
+        frame_samples |= (uint32_t) (uint8_t) frame[3 + i] << (8 * i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(samples, frame_samples);
+    TEST_ASSERT_EQUAL_UINT16(dropped,
+                             (uint8_t) frame[7] | (uint8_t) frame[8] << 8);
+    TEST_ASSERT_EQUAL_UINT8(
+            unit_test_checksum(frame, AVRTOS_PROFILER_HEADER_FRAME_SIZE),
+            (uint8_t) frame[9]);
+}
+
+static size_t unit_test_entry_count(void) {
+    return (unit_test_output_len - AVRTOS_PROFILER_HEADER_FRAME_SIZE)
+           / AVRTOS_PROFILER_ENTRY_FRAME_SIZE;
+}
+
+/* entries are sent in table order, returns the count of the matching one */
+static uint16_t unit_test_find_entry(uint8_t task_id, uint16_t pc) {
+    for (size_t i = 0; i < unit_test_entry_count(); i++) {
+        size_t offset = AVRTOS_PROFILER_HEADER_FRAME_SIZE
+                        + i * AVRTOS_PROFILER_ENTRY_FRAME_SIZE;
+        const char *frame = &unit_test_output[offset];
+        TEST_ASSERT_EQUAL_UINT8(AVRTOS_PROFILER_SYNC, (uint8_t) frame[0]);
+        TEST_ASSERT_EQUAL_UINT8(AVRTOS_PROFILER_FRAME_ENTRY, frame[1]);
+        TEST_ASSERT_EQUAL_UINT8(
+                unit_test_checksum(frame, AVRTOS_PROFILER_ENTRY_FRAME_SIZE),
+                (uint8_t) frame[7]);
+        uint16_t frame_pc = (uint8_t) frame[3] | (uint8_t) frame[4] << 8;
+        if ((uint8_t) frame[2] == task_id && frame_pc == pc) {
+            return (uint8_t) frame[5] | (uint8_t) frame[6] << 8;
+        }
+    }
+    return 0;
+}
+
+void setUp(void) {
+    avrtos_profiler_set_enabled(true);
+    avrtos_profiler_reset();
+    if (avrtos_profiler_get_samples() != 0) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Profiler is not empty, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestRecordAndDump(void) {
+    for (uint8_t i = 0; i < 5; i++) {
+        _avrtos_profiler_record(1, 0x0123);
+    }
+    _avrtos_profiler_record(2, 0x0123);
+    _avrtos_profiler_record(1, 0x3456);
+    TEST_ASSERT_EQUAL_UINT32(7, avrtos_profiler_get_samples());
+    TEST_ASSERT_EQUAL_UINT8(0, unit_test_lock_depth);
+
+    unit_test_dump();
+    unit_test_assert_header(7, 0);
+    TEST_ASSERT_EQUAL_size_t(3, unit_test_entry_count());
+    TEST_ASSERT_EQUAL_UINT16(5, unit_test_find_entry(1, 0x0123));
+    TEST_ASSERT_EQUAL_UINT16(1, unit_test_find_entry(2, 0x0123));
+    TEST_ASSERT_EQUAL_UINT16(1, unit_test_find_entry(1, 0x3456));
+    TEST_ASSERT_EQUAL_UINT8(0, unit_test_lock_depth);
+
+    /* dumped samples are not sent again */
+    unit_test_dump();
+    unit_test_assert_header(0, 0);
+    TEST_ASSERT_EQUAL_size_t(0, unit_test_entry_count());
+}
+
+void TestSamplesAreDroppedWhenProbesAreTaken(void) {
+    /* program counters with equal low and high bytes share the first probe */
+    uint16_t pc = 0;
+    for (uint8_t i = 0; i < AVRTOS_PROFILER_PROBES + 2; i++) {
+        _avrtos_profiler_record(0, pc);
+        pc += 0x0101;
+    }
+
+    unit_test_dump();
+    unit_test_assert_header(AVRTOS_PROFILER_PROBES + 2, 2);
+    TEST_ASSERT_EQUAL_size_t(AVRTOS_PROFILER_PROBES, unit_test_entry_count());
+    TEST_ASSERT_EQUAL_UINT16(1, unit_test_find_entry(0, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, unit_test_find_entry(0, pc - 0x0101));
+}
+
+void TestDisabled(void) {
+    _avrtos_profiler_record(1, 0x0042);
+    avrtos_profiler_set_enabled(false);
+    _avrtos_profiler_record(1, 0x0042);
+    _avrtos_profiler_record(1, 0x0043);
+    TEST_ASSERT_EQUAL_UINT32(1, avrtos_profiler_get_samples());
+
+    unit_test_dump();
+    unit_test_assert_header(1, 0);
+    TEST_ASSERT_EQUAL_size_t(1, unit_test_entry_count());
+    TEST_ASSERT_EQUAL_UINT16(1, unit_test_find_entry(1, 0x0042));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestRecordAndDump);
+    RUN_TEST(TestSamplesAreDroppedWhenProbesAreTaken);
+    RUN_TEST(TestDisabled);
+
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <record_ring_arch_ind.h>
+
+#define UNIT_TEST_RECORD_RING_SIZE 16
+RECORD_RING_DEFINE(test_ring, UNIT_TEST_RECORD_RING_SIZE);
+
+void setUp(void) {
+    /* initialize ring before each test, critical part*/
+    enum circular_buffer_status ret = record_ring_initialize(
+            &test_ring, test_ring_data, UNIT_TEST_RECORD_RING_SIZE);
+    if (!(ret == CIRC_BUFF_OK && record_ring_is_empty(&test_ring)
+          && test_ring.overwritten_records == 0
+          && test_ring.overwritten_bytes == 0)) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Ring initialization failed, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestInitialize(void) {
+    struct record_ring ring;
+    char buffer[UNIT_TEST_RECORD_RING_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_initialize(NULL, buffer, 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_initialize(&ring, NULL, 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_initialize(&ring, buffer, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_initialize(&ring, buffer, 2));
+}
+
+void TestWriteAndRead(void) {
+    char out[UNIT_TEST_RECORD_RING_SIZE];
+    uint8_t len;
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          record_ring_peek_length(&test_ring, &len));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "abc", 3));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "", 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "defgh", 5));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_peek_length(&test_ring, &len));
+    TEST_ASSERT_EQUAL_UINT8(3, len);
+    /* too small output buffer keeps the record */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_read(&test_ring, out, 2, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(3, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("abc", out, 3);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(0, len);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(5, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("defgh", out, 5);
+    TEST_ASSERT_TRUE(record_ring_is_empty(&test_ring));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, record_ring_write(NULL, "a", 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_write(&test_ring, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_read(&test_ring, NULL, 1, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_read(&test_ring, out, 1, NULL));
+}
+
+void TestOverwriteOldestRecords(void) {
+    char out[UNIT_TEST_RECORD_RING_SIZE] = {0};
+    uint8_t len;
+
+    /* a record never fitting into the ring is rejected */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_write(&test_ring, out,
+                                            UNIT_TEST_RECORD_RING_SIZE));
+
+    /* 3 records of 5 bytes (4 + length byte) fill 15 of 16 bytes */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "aaaa", 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "bbbb", 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "cccc", 4));
+    TEST_ASSERT_EQUAL_size_t(0, test_ring.overwritten_records);
+
+    /* needs 7 bytes, so the two oldest records are dropped as a whole */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "dddddd", 6));
+    TEST_ASSERT_EQUAL_size_t(2, test_ring.overwritten_records);
+    TEST_ASSERT_EQUAL_size_t(8, test_ring.overwritten_bytes);
+
+    /* reader resyncs to the oldest whole record */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(4, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("cccc", out, 4);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(6, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("dddddd", out, 6);
+    TEST_ASSERT_TRUE(record_ring_is_empty(&test_ring));
+
+    /* the longest possible record drops everything else */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "ee", 2));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "fffffffffffffff",
+                                            UNIT_TEST_RECORD_RING_SIZE - 1));
+    TEST_ASSERT_EQUAL_size_t(3, test_ring.overwritten_records);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_read(&test_ring, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_RECORD_RING_SIZE - 1, len);
+
+    /* a corrupted length byte running past the stored data is not trusted */
+    char *ptr;
+    size_t contiguous;
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          record_ring_write(&test_ring, "gg", 2));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          circ_buff_peek_contiguous(&test_ring.buffer, &ptr,
+                                                    &contiguous));
+    *ptr = (char) 200;
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          record_ring_write(&test_ring, "fffffffffffffff",
+                                            UNIT_TEST_RECORD_RING_SIZE - 1));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, record_ring_reset(&test_ring));
+    TEST_ASSERT_EQUAL_size_t(0, test_ring.overwritten_records);
+    TEST_ASSERT_EQUAL_size_t(0, test_ring.overwritten_bytes);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, record_ring_reset(NULL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestInitialize);
+    RUN_TEST(TestWriteAndRead);
+    RUN_TEST(TestOverwriteOldestRecords);
+
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <typed_ring_buffer_arch_ind.h>
+
+using avrtos::RingBuffer;
+
+struct TestSample {
+    uint16_t value;
+    uint8_t channel;
+};
+
+#define UNIT_TEST_RING_SIZE 6
+RingBuffer<uint16_t, UNIT_TEST_RING_SIZE> test_ring;
+RingBuffer<TestSample, UNIT_TEST_RING_SIZE> test_sample_ring;
+
+static_assert(RingBuffer<uint16_t, UNIT_TEST_RING_SIZE>::capacity()
+                      == UNIT_TEST_RING_SIZE,
+              "capacity has to be a compile-time constant");
+static_assert(sizeof(RingBuffer<char, 10>) == 12,
+              "small buffers should use single byte indices");
+
+void setUp(void) {
+    test_ring.clear();
+    test_sample_ring.clear();
+}
+
+void tearDown(void) {}
+
+void TestPushAndPopOne(void) {
+    uint16_t value;
+
+    TEST_ASSERT_TRUE(test_ring.empty());
+    TEST_ASSERT_FALSE(test_ring.pop(value));
+    for (uint16_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        TEST_ASSERT_TRUE(test_ring.push(static_cast<uint16_t>(2000 + i)));
+    }
+    TEST_ASSERT_TRUE(test_ring.full());
+    TEST_ASSERT_FALSE(test_ring.push(0));
+
+    for (uint16_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        TEST_ASSERT_TRUE(test_ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT16(2000 + i, value);
+    }
+    TEST_ASSERT_TRUE(test_ring.empty());
+}
+
+void TestPushAndPopFewAcrossEnd(void) {
+    TestSample in[UNIT_TEST_RING_SIZE + 2];
+    TestSample out[UNIT_TEST_RING_SIZE + 2];
+    for (uint8_t i = 0; i < UNIT_TEST_RING_SIZE + 2; i++) {
+        in[i].value = static_cast<uint16_t>(0x4321 + i);
+        in[i].channel = i;
+    }
+
+    /* move head to the middle so that the copies are split */
+    TEST_ASSERT_EQUAL_size_t(4, test_sample_ring.push(in, 4));
+    TEST_ASSERT_EQUAL_size_t(4, test_sample_ring.pop(out, 4));
+
+    /* partial transfers return the number of moved elements */
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE,
+                             test_sample_ring.push(in, UNIT_TEST_RING_SIZE + 2));
+    TEST_ASSERT_EQUAL_size_t(0, test_sample_ring.push(in, 1));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE, test_sample_ring.size());
+    TEST_ASSERT_EQUAL_size_t(0, test_sample_ring.space_left());
+
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE,
+                             test_sample_ring.pop(out, UNIT_TEST_RING_SIZE + 2));
+    for (uint8_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        TEST_ASSERT_EQUAL_UINT16(in[i].value, out[i].value);
+        TEST_ASSERT_EQUAL_UINT8(in[i].channel, out[i].channel);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, test_sample_ring.pop(out, 1));
+    TEST_ASSERT_TRUE(test_sample_ring.empty());
+}
+
+void TestWrapAround(void) {
+    uint16_t value;
+
+    for (uint16_t round = 0; round < 5 * UNIT_TEST_RING_SIZE; round++) {
+        TEST_ASSERT_TRUE(test_ring.push(round));
+        TEST_ASSERT_TRUE(test_ring.push(static_cast<uint16_t>(round + 1)));
+        TEST_ASSERT_TRUE(test_ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT16(round, value);
+        TEST_ASSERT_TRUE(test_ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT16(round + 1, value);
+    }
+    TEST_ASSERT_TRUE(test_ring.empty());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestPushAndPopOne);
+    RUN_TEST(TestPushAndPopFewAcrossEnd);
+    RUN_TEST(TestWrapAround);
+
+    return UNITY_END();
+}
@@ -0,0 +1,256 @@
+#include "test_utils.h"
+#include <string.h>
+#include <unity.h>
+
+#include <spsc_ring_arch_ind.h>
+
+#define UNIT_TEST_SPSC_RING_SIZE 8
+SPSC_RING_DEFINE(test_ring, UNIT_TEST_SPSC_RING_SIZE);
+
+void setUp(void) {
+    /* set all global buffer values to zero */
+    for (size_t i = 0; i < UNIT_TEST_SPSC_RING_SIZE; i++) {
+        test_ring_data[i] = '\0';
+    }
+
+    /* initialize ring before each test, critical part*/
+    enum circular_buffer_status ret = spsc_ring_initialize(
+            &test_ring, test_ring_data, UNIT_TEST_SPSC_RING_SIZE);
+    if (!(ret == CIRC_BUFF_OK && test_ring.data == test_ring_data
+          && test_ring.size == UNIT_TEST_SPSC_RING_SIZE && test_ring.head == 0
+          && test_ring.tail == 0)) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Ring initialization failed, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestInitialize(void) {
+    struct spsc_ring ring;
+    char buffer[SPSC_RING_MAX_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_initialize(NULL, buffer, 16));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_initialize(&ring, NULL, 16));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_initialize(&ring, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_initialize(&ring, buffer, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_initialize(&ring, buffer,
+                                               SPSC_RING_MAX_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_initialize(&ring, buffer, 2));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_initialize(&ring, buffer, 12));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_initialize(&ring, buffer,
+                                               SPSC_RING_MAX_SIZE));
+}
+
+void TestInsertAndGetElements(void) {
+    char value;
+
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          spsc_ring_get_one(&test_ring, &value));
+
+    /* one slot is always kept free */
+    for (char i = 0; i < UNIT_TEST_SPSC_RING_SIZE - 1; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_insert_one(&test_ring, i));
+    }
+    TEST_ASSERT_TRUE(spsc_ring_is_full(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          spsc_ring_insert_one(&test_ring, 100));
+
+    for (char i = 0; i < UNIT_TEST_SPSC_RING_SIZE - 1; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_get_one(&test_ring, &value));
+        TEST_ASSERT_EQUAL_CHAR(i, value);
+    }
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          spsc_ring_get_one(&test_ring, &value));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_insert_one(NULL, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_get_one(NULL, &value));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_get_one(&test_ring, NULL));
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(NULL));
+    TEST_ASSERT_TRUE(spsc_ring_is_full(NULL));
+}
+
+void TestIndicesWrapAround(void) {
+    char value;
+
+    /* interleave producer and consumer so that both indices wrap many
+       times */
+    for (int round = 0; round < 10 * UNIT_TEST_SPSC_RING_SIZE; round++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_insert_one(&test_ring, (char) round));
+        TEST_ASSERT_EQUAL_INT(
+                CIRC_BUFF_OK,
+                spsc_ring_insert_one(&test_ring, (char) (round + 1)));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_get_one(&test_ring, &value));
+        TEST_ASSERT_EQUAL_CHAR((char) round, value);
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_get_one(&test_ring, &value));
+        TEST_ASSERT_EQUAL_CHAR((char) (round + 1), value);
+        TEST_ASSERT_LESS_THAN_UINT8(UNIT_TEST_SPSC_RING_SIZE, test_ring.head);
+        TEST_ASSERT_LESS_THAN_UINT8(UNIT_TEST_SPSC_RING_SIZE, test_ring.tail);
+    }
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+}
+
+void TestGetOccupancyAndSpaceLeft(void) {
+    char value;
+
+    TEST_ASSERT_EQUAL_UINT8(0, spsc_ring_get_occupancy(&test_ring));
+    TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_SPSC_RING_SIZE - 1,
+                            spsc_ring_get_space_left(&test_ring));
+
+    /* move the indices close to the end of the data buffer */
+    for (int i = 0; i < UNIT_TEST_SPSC_RING_SIZE - 2; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_insert_one(&test_ring, 0));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_get_one(&test_ring, &value));
+    }
+
+    for (uint8_t i = 1; i < UNIT_TEST_SPSC_RING_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_insert_one(&test_ring, 0));
+        TEST_ASSERT_EQUAL_UINT8(i, spsc_ring_get_occupancy(&test_ring));
+        TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_SPSC_RING_SIZE - 1 - i,
+                                spsc_ring_get_space_left(&test_ring));
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(0, spsc_ring_get_occupancy(NULL));
+    TEST_ASSERT_EQUAL_UINT8(0, spsc_ring_get_space_left(NULL));
+}
+
+void TestReserveCommitPeekConsume(void) {
+    char *ptr;
+    uint8_t len;
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_reserve(NULL, &ptr, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_reserve(&test_ring, NULL, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_reserve(&test_ring, &ptr, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_commit(NULL, 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_peek_contiguous(NULL, &ptr, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_consume(NULL, 0));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          spsc_ring_peek_contiguous(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_consume(&test_ring, 1));
+
+    /* head at 0, the last slot has to stay free */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_reserve(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(test_ring_data, ptr);
+    TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_SPSC_RING_SIZE - 1, len);
+    memcpy(ptr, "abcde", 5);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_commit(&test_ring,
+                                           UNIT_TEST_SPSC_RING_SIZE));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_commit(&test_ring, 5));
+    TEST_ASSERT_EQUAL_UINT8(5, spsc_ring_get_occupancy(&test_ring));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_peek_contiguous(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(test_ring_data, ptr);
+    TEST_ASSERT_EQUAL_UINT8(5, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("abcde", ptr, 5);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_consume(&test_ring, 4));
+
+    /* free region reaches the end of the data buffer */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_reserve(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(&test_ring_data[5], ptr);
+    TEST_ASSERT_EQUAL_UINT8(3, len);
+    memcpy(ptr, "fgh", 3);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_commit(&test_ring, 3));
+    TEST_ASSERT_EQUAL_UINT8(0, test_ring.tail);
+
+    /* and continues up to the slot before head */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_reserve(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_PTR(test_ring_data, ptr);
+    TEST_ASSERT_EQUAL_UINT8(3, len);
+    memcpy(ptr, "ijk", 3);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_commit(&test_ring, 3));
+    TEST_ASSERT_TRUE(spsc_ring_is_full(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          spsc_ring_reserve(&test_ring, &ptr, &len));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_peek_contiguous(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_UINT8(4, len);
+    TEST_ASSERT_EQUAL_CHAR_ARRAY("efgh", ptr, 4);
+
+    /* consume may cross the end of the data buffer */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_consume(&test_ring, 6));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          spsc_ring_peek_contiguous(&test_ring, &ptr, &len));
+    TEST_ASSERT_EQUAL_UINT8(1, len);
+    TEST_ASSERT_EQUAL_CHAR('k', *ptr);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_consume(&test_ring, 1));
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+}
+
+void TestStagePublish(void) {
+    char value;
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_stage(NULL, 0, 'a'));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, spsc_ring_publish(NULL, 0));
+
+    /* move indices close to the end of the data buffer */
+    for (size_t i = 0; i < UNIT_TEST_SPSC_RING_SIZE - 2; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_insert_one(&test_ring, 'x'));
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              spsc_ring_get_one(&test_ring, &value));
+    }
+
+    /* staged elements cross the end of the data buffer and stay invisible */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_stage(&test_ring, 0, 'a'));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_stage(&test_ring, 1, 'b'));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_stage(&test_ring, 2, 'c'));
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          spsc_ring_stage(&test_ring,
+                                          UNIT_TEST_SPSC_RING_SIZE - 1, 'd'));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          spsc_ring_publish(&test_ring,
+                                            UNIT_TEST_SPSC_RING_SIZE));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_publish(&test_ring, 3));
+    TEST_ASSERT_EQUAL_UINT8(3, spsc_ring_get_occupancy(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_get_one(&test_ring, &value));
+    TEST_ASSERT_EQUAL_CHAR('a', value);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_get_one(&test_ring, &value));
+    TEST_ASSERT_EQUAL_CHAR('b', value);
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, spsc_ring_get_one(&test_ring, &value));
+    TEST_ASSERT_EQUAL_CHAR('c', value);
+    TEST_ASSERT_TRUE(spsc_ring_is_empty(&test_ring));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestInitialize);
+    RUN_TEST(TestInsertAndGetElements);
+    RUN_TEST(TestIndicesWrapAround);
+    RUN_TEST(TestGetOccupancyAndSpaceLeft);
+    RUN_TEST(TestReserveCommitPeekConsume);
+    RUN_TEST(TestStagePublish);
+
+    return UNITY_END();
+}
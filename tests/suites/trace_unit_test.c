@@ -0,0 +1,177 @@
+#include "test_utils.h"
+#include <string.h>
+#include <unity.h>
+
+#include <trace_arch_ind.h>
+
+#define UNIT_TEST_SUBTICKS_PER_TICK 100
+
+char unit_test_output[2 * AVRTOS_TRACE_BUFFER_SIZE
+                      * AVRTOS_TRACE_EVENT_FRAME_SIZE];
+size_t unit_test_output_len;
+uint16_t unit_test_ticks;
+uint8_t unit_test_lock_depth;
+
+uint8_t avrtos_irq_lock_impl(void) {
+    return unit_test_lock_depth++;
+}
+
+void avrtos_irq_unlock_impl(uint8_t key) {
+    unit_test_lock_depth = key;
+}
+
+void avrtos_trace_timestamp_impl(uint16_t *ticks, uint8_t *subticks) {
+    TEST_ASSERT_TRUE(unit_test_lock_depth > 0);
+    *ticks = unit_test_ticks++;
+    *subticks = 42;
+}
+
+uint8_t avrtos_trace_get_subticks_per_tick_impl(void) {
+    return UNIT_TEST_SUBTICKS_PER_TICK;
+}
+
+void avrtos_log_lock_impl(void) {}
+
+void avrtos_log_unlock_impl(void) {}
+
+bool avrtos_log_write_impl(const char *data, size_t len, bool wait) {
+    TEST_ASSERT_TRUE(wait);
+    TEST_ASSERT_TRUE(unit_test_output_len + len <= sizeof(unit_test_output));
+    memcpy(&unit_test_output[unit_test_output_len], data, len);
+    unit_test_output_len += len;
+    return true;
+}
+
+static void unit_test_dump(void) {
+    unit_test_output_len = 0;
+    avrtos_trace_dump();
+}
+
+static uint8_t unit_test_checksum(const char *frame, size_t len) {
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < len - 1; i++) {
+        checksum += (uint8_t) frame[i];
+    }
+    return checksum;
+}
+
+static void unit_test_assert_header(uint16_t lost) {
+    const char *frame = unit_test_output;
+    TEST_ASSERT_TRUE(unit_test_output_len >= AVRTOS_TRACE_HEADER_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_SYNC, (uint8_t) frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_FRAME_HEADER, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_VERSION, frame[2]);
+    TEST_ASSERT_EQUAL_UINT16(AVRTOS_DELAY_TICK_PERIOD_US,
+                             (uint8_t) frame[3] | (uint8_t) frame[4] << 8);
+    TEST_ASSERT_EQUAL_UINT8(UNIT_TEST_SUBTICKS_PER_TICK, (uint8_t) frame[5]);
+    TEST_ASSERT_EQUAL_UINT16(lost,
+                             (uint8_t) frame[6] | (uint8_t) frame[7] << 8);
+    TEST_ASSERT_EQUAL_UINT8(
+            unit_test_checksum(frame, AVRTOS_TRACE_HEADER_FRAME_SIZE),
+            (uint8_t) frame[8]);
+}
+
+static void unit_test_assert_event(size_t index,
+                                   uint8_t type,
+                                   uint8_t arg,
+                                   uint16_t ticks) {
+    size_t offset = AVRTOS_TRACE_HEADER_FRAME_SIZE
+                    + index * AVRTOS_TRACE_EVENT_FRAME_SIZE;
+    const char *frame = &unit_test_output[offset];
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_SYNC, (uint8_t) frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_FRAME_EVENT, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(type, (uint8_t) frame[2]);
+    TEST_ASSERT_EQUAL_UINT8(arg, (uint8_t) frame[3]);
+    TEST_ASSERT_EQUAL_UINT16(ticks,
+                             (uint8_t) frame[4] | (uint8_t) frame[5] << 8);
+    TEST_ASSERT_EQUAL_UINT8(42, (uint8_t) frame[6]);
+    TEST_ASSERT_EQUAL_UINT8(
+            unit_test_checksum(frame, AVRTOS_TRACE_EVENT_FRAME_SIZE),
+            (uint8_t) frame[7]);
+}
+
+void setUp(void) {
+    avrtos_trace_set_mask(AVRTOS_TRACE_ALL);
+    /* start every test with an empty trace buffer */
+    unit_test_dump();
+    if (avrtos_trace_get_count() != 0) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Trace buffer is not empty, abort all test cases");
+    }
+    unit_test_ticks = 0x1234;
+}
+
+void tearDown(void) {}
+
+void TestRecordAndDump(void) {
+    _avrtos_trace_record(AVRTOS_TRACE_TASK_SWITCH_IN, 1);
+    _avrtos_trace_record(AVRTOS_TRACE_MUTEX_LOCK, 0xAB);
+    avrtos_trace_marker(7);
+    TEST_ASSERT_EQUAL_UINT8(3, avrtos_trace_get_count());
+    TEST_ASSERT_EQUAL_UINT8(0, unit_test_lock_depth);
+
+    unit_test_dump();
+    TEST_ASSERT_EQUAL_size_t(AVRTOS_TRACE_HEADER_FRAME_SIZE
+                                     + 3 * AVRTOS_TRACE_EVENT_FRAME_SIZE,
+                             unit_test_output_len);
+    unit_test_assert_header(0);
+    unit_test_assert_event(0, AVRTOS_TRACE_TASK_SWITCH_IN, 1, 0x1234);
+    unit_test_assert_event(1, AVRTOS_TRACE_MUTEX_LOCK, 0xAB, 0x1235);
+    unit_test_assert_event(2, AVRTOS_TRACE_MARKER, 7, 0x1236);
+    TEST_ASSERT_EQUAL_UINT8(0, avrtos_trace_get_count());
+
+    /* dumped events are not sent again */
+    unit_test_dump();
+    TEST_ASSERT_EQUAL_size_t(AVRTOS_TRACE_HEADER_FRAME_SIZE,
+                             unit_test_output_len);
+}
+
+void TestOldestEventsAreOverwritten(void) {
+    for (uint8_t i = 0; i < AVRTOS_TRACE_BUFFER_SIZE + 3; i++) {
+        avrtos_trace_marker(i);
+    }
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_BUFFER_SIZE,
+                            avrtos_trace_get_count());
+
+    unit_test_dump();
+    unit_test_assert_header(3);
+    unit_test_assert_event(0, AVRTOS_TRACE_MARKER, 3, 0x1237);
+    unit_test_assert_event(AVRTOS_TRACE_BUFFER_SIZE - 1, AVRTOS_TRACE_MARKER,
+                           AVRTOS_TRACE_BUFFER_SIZE + 2,
+                           0x1234 + AVRTOS_TRACE_BUFFER_SIZE + 2);
+
+    /* lost events are reported once */
+    unit_test_dump();
+    unit_test_assert_header(0);
+}
+
+void TestMask(void) {
+    avrtos_trace_set_mask(AVRTOS_TRACE_MARKERS | AVRTOS_TRACE_ISRS);
+    TEST_ASSERT_EQUAL_UINT8(AVRTOS_TRACE_MARKERS | AVRTOS_TRACE_ISRS,
+                            avrtos_trace_get_mask());
+
+    _avrtos_trace_record(AVRTOS_TRACE_TASK_SWITCH_OUT, 1);
+    _avrtos_trace_record(AVRTOS_TRACE_MUTEX_UNLOCK, 0xAB);
+    _avrtos_trace_record(AVRTOS_TRACE_DELAY_START, 1);
+    _avrtos_trace_record(AVRTOS_TRACE_ISR_ENTER, 19);
+    avrtos_trace_marker(1);
+    TEST_ASSERT_EQUAL_UINT8(2, avrtos_trace_get_count());
+
+    avrtos_trace_set_mask(0);
+    avrtos_trace_marker(2);
+    TEST_ASSERT_EQUAL_UINT8(2, avrtos_trace_get_count());
+
+    unit_test_dump();
+    unit_test_assert_event(0, AVRTOS_TRACE_ISR_ENTER, 19, 0x1234);
+    unit_test_assert_event(1, AVRTOS_TRACE_MARKER, 1, 0x1235);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestRecordAndDump);
+    RUN_TEST(TestOldestEventsAreOverwritten);
+    RUN_TEST(TestMask);
+
+    return UNITY_END();
+}
@@ -0,0 +1,147 @@
+#include "test_utils.h"
+#include <unity.h>
+
+#include <typed_ring_buffer_arch_ind.h>
+
+struct test_sample {
+    uint16_t value;
+    uint8_t channel;
+};
+
+TYPED_RING_BUFFER_DECLARE(u16_ring, uint16_t);
+TYPED_RING_BUFFER_DECLARE(sample_ring, struct test_sample);
+
+#define UNIT_TEST_RING_SIZE 6
+TYPED_RING_BUFFER_DEFINE(u16_ring, uint16_t, test_ring, UNIT_TEST_RING_SIZE);
+TYPED_RING_BUFFER_DEFINE(sample_ring,
+                         struct test_sample,
+                         test_sample_ring,
+                         UNIT_TEST_RING_SIZE);
+
+void setUp(void) {
+    /* initialize rings before each test, critical part*/
+    if (!(u16_ring_initialize(&test_ring, test_ring_data, UNIT_TEST_RING_SIZE)
+                  == CIRC_BUFF_OK
+          && sample_ring_initialize(&test_sample_ring, test_sample_ring_data,
+                                    UNIT_TEST_RING_SIZE)
+                     == CIRC_BUFF_OK)) {
+        TEST_SUITE_FINISH_CRITICAL(
+                "Ring initialization failed, abort all test cases");
+    }
+}
+
+void tearDown(void) {}
+
+void TestInitialize(void) {
+    struct u16_ring ring;
+    uint16_t buffer[UNIT_TEST_RING_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          u16_ring_initialize(NULL, buffer,
+                                              UNIT_TEST_RING_SIZE));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          u16_ring_initialize(&ring, NULL,
+                                              UNIT_TEST_RING_SIZE));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          u16_ring_initialize(&ring, buffer, 0));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          u16_ring_initialize(&ring, buffer,
+                                              UNIT_TEST_RING_SIZE));
+    TEST_ASSERT_EQUAL_PTR(buffer, ring.data);
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE, ring.capacity);
+    TEST_ASSERT_TRUE(u16_ring_is_empty(&ring));
+}
+
+void TestInsertAndGetOne(void) {
+    uint16_t value;
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY, u16_ring_get_one(&test_ring, &value));
+    for (uint16_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        uint16_t sample = (uint16_t) (1000 + i);
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              u16_ring_insert_one(&test_ring, &sample));
+    }
+    TEST_ASSERT_TRUE(u16_ring_is_full(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          u16_ring_insert_one(&test_ring, &value));
+
+    for (uint16_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                              u16_ring_get_one(&test_ring, &value));
+        TEST_ASSERT_EQUAL_UINT16(1000 + i, value);
+    }
+    TEST_ASSERT_TRUE(u16_ring_is_empty(&test_ring));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, u16_ring_insert_one(NULL, &value));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          u16_ring_insert_one(&test_ring, NULL));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, u16_ring_get_one(NULL, &value));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, u16_ring_get_one(&test_ring, NULL));
+}
+
+void TestInsertAndGetFewStructsAcrossEnd(void) {
+    struct test_sample in[UNIT_TEST_RING_SIZE];
+    struct test_sample out[UNIT_TEST_RING_SIZE];
+    for (uint8_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        in[i].value = (uint16_t) (0x1234 + i);
+        in[i].channel = i;
+    }
+
+    /* move head to the middle so that the copies are split */
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          sample_ring_insert_few(&test_sample_ring, in, 4));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          sample_ring_get_few(&test_sample_ring, out, 4));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_FULL,
+                          sample_ring_insert_few(&test_sample_ring, in,
+                                                 UNIT_TEST_RING_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          sample_ring_insert_few(&test_sample_ring, in,
+                                                 UNIT_TEST_RING_SIZE));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE,
+                             sample_ring_get_occupancy(&test_sample_ring));
+    TEST_ASSERT_EQUAL_size_t(0, sample_ring_get_space_left(&test_sample_ring));
+    TEST_ASSERT_EQUAL_UINT16(in[0].value, test_sample_ring_data[4].value);
+    TEST_ASSERT_EQUAL_UINT16(in[2].value, test_sample_ring_data[0].value);
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_EMPTY,
+                          sample_ring_get_few(&test_sample_ring, out,
+                                              UNIT_TEST_RING_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          sample_ring_get_few(&test_sample_ring, out,
+                                              UNIT_TEST_RING_SIZE));
+    for (uint8_t i = 0; i < UNIT_TEST_RING_SIZE; i++) {
+        TEST_ASSERT_EQUAL_UINT16(in[i].value, out[i].value);
+        TEST_ASSERT_EQUAL_UINT8(in[i].channel, out[i].channel);
+    }
+    TEST_ASSERT_TRUE(sample_ring_is_empty(&test_sample_ring));
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          sample_ring_insert_few(NULL, in, 1));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID,
+                          sample_ring_get_few(&test_sample_ring, NULL, 1));
+}
+
+void TestReset(void) {
+    uint16_t values[3] = {1, 2, 3};
+
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK,
+                          u16_ring_insert_few(&test_ring, values, 3));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_OK, u16_ring_reset(&test_ring));
+    TEST_ASSERT_TRUE(u16_ring_is_empty(&test_ring));
+    TEST_ASSERT_EQUAL_size_t(UNIT_TEST_RING_SIZE,
+                             u16_ring_get_space_left(&test_ring));
+    TEST_ASSERT_EQUAL_INT(CIRC_BUFF_INVALID, u16_ring_reset(NULL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(TestInitialize);
+    RUN_TEST(TestInsertAndGetOne);
+    RUN_TEST(TestInsertAndGetFewStructsAcrossEnd);
+    RUN_TEST(TestReset);
+
+    return UNITY_END();
+}
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Decoder of AVRTOS binary log records (AVRTOS_WITH_BINARY_LOGGER).
+
+Reads the raw UART stream and the application ELF file, looks up the format
+strings stored in the non-loaded ".avrtos_log_fmt" section and prints the
+reconstructed log messages.
+
+Usage:
+    stty -F /dev/ttyUSB0 9600 raw -echo
+    ./avrtos_log_decoder.py app.elf /dev/ttyUSB0
+
+Record layout (little-endian):
+    | sync 0xA5 (1) | length (1) | format ID (2) | timestamp (4) | arguments |
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+RECORD_SYNC = 0xA5
+RECORD_HEADER_SIZE = 8
+FMT_SECTION = ".avrtos_log_fmt"
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+PRINTF_SPEC = re.compile(
+    r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|L|z|j|t)?"
+    r"([diouxXcsfFeEgGaAp%])")
+
+
+class ElfSection:
+    def __init__(self, name, sh_type, flags, addr, size, link, entsize, data):
+        self.name = name
+        self.type = sh_type
+        self.flags = flags
+        self.addr = addr
+        self.size = size
+        self.link = link
+        self.entsize = entsize
+        self.data = data
+
+
+def read_elf_sections(path):
+    """Returns the sections of a little-endian ELF32 or ELF64 file."""
+    with open(path, "rb") as elf:
+        image = elf.read()
+    if image[:4] != b"\x7fELF" or image[5] != 1:
+        raise ValueError(f"{path}: not a little-endian ELF file")
+    is_64 = image[4] == 2
+    if is_64:
+        shoff, = struct.unpack_from("<Q", image, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", image, 0x3A)
+        header = "<IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from("<I", image, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", image, 0x2E)
+        header = "<IIIIIIIIII"
+
+    raw = []
+    for index in range(shnum):
+        fields = struct.unpack_from(header, image, shoff + index * shentsize)
+        name, sh_type, flags, addr, offset, size, link = fields[:7]
+        entsize = fields[9]
+        data = b"" if sh_type == SHT_NOBITS else image[offset:offset + size]
+        raw.append((name, sh_type, flags, addr, size, link, entsize, data))
+
+    names = raw[shstrndx][-1]
+    sections = []
+    for name, *fields in raw:
+        sections.append(ElfSection(read_c_string(names, name), *fields))
+    return sections
+
+
+def read_c_string(data, offset):
+    end = data.find(b"\0", offset)
+    end = len(data) if end < 0 else end
+    return data[offset:end].decode(errors="replace")
+
+
+class Decoder:
+    def __init__(self, sections, args):
+        self.args = args
+        self.sections = sections
+        self.formats = {}
+        for section in sections:
+            if section.name == FMT_SECTION:
+                self._load_formats(section)
+        if not self.formats:
+            raise ValueError(f"no format strings in {FMT_SECTION} section")
+
+    def _load_formats(self, section):
+        data = section.data
+        for offset in range(len(data)):
+            if data[offset] and (offset == 0 or not data[offset - 1]):
+                fmt_id = (section.addr + offset) & 0xFFFF
+                self.formats[fmt_id] = read_c_string(data, offset)
+
+    def resolve_string(self, pointer):
+        """Finds a constant string the MCU pointer points to."""
+        address = pointer + self.args.data_offset
+        for section in self.sections:
+            if not (section.flags & SHF_ALLOC) or not section.data:
+                continue
+            if section.addr <= address < section.addr + len(section.data):
+                return read_c_string(section.data, address - section.addr)
+        return f"<string at 0x{pointer:x}>"
+
+    def _argument_size(self, length, conversion):
+        if conversion in "sp":
+            return self.args.ptr_size
+        if conversion in "fFeEgGaA":
+            return self.args.double_size
+        if length == "ll":
+            return 8
+        if length == "l":
+            return self.args.long_size
+        return self.args.int_size
+
+    def format_message(self, fmt, payload):
+        """Applies the raw arguments to the printf-like format string."""
+        output = []
+        position = 0
+        offset = 0
+        for spec in PRINTF_SPEC.finditer(fmt):
+            output.append(fmt[position:spec.start()])
+            position = spec.end()
+            flags, width, precision, length, conversion = spec.groups()
+            if conversion == "%":
+                output.append("%")
+                continue
+
+            if width == "*" or precision == "*":
+                if offset + self.args.int_size > len(payload):
+                    output.append("<truncated>")
+                    break
+                star = int.from_bytes(
+                    payload[offset:offset + self.args.int_size], "little",
+                    signed=True)
+                offset += self.args.int_size
+                width = str(star) if width == "*" else width
+                precision = str(star) if precision == "*" else precision
+
+            size = self._argument_size(length, conversion)
+            if offset + size > len(payload):
+                output.append("<truncated>")
+                break
+            raw = payload[offset:offset + size]
+            offset += size
+
+            python_spec = "%" + flags + (width or "")
+            if precision is not None:
+                python_spec += "." + precision
+            if conversion in "di":
+                value = int.from_bytes(raw, "little", signed=True)
+                output.append((python_spec + "d") % value)
+            elif conversion in "ouxX":
+                value = int.from_bytes(raw, "little")
+                conversion = "d" if conversion == "u" else conversion
+                output.append((python_spec + conversion) % value)
+            elif conversion == "c":
+                value = int.from_bytes(raw, "little") & 0xFF
+                output.append((python_spec + "c") % chr(value))
+            elif conversion == "p":
+                value = int.from_bytes(raw, "little")
+                output.append("0x%x" % value)
+            elif conversion == "s":
+                value = int.from_bytes(raw, "little")
+                output.append((python_spec + "s") % self.resolve_string(value))
+            else:
+                value, = struct.unpack("<f" if size == 4 else "<d", raw)
+                conversion = "f" if conversion == "F" else conversion
+                output.append((python_spec + conversion) % value)
+        else:
+            output.append(fmt[position:])
+        return "".join(output)
+
+    def decode_stream(self, stream, out):
+        buffer = bytearray()
+        while True:
+            chunk = stream.read(1) if self.args.follow else stream.read(4096)
+            if not chunk:
+                break
+            buffer += chunk
+            while True:
+                start = buffer.find(bytes([RECORD_SYNC]))
+                if start < 0:
+                    buffer.clear()
+                    break
+                del buffer[:start]
+                if len(buffer) < 2:
+                    break
+                length = buffer[1]
+                if length < RECORD_HEADER_SIZE:
+                    del buffer[:1]
+                    continue
+                if len(buffer) < length:
+                    break
+                fmt_id, timestamp = struct.unpack_from("<HI", buffer, 2)
+                fmt = self.formats.get(fmt_id)
+                if fmt is None:
+                    # Not a record start, resynchronize on the next sync byte
+                    del buffer[:1]
+                    continue
+                payload = bytes(buffer[RECORD_HEADER_SIZE:length])
+                del buffer[:length]
+                seconds = timestamp * self.args.tick_us / 1e6
+                message = self.format_message(fmt, payload).rstrip("\n")
+                out.write(f"[{seconds:12.4f}] {message}\n")
+                out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode AVRTOS binary log records.")
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="raw UART stream: file or serial device "
+                             "configured with stty (default: stdin)")
+    parser.add_argument("--follow", action="store_true",
+                        help="decode records as soon as they arrive")
+    parser.add_argument("--tick-us", type=float, default=100,
+                        help="delay timer tick period (default: 100)")
+    parser.add_argument("--int-size", type=int, default=2)
+    parser.add_argument("--long-size", type=int, default=4)
+    parser.add_argument("--ptr-size", type=int, default=2)
+    parser.add_argument("--double-size", type=int, default=4)
+    parser.add_argument("--data-offset", type=lambda v: int(v, 0),
+                        default=0x800000,
+                        help="offset of SRAM addresses in the ELF file "
+                             "(default: 0x800000)")
+    args = parser.parse_args()
+
+    decoder = Decoder(read_elf_sections(args.elf), args)
+    if args.input == "-":
+        decoder.decode_stream(sys.stdin.buffer, sys.stdout)
+    else:
+        with open(args.input, "rb", buffering=0) as stream:
+            decoder.decode_stream(stream, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
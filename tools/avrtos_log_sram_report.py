@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""SRAM report of AVRTOS log call sites.
+
+Every avrtos_log() call site keeps its level, module name and format string in
+a static "_avrtos_log_fmt" array placed in flash memory (or, with
+AVRTOS_WITH_BINARY_LOGGER, in a section that is not loaded at all). Without
+that, avr-gcc copies these strings into SRAM at startup. The report lists the
+call sites found in the ELF file and the SRAM they would otherwise take.
+
+Usage (e.g. as a post-build step):
+    ./avrtos_log_sram_report.py app.elf
+"""
+
+import argparse
+import struct
+
+from avrtos_log_decoder import SHF_ALLOC, read_c_string, read_elf_sections
+
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+LOG_FMT_SYMBOL = "_avrtos_log_fmt"
+SRAM_SECTIONS = (".data", ".bss", ".noinit")
+
+
+def read_object_symbols(sections):
+    """Yields (name, section index, size) of the data symbols."""
+    for section in sections:
+        if section.type != SHT_SYMTAB:
+            continue
+        names = sections[section.link].data
+        is_64 = section.entsize == struct.calcsize("<IBBHQQ")
+        entry = "<IBBHQQ" if is_64 else "<IIIBBH"
+        for offset in range(0, len(section.data), section.entsize):
+            fields = struct.unpack_from(entry, section.data, offset)
+            if is_64:
+                name, info, _, index, _, size = fields
+            else:
+                name, _, size, info, _, index = fields
+            if info & 0xF == STT_OBJECT:
+                yield read_c_string(names, name), index, size
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Report SRAM recovered by AVRTOS log call sites.")
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("--verbose", action="store_true",
+                        help="list every log call site")
+    args = parser.parse_args()
+
+    sections = read_elf_sections(args.elf)
+    sites = []
+    for name, index, size in read_object_symbols(sections):
+        if name.split(".")[0] == LOG_FMT_SYMBOL and index < len(sections):
+            sites.append((sections[index].name, size))
+
+    static_sram = sum(section.size for section in sections
+                      if section.name in SRAM_SECTIONS
+                      and section.flags & SHF_ALLOC)
+    recovered = sum(size for _, size in sites)
+
+    print(f"log call sites:            {len(sites)}")
+    print(f"SRAM recovered:            {recovered} bytes")
+    print(f"static SRAM still in use:  {static_sram} bytes "
+          f"({', '.join(SRAM_SECTIONS)})")
+    if args.verbose:
+        for section, size in sorted(sites):
+            print(f"    {size:5} bytes in {section}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Flat profile of AVRTOS sampling profiler dumps (AVRTOS_WITH_PROFILER).
+
+Reads the output of avrtos_profiler_dump() (raw UART stream from the board or
+from simavr, text log messages in between are skipped), sums all dumps found in
+it and maps the sampled program counters to functions with avr-addr2line.
+
+Usage:
+    stty -F /dev/ttyUSB0 9600 raw -echo
+    cat /dev/ttyUSB0 > profile.bin
+    ./avrtos_profile.py profile.bin -e firmware.elf
+    ./avrtos_profile.py profile.bin -e firmware.elf --lines
+
+Frame layout (little-endian):
+    | sync 0xA8 (1) | kind (1) | payload | checksum (1) |
+    header ('P'): | version (1) | samples (4) | dropped samples (2) |
+    entry ('S'):  | task ID (1) | program counter (2) | count (2) |
+
+Program counters are word addresses of the instruction the task resumes at.
+"""
+
+import argparse
+import collections
+import struct
+import subprocess
+import sys
+
+PROFILER_SYNC = 0xA8
+PROFILER_VERSION = 1
+FRAME_SIZES = {ord("P"): 10, ord("S"): 8}
+
+
+def read_frames(data):
+    """Yields (kind, payload) of the frames with a valid checksum."""
+    offset = 0
+    while True:
+        offset = data.find(bytes([PROFILER_SYNC]), offset)
+        if offset < 0 or offset + 2 > len(data):
+            return
+        size = FRAME_SIZES.get(data[offset + 1])
+        if size is None or offset + size > len(data):
+            offset += 1
+            continue
+        frame = data[offset:offset + size]
+        if sum(frame[1:-1]) & 0xFF != frame[-1]:
+            # Not a frame start, resynchronize on the next sync byte
+            offset += 1
+            continue
+        yield chr(frame[1]), frame[2:-1]
+        offset += size
+
+
+def read_profile(data):
+    """Returns the sample counts keyed by (task ID, byte address), the total
+    number of samples and the number of dropped samples."""
+    counts = collections.Counter()
+    samples = 0
+    dropped = 0
+    for kind, payload in read_frames(data):
+        if kind == "P":
+            version, dump_samples, dump_dropped = struct.unpack("<BIH",
+                                                                payload)
+            if version != PROFILER_VERSION:
+                raise ValueError(f"unsupported profile version {version}")
+            samples += dump_samples
+            dropped += dump_dropped
+            continue
+
+        task_id, pc, count = struct.unpack("<BHH", payload)
+        counts[(task_id, pc * 2)] += count
+    return counts, samples, dropped
+
+
+def symbolize(addresses, elf, addr2line):
+    """Returns (function, file:line) keyed by byte address."""
+    addresses = sorted(addresses)
+    if not elf or not addresses:
+        return {address: (f"0x{address:04x}", "??:0")
+                for address in addresses}
+
+    output = subprocess.run(
+        [addr2line, "-f", "-C", "-e", elf]
+        + [f"0x{address:x}" for address in addresses],
+        check=True, capture_output=True, text=True).stdout.splitlines()
+    return {address: (output[2 * i], output[2 * i + 1])
+            for i, address in enumerate(addresses)}
+
+
+def print_profile(counts, samples, dropped, symbols, lines, out):
+    out.write(f"{samples} samples, {dropped} dropped\n")
+    if dropped:
+        out.write("dropped samples found no free histogram entry, increase "
+                  "AVRTOS_PROFILER_TABLE_SIZE\n")
+    per_task = collections.defaultdict(collections.Counter)
+    for (task_id, address), count in counts.items():
+        function, location = symbols[address]
+        key = f"{function} ({location})" if lines else function
+        per_task[task_id][key] += count
+
+    for task_id in sorted(per_task):
+        task_counts = per_task[task_id]
+        task_samples = sum(task_counts.values())
+        share = 100.0 * task_samples / samples if samples else 0.0
+        out.write(f"\ntask {task_id}: {task_samples} samples "
+                  f"({share:.1f}% of all)\n")
+        out.write("  % task  samples  symbol\n")
+        for key, count in task_counts.most_common():
+            out.write(f"  {100.0 * count / task_samples:6.1f}  {count:7d}  "
+                      f"{key}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Print a flat profile of AVRTOS profiler dumps.")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="raw UART stream with avrtos_profiler_dump() "
+                             "output (default: stdin)")
+    parser.add_argument("-e", "--elf",
+                        help="firmware ELF file used to map program counters "
+                             "to functions")
+    parser.add_argument("--addr2line", default="avr-addr2line",
+                        help="addr2line executable (default: avr-addr2line)")
+    parser.add_argument("--lines", action="store_true",
+                        help="profile source lines instead of functions")
+    args = parser.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as stream:
+            data = stream.read()
+    counts, samples, dropped = read_profile(data)
+    if not counts:
+        print("no profiler samples found", file=sys.stderr)
+
+    symbols = symbolize({address for _, address in counts}, args.elf,
+                        args.addr2line)
+    print_profile(counts, samples, dropped, symbols, args.lines, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""Converter of AVRTOS kernel event traces (AVRTOS_WITH_TRACE).
+
+Reads the output of avrtos_trace_dump() (raw UART stream, text log messages in
+between are skipped) and writes it as Chrome/Perfetto JSON (open it in
+https://ui.perfetto.dev or chrome://tracing) or as VCD (e.g. for GTKWave).
+
+Usage:
+    stty -F /dev/ttyUSB0 9600 raw -echo
+    cat /dev/ttyUSB0 > trace.bin
+    ./avrtos_trace_export.py trace.bin -o trace.json
+    ./avrtos_trace_export.py trace.bin --format vcd -o trace.vcd
+
+Frame layout (little-endian):
+    | sync 0xA7 (1) | kind (1) | payload | checksum (1) |
+    header ('H'): | version (1) | tick period us (2) | subticks per tick (1) |
+                  | lost events (2) |
+    event ('E'):  | type (1) | argument (1) | ticks (2) | subticks (1) |
+
+Timestamps keep only 16 bits of the tick counter, so gaps longer than 65536
+ticks (6.5 s with the default 100 us tick) between two events are folded.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_SYNC = 0xA7
+TRACE_VERSION = 1
+FRAME_SIZES = {ord("H"): 9, ord("E"): 8}
+
+TASK_SWITCH_IN = 0x00
+TASK_SWITCH_OUT = 0x01
+ISR_ENTER = 0x10
+ISR_EXIT = 0x11
+MUTEX_LOCK = 0x20
+MUTEX_BLOCK = 0x21
+MUTEX_UNLOCK = 0x22
+DELAY_START = 0x30
+DELAY_EXPIRE = 0x31
+MARKER = 0x40
+
+ISR_TID_OFFSET = 1000
+
+
+class Event:
+    def __init__(self, time_us, event_type, arg):
+        self.time_us = time_us
+        self.type = event_type
+        self.arg = arg
+
+
+def read_frames(data):
+    """Yields (kind, payload) of the frames with a valid checksum."""
+    offset = 0
+    while True:
+        offset = data.find(bytes([TRACE_SYNC]), offset)
+        if offset < 0 or offset + 2 > len(data):
+            return
+        size = FRAME_SIZES.get(data[offset + 1])
+        if size is None or offset + size > len(data):
+            offset += 1
+            continue
+        frame = data[offset:offset + size]
+        if sum(frame[1:-1]) & 0xFF != frame[-1]:
+            # Not a frame start, resynchronize on the next sync byte
+            offset += 1
+            continue
+        yield chr(frame[1]), frame[2:-1]
+        offset += size
+
+
+def read_events(data):
+    """Returns the events with unwrapped timestamps and the lost events as
+    (time in us, count) pairs."""
+    events = []
+    lost = []
+    tick_us = 100
+    subticks_per_tick = 1
+    ticks = None
+    last_raw_ticks = 0
+    for kind, payload in read_frames(data):
+        if kind == "H":
+            version, tick_us, subticks_per_tick, lost_count = struct.unpack(
+                "<BHBH", payload)
+            if version != TRACE_VERSION:
+                raise ValueError(f"unsupported trace version {version}")
+            subticks_per_tick = subticks_per_tick or 1
+            if lost_count:
+                time_us = events[-1].time_us if events else 0
+                lost.append((time_us, lost_count))
+            continue
+
+        event_type, arg, raw_ticks, subticks = struct.unpack("<BBHB", payload)
+        if ticks is None:
+            ticks = raw_ticks
+        else:
+            ticks += (raw_ticks - last_raw_ticks) & 0xFFFF
+        last_raw_ticks = raw_ticks
+        time_us = (ticks + subticks / subticks_per_tick) * tick_us
+        events.append(Event(time_us, event_type, arg))
+    return events, lost
+
+
+def task_name(task_id):
+    return f"task {task_id}"
+
+
+def write_perfetto(events, lost, out):
+    trace = []
+    tids = {}
+
+    def track(tid, name):
+        if tid not in tids:
+            tids[tid] = name
+            trace.append({"ph": "M", "name": "thread_name", "pid": 1,
+                          "tid": tid, "args": {"name": name}})
+        return tid
+
+    def add(ph, name, tid, time_us, **fields):
+        trace.append(dict(ph=ph, name=name, pid=1, tid=tid, ts=time_us,
+                          **fields))
+
+    current_task = 0
+    for event in events:
+        if event.type == TASK_SWITCH_IN:
+            current_task = event.arg
+            tid = track(event.arg, task_name(event.arg))
+            add("B", "running", tid, event.time_us)
+        elif event.type == TASK_SWITCH_OUT:
+            tid = track(event.arg, task_name(event.arg))
+            add("E", "running", tid, event.time_us)
+        elif event.type in (ISR_ENTER, ISR_EXIT):
+            tid = track(ISR_TID_OFFSET + event.arg, f"ISR {event.arg}")
+            add("B" if event.type == ISR_ENTER else "E",
+                f"vector {event.arg}", tid, event.time_us)
+        elif event.type in (MUTEX_LOCK, MUTEX_BLOCK, MUTEX_UNLOCK):
+            action = {MUTEX_LOCK: "lock", MUTEX_BLOCK: "block",
+                      MUTEX_UNLOCK: "unlock"}[event.type]
+            tid = track(current_task, task_name(current_task))
+            add("i", f"mutex 0x{event.arg:02x} {action}", tid, event.time_us,
+                s="t")
+        elif event.type in (DELAY_START, DELAY_EXPIRE):
+            action = "start" if event.type == DELAY_START else "expire"
+            tid = track(event.arg, task_name(event.arg))
+            add("i", f"delay {action}", tid, event.time_us, s="t")
+        elif event.type == MARKER:
+            add("i", f"marker {event.arg}", 0, event.time_us, s="g")
+        else:
+            add("i", f"unknown event 0x{event.type:02x}", 0, event.time_us,
+                s="g")
+    for time_us, count in lost:
+        add("i", f"{count} events lost", 0, time_us, s="g")
+
+    json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, out, indent=1)
+    out.write("\n")
+
+
+def vcd_identifier(index):
+    chars = [chr(33 + index % 94)]
+    index //= 94
+    while index:
+        chars.append(chr(33 + index % 94))
+        index //= 94
+    return "".join(chars)
+
+
+def write_vcd(events, lost, out):
+    signals = {}
+
+    def signal(name, width=1):
+        if name not in signals:
+            signals[name] = (vcd_identifier(len(signals)), width)
+        return signals[name][0]
+
+    signal("running_task", 8)
+    signal("marker", 8)
+    changes = []
+    current_task = 0
+    for event in events:
+        time_us = int(round(event.time_us))
+        if event.type == TASK_SWITCH_IN:
+            current_task = event.arg
+            changes.append((time_us, f"task_{event.arg}", 1))
+            changes.append((time_us, "running_task", event.arg))
+        elif event.type == TASK_SWITCH_OUT:
+            changes.append((time_us, f"task_{event.arg}", 0))
+        elif event.type in (ISR_ENTER, ISR_EXIT):
+            changes.append((time_us, f"isr_{event.arg}",
+                            int(event.type == ISR_ENTER)))
+        elif event.type in (MUTEX_LOCK, MUTEX_UNLOCK):
+            changes.append((time_us, f"mutex_{event.arg:02x}",
+                            int(event.type == MUTEX_LOCK)))
+        elif event.type in (DELAY_START, DELAY_EXPIRE):
+            changes.append((time_us, f"delay_{event.arg}",
+                            int(event.type == DELAY_START)))
+        elif event.type == MARKER:
+            changes.append((time_us, "marker", event.arg))
+    for _, name, _ in changes:
+        signal(name)
+
+    out.write("$timescale 1 us $end\n$scope module avrtos $end\n")
+    for name, (identifier, width) in sorted(signals.items()):
+        kind = "wire" if width == 1 else "reg"
+        out.write(f"$var {kind} {width} {identifier} {name} $end\n")
+    out.write("$upscope $end\n$enddefinitions $end\n")
+    for time_us, count in lost:
+        out.write(f"$comment {count} events lost at {time_us:.0f} us "
+                  f"$end\n")
+
+    last_time = None
+    for time_us, name, value in changes:
+        if time_us != last_time:
+            out.write(f"#{time_us}\n")
+            last_time = time_us
+        identifier, width = signals[name]
+        if width == 1:
+            out.write(f"{value}{identifier}\n")
+        else:
+            out.write(f"b{value:b} {identifier}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert AVRTOS kernel event traces.")
+    parser.add_argument("input", nargs="?", default="-",
+                        help="raw UART stream with avrtos_trace_dump() "
+                             "output (default: stdin)")
+    parser.add_argument("--format", choices=("perfetto", "vcd"),
+                        default="perfetto")
+    parser.add_argument("-o", "--output", default="-",
+                        help="output file (default: stdout)")
+    args = parser.parse_args()
+
+    if args.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, "rb") as stream:
+            data = stream.read()
+    events, lost = read_events(data)
+    if not events:
+        print("no trace events found", file=sys.stderr)
+
+    write = write_vcd if args.format == "vcd" else write_perfetto
+    if args.output == "-":
+        write(events, lost, sys.stdout)
+    else:
+        with open(args.output, "w") as out:
+            write(events, lost, out)
+
+
+if __name__ == "__main__":
+    main()